@@ -1,5 +1,7 @@
 #include "JsonImportPrivatePCH.h"
 #include "AnimationBuilder.h"
+#include "ImportProfiler.h"
+#include "JsonObjects/JsonSkeleton.h"
 #include "Runtime/Engine/Classes/Animation/AnimSequence.h"
 #include "Runtime/Engine/Classes/Animation/Skeleton.h"
 
@@ -13,8 +15,9 @@ void addRawTrackBoneKey(FRawAnimSequenceTrack &outTrack, const JsonTransformKey
 	outTrack.RotKeys.Add(transform.GetRotation());
 }
 
-void AnimationBuilder::buildAnimation(UAnimSequence *animSeq, USkeleton *skel, const JsonAnimationClip &srcClip){
+void AnimationBuilder::buildAnimation(UAnimSequence *animSeq, USkeleton *skel, const JsonAnimationClip &srcClip, const JsonSkeleton *jsonSkel){
 	check(animSeq);
+	IMPORT_PROFILE_SCOPE_ASSET("AnimationBuilder::buildAnimation", srcClip.name);
 	animSeq->CleanAnimSequenceForImport();
 	if (!skel){
 		skel = animSeq->GetSkeleton();
@@ -42,6 +45,11 @@ void AnimationBuilder::buildAnimation(UAnimSequence *animSeq, USkeleton *skel, c
 	for(const auto &matCurve: srcClip.matrixCurves){
 		if (matCurve.keys.Num() <= 0)
 			continue;
+		if (jsonSkel && (jsonSkel->findBoneIndex(matCurve.objectName) < 0)){
+			UE_LOG(JsonLog, Log, TEXT("Clip %s: \"%s\" is not a bone of skeleton %s, curve skipped"), 
+				*srcClip.name, *matCurve.objectName, *jsonSkel->name);
+			continue;
+		}
 
 		FRawAnimSequenceTrack rawAnimTrack;
 
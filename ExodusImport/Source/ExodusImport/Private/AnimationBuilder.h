@@ -2,7 +2,10 @@
 #include "CoreMinimal.h"
 #include "JsonObjects.h"
 
+class JsonSkeleton;
+
 class AnimationBuilder{
 public:
-	void buildAnimation(UAnimSequence *animSequence, USkeleton *skeleton, const JsonAnimationClip &srcClip);
+	//When jsonSkeleton is given, curves of objects that are not its bones are skipped.
+	void buildAnimation(UAnimSequence *animSequence, USkeleton *skeleton, const JsonAnimationClip &srcClip, const JsonSkeleton *jsonSkeleton = nullptr);
 };
@@ -0,0 +1,934 @@
+#include "JsonImportPrivatePCH.h"
+#include "SyntheticProjectGenerator.h"
+#include "JsonLog.h"
+#include "Misc/FileHelper.h"
+#include "HAL/FileManager.h"
+
+FString SyntheticProjectSettings::toString() const{
+	return FString::Printf(
+		TEXT("meshes: %d x %d verts (%d skinned%s), materials: %d, textures: %d (%dpx), skeletons: %d x %d bones, clips: %d x %d frames, heightmap: %d, seed: %d"),
+		numMeshes, vertsPerMesh, numSkinnedMeshes, binaryMeshes ? TEXT(", binary"): TEXT(""), numMaterials, numTextures, textureSize,
+		numSkeletons, bonesPerSkeleton, numAnimClips, framesPerClip, heightmapSize, seed);
+}
+
+SyntheticProjectGenerator::SyntheticProjectGenerator(const SyntheticProjectSettings &settings_)
+:settings(settings_), random(settings_.seed){
+	settings.numSkinnedMeshes = (settings.numSkeletons > 0) ? FMath::Clamp(settings.numSkinnedMeshes, 0, settings.numMeshes): 0;
+	settings.bonesPerSkeleton = FMath::Max(settings.bonesPerSkeleton, 1);
+	settings.framesPerClip = FMath::Max(settings.framesPerClip, 1);
+	settings.textureSize = FMath::Max(settings.textureSize, 1);
+	settings.numSplatLayers = FMath::Max(settings.numSplatLayers, 1);
+}
+
+FString SyntheticProjectGenerator::getAssetPath(const FString &folder, const FString &fileName) const{
+	return FString::Printf(TEXT("Assets/%s/%s/%s"), *settings.name, *folder, *fileName);
+}
+
+bool SyntheticProjectGenerator::saveJson(const FString &relPath, const FString &content) const{
+	auto filename = FPaths::Combine(dataDir, relPath);
+	if (!FFileHelper::SaveStringToFile(content, *filename, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM)){
+		UE_LOG(JsonLog, Error, TEXT("Could not write \"%s\""), *filename);
+		return false;
+	}
+	return true;
+}
+
+bool SyntheticProjectGenerator::saveBinaryMesh(const FString &relPath, const TArray<BinaryMeshBlock> &blocks) const{
+	//Layout is described in JsonBinaryMesh.h
+	const int64 headerSize = 16;
+	const int64 blockEntrySize = 24;
+	int64 totalSize = headerSize + blockEntrySize * blocks.Num();
+	for(const auto &cur: blocks)
+		totalSize += cur.size;
+
+	TArray<uint8> fileData;
+	fileData.Reserve(totalSize);
+	auto append = [&](const void *src, int64 size){
+		fileData.Append((const uint8*)src, (int32)size);
+	};
+	auto appendUint32 = [&](uint32 value){
+		append(&value, sizeof(value));
+	};
+	auto appendUint64 = [&](uint64 value){
+		append(&value, sizeof(value));
+	};
+
+	append("EXMS", 4);
+	appendUint32(JsonBinaryMesh::currentVersion);
+	appendUint32(blocks.Num());
+	appendUint32(0);
+
+	uint64 offset = headerSize + blockEntrySize * blocks.Num();
+	for(const auto &cur: blocks){
+		appendUint32((uint32)cur.type);
+		appendUint32(cur.index);
+		appendUint64(offset);
+		appendUint64(cur.size);
+		offset += cur.size;
+	}
+	for(const auto &cur: blocks)
+		append(cur.data, cur.size);
+	check(fileData.Num() == totalSize);
+
+	auto filename = FPaths::Combine(dataDir, relPath);
+	if (!FFileHelper::SaveArrayToFile(fileData, *filename)){
+		UE_LOG(JsonLog, Error, TEXT("Could not write \"%s\""), *filename);
+		return false;
+	}
+	return true;
+}
+
+FString SyntheticProjectGenerator::getBoneName(int32 boneIndex) const{
+	return FString::Printf(TEXT("bone_%d"), boneIndex);
+}
+
+FMatrix SyntheticProjectGenerator::getBoneLocalMatrix(int32 boneIndex) const{
+	//Bones form a vertical chain, 0.1 unity units apart.
+	if (boneIndex == 0)
+		return FMatrix::Identity;
+	return FTranslationMatrix(FVector(0.0f, 0.1f, 0.0f));
+}
+
+FMatrix SyntheticProjectGenerator::getBoneWorldMatrix(int32 boneIndex) const{
+	return FTranslationMatrix(FVector(0.0f, 0.1f * boneIndex, 0.0f));
+}
+
+void SyntheticProjectGenerator::writeVector(JsonStringWriterRef writer, const FString &name, const FVector &value){
+	writer->WriteObjectStart(name);
+	writer->WriteValue(TEXT("X"), value.X);
+	writer->WriteValue(TEXT("Y"), value.Y);
+	writer->WriteValue(TEXT("Z"), value.Z);
+	writer->WriteObjectEnd();
+}
+
+void SyntheticProjectGenerator::writeVector2(JsonStringWriterRef writer, const FString &name, const FVector2D &value){
+	writer->WriteObjectStart(name);
+	writer->WriteValue(TEXT("X"), value.X);
+	writer->WriteValue(TEXT("Y"), value.Y);
+	writer->WriteObjectEnd();
+}
+
+void SyntheticProjectGenerator::writeVector4(JsonStringWriterRef writer, const FString &name, const FVector4 &value){
+	writer->WriteObjectStart(name);
+	writer->WriteValue(TEXT("X"), value.X);
+	writer->WriteValue(TEXT("Y"), value.Y);
+	writer->WriteValue(TEXT("Z"), value.Z);
+	writer->WriteValue(TEXT("W"), value.W);
+	writer->WriteObjectEnd();
+}
+
+void SyntheticProjectGenerator::writeQuat(JsonStringWriterRef writer, const FString &name, const FQuat &value){
+	writeVector4(writer, name, FVector4(value.X, value.Y, value.Z, value.W));
+}
+
+void SyntheticProjectGenerator::writeColor(JsonStringWriterRef writer, const FString &name, const FLinearColor &value){
+	writer->WriteObjectStart(name);
+	writer->WriteValue(TEXT("r"), value.R);
+	writer->WriteValue(TEXT("g"), value.G);
+	writer->WriteValue(TEXT("b"), value.B);
+	writer->WriteValue(TEXT("a"), value.A);
+	writer->WriteObjectEnd();
+}
+
+void SyntheticProjectGenerator::writeMatrix(JsonStringWriterRef writer, const FMatrix &value){
+	//Inverse of JsonObjects::toMatrix: unity eRC is stored in M[C][R]
+	for(int row = 0; row < 4; row++){
+		for(int col = 0; col < 4; col++){
+			writer->WriteValue(FString::Printf(TEXT("e%d%d"), row, col), value.M[col][row]);
+		}
+	}
+}
+
+void SyntheticProjectGenerator::writeMatrix(JsonStringWriterRef writer, const FString &name, const FMatrix &value){
+	writer->WriteObjectStart(name);
+	writeMatrix(writer, value);
+	writer->WriteObjectEnd();
+}
+
+void SyntheticProjectGenerator::writeBounds(JsonStringWriterRef writer, const FString &name, const FVector &center, const FVector &size){
+	writer->WriteObjectStart(name);
+	writeVector(writer, TEXT("center"), center);
+	writeVector(writer, TEXT("size"), size);
+	writer->WriteObjectEnd();
+}
+
+void SyntheticProjectGenerator::writeFloatArray(JsonStringWriterRef writer, const FString &name, const FloatArray &values){
+	writer->WriteArrayStart(name);
+	for(auto cur: values)
+		writer->WriteValue(cur);
+	writer->WriteArrayEnd();
+}
+
+void SyntheticProjectGenerator::writeIntArray(JsonStringWriterRef writer, const FString &name, const IntArray &values){
+	writer->WriteArrayStart(name);
+	for(auto cur: values)
+		writer->WriteValue(cur);
+	writer->WriteArrayEnd();
+}
+
+void SyntheticProjectGenerator::writeStringArray(JsonStringWriterRef writer, const FString &name, const StringArray &values){
+	writer->WriteArrayStart(name);
+	for(const auto &cur: values)
+		writer->WriteValue(cur);
+	writer->WriteArrayEnd();
+}
+
+bool SyntheticProjectGenerator::writeTextureImage(const FString &filename, int32 texIndex){
+	//Uncompressed 32 bit TGA
+	const int32 size = settings.textureSize;
+	TArray<uint8> data;
+	data.SetNumZeroed(18 + size * size * 4);
+	data[2] = 2;
+	data[12] = size & 0xFF;
+	data[13] = (size >> 8) & 0xFF;
+	data[14] = size & 0xFF;
+	data[15] = (size >> 8) & 0xFF;
+	data[16] = 32;
+	data[17] = 8;
+
+	const FColor baseColor = FLinearColor::MakeFromHSV8((uint8)(texIndex * 37), 192, 255).ToFColor(true);
+	const int32 cellSize = FMath::Max(size / 8, 1);
+	uint8 *pixels = data.GetData() + 18;
+	for(int32 y = 0; y < size; y++){
+		for(int32 x = 0; x < size; x++){
+			const bool dark = (((x / cellSize) + (y / cellSize)) & 1) != 0;
+			const uint8 noise = (uint8)random.RandRange(0, 31);
+			auto *dst = pixels + (y * size + x) * 4;
+			dst[0] = dark ? baseColor.B / 2: baseColor.B - noise / 2;
+			dst[1] = dark ? baseColor.G / 2: baseColor.G - noise / 2;
+			dst[2] = dark ? baseColor.R / 2: baseColor.R - noise / 2;
+			dst[3] = 0xFF;
+		}
+	}
+
+	if (!FFileHelper::SaveArrayToFile(data, *filename)){
+		UE_LOG(JsonLog, Error, TEXT("Could not write \"%s\""), *filename);
+		return false;
+	}
+	return true;
+}
+
+bool SyntheticProjectGenerator::generateTextures(){
+	for(int32 texIndex = 0; texIndex < settings.numTextures; texIndex++){
+		auto texName = FString::Printf(TEXT("tex_%d"), texIndex);
+		auto assetPath = getAssetPath(TEXT("Textures"), texName + TEXT(".tga"));
+		if (!writeTextureImage(FPaths::Combine(dataDir, assetPath), texIndex))
+			return false;
+
+		FString outString;
+		auto writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&outString);
+		writer->WriteObjectStart();
+		writer->WriteValue(TEXT("name"), texName);
+		writer->WriteValue(TEXT("id"), texIndex);
+		writer->WriteValue(TEXT("path"), assetPath);
+		writer->WriteValue(TEXT("filterMode"), TEXT("Bilinear"));
+		writer->WriteValue(TEXT("mipMapBias"), 0.0f);
+		writer->WriteValue(TEXT("width"), settings.textureSize);
+		writer->WriteValue(TEXT("height"), settings.textureSize);
+		writer->WriteValue(TEXT("wrapMode"), TEXT("Repeat"));
+		writer->WriteValue(TEXT("isTex2D"), true);
+		writer->WriteValue(TEXT("isRenderTarget"), false);
+		writer->WriteValue(TEXT("alphaTransparency"), false);
+		writer->WriteValue(TEXT("anisoLevel"), 1.0f);
+		writer->WriteValue(TEXT("importDataFound"), false);
+		writer->WriteValue(TEXT("sRGB"), true);
+		writer->WriteValue(TEXT("textureType"), TEXT("Default"));
+		writer->WriteValue(TEXT("normalMapFlag"), false);
+		writer->WriteObjectEnd();
+		writer->Close();
+
+		auto relPath = FString::Printf(TEXT("textures/%s.json"), *texName);
+		if (!saveJson(relPath, outString))
+			return false;
+		textures.Add(relPath);
+		resources.Add(assetPath);
+	}
+	return true;
+}
+
+bool SyntheticProjectGenerator::generateMaterials(){
+	for(int32 matIndex = 0; matIndex < settings.numMaterials; matIndex++){
+		auto matName = FString::Printf(TEXT("mat_%d"), matIndex);
+		auto assetPath = getAssetPath(TEXT("Materials"), matName + TEXT(".mat"));
+		const int32 albedoTex = (settings.numTextures > 0) ? matIndex % settings.numTextures: -1;
+
+		FString outString;
+		auto writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&outString);
+		writer->WriteObjectStart();
+		writer->WriteValue(TEXT("id"), matIndex);
+		writer->WriteValue(TEXT("renderQueue"), 2000);
+		writer->WriteValue(TEXT("name"), matName);
+		writer->WriteValue(TEXT("path"), assetPath);
+		writer->WriteValue(TEXT("shader"), TEXT("Standard"));
+		writer->WriteValue(TEXT("blendMode"), 0);
+		writer->WriteValue(TEXT("supportedShader"), true);
+
+		writer->WriteValue(TEXT("mainTexture"), albedoTex);
+		writeVector2(writer, TEXT("mainTextureOffset"), FVector2D(0.0f, 0.0f));
+		writeVector2(writer, TEXT("mainTextureScale"), FVector2D(1.0f, 1.0f));
+		writeColor(writer, TEXT("color"), FLinearColor::White);
+
+		const TCHAR* falseFlags[] = {
+			TEXT("useNormalMap"), TEXT("useAlphaTest"), TEXT("useAlphaBlend"), TEXT("useAlphaPremultiply"),
+			TEXT("useEmission"), TEXT("useParallax"), TEXT("useDetailMap"), TEXT("useMetallic"),
+			TEXT("hasMetallic"), TEXT("hasSpecular"), TEXT("hasEmissionColor"), TEXT("hasEmission"), TEXT("useSpecular")
+		};
+		for(auto flagName: falseFlags)
+			writer->WriteValue(flagName, false);
+
+		writer->WriteValue(TEXT("albedoTex"), albedoTex);
+		const TCHAR* unusedTextures[] = {
+			TEXT("specularTex"), TEXT("metallicTex"), TEXT("normalMapTex"), TEXT("occlusionTex"), TEXT("parallaxTex"),
+			TEXT("emissionTex"), TEXT("detailMaskTex"), TEXT("detailAlbedoTex"), TEXT("detailNormalMapTex")
+		};
+		for(auto texName: unusedTextures)
+			writer->WriteValue(texName, -1);
+		writeVector2(writer, TEXT("detailAlbedoOffset"), FVector2D(0.0f, 0.0f));
+		writeVector2(writer, TEXT("detailAlbedoScale"), FVector2D(1.0f, 1.0f));
+		writer->WriteValue(TEXT("detailNormalMapScale"), 1.0f);
+
+		writer->WriteValue(TEXT("alphaCutoff"), 0.5f);
+		writer->WriteValue(TEXT("smoothness"), 0.5f);
+		writer->WriteValue(TEXT("smoothnessScale"), 1.0f);
+		writeColor(writer, TEXT("specularColor"), FLinearColor(0.2f, 0.2f, 0.2f, 1.0f));
+		writer->WriteValue(TEXT("metallic"), 0.0f);
+		writer->WriteValue(TEXT("bumpScale"), 1.0f);
+		writer->WriteValue(TEXT("parallaxScale"), 0.02f);
+		writer->WriteValue(TEXT("occlusionStrength"), 1.0f);
+		writeColor(writer, TEXT("emissionColor"), FLinearColor::Black);
+		writer->WriteValue(TEXT("detailMapScale"), 1.0f);
+		writer->WriteValue(TEXT("secondaryUv"), 0.0f);
+		writer->WriteValue(TEXT("smoothnessMapChannel"), 0);
+		writer->WriteValue(TEXT("specularHighlights"), 1.0f);
+		writer->WriteValue(TEXT("glossyReflections"), 1.0f);
+		writer->WriteObjectEnd();
+		writer->Close();
+
+		auto relPath = FString::Printf(TEXT("materials/%s.json"), *matName);
+		if (!saveJson(relPath, outString))
+			return false;
+		materials.Add(relPath);
+		resources.Add(assetPath);
+	}
+	return true;
+}
+
+bool SyntheticProjectGenerator::generateSkeletons(){
+	for(int32 skelIndex = 0; skelIndex < settings.numSkeletons; skelIndex++){
+		auto skelName = FString::Printf(TEXT("skeleton_%d"), skelIndex);
+
+		FString outString;
+		auto writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&outString);
+		writer->WriteObjectStart();
+		writer->WriteValue(TEXT("id"), skelIndex);
+		writer->WriteValue(TEXT("name"), skelName);
+		writer->WriteArrayStart(TEXT("bones"));
+		for(int32 boneIndex = 0; boneIndex < settings.bonesPerSkeleton; boneIndex++){
+			writer->WriteObjectStart();
+			writer->WriteValue(TEXT("name"), getBoneName(boneIndex));
+			writer->WriteValue(TEXT("id"), boneIndex);
+			writer->WriteValue(TEXT("parentId"), boneIndex - 1);
+			writeMatrix(writer, TEXT("world"), getBoneWorldMatrix(boneIndex));
+			writeMatrix(writer, TEXT("local"), getBoneLocalMatrix(boneIndex));
+			writeMatrix(writer, TEXT("rootRelative"), getBoneWorldMatrix(boneIndex));
+			writer->WriteObjectEnd();
+		}
+		writer->WriteArrayEnd();
+		writer->WriteObjectEnd();
+		writer->Close();
+
+		auto relPath = FString::Printf(TEXT("skeletons/%s.json"), *skelName);
+		if (!saveJson(relPath, outString))
+			return false;
+		skeletons.Add(relPath);
+	}
+	return true;
+}
+
+bool SyntheticProjectGenerator::generateMeshes(){
+	const int32 gridSize = FMath::Max(2, FMath::CeilToInt(FMath::Sqrt((float)FMath::Max(settings.vertsPerMesh, 4))));
+	const int32 numVerts = gridSize * gridSize;
+
+	StringArray boneNames;
+	MatrixArray bindPoses, inverseBindPoses;
+	for(int32 boneIndex = 0; boneIndex < settings.bonesPerSkeleton; boneIndex++){
+		boneNames.Add(getBoneName(boneIndex));
+		inverseBindPoses.Add(getBoneWorldMatrix(boneIndex));
+		bindPoses.Add(getBoneWorldMatrix(boneIndex).Inverse());
+	}
+
+	for(int32 meshIndex = 0; meshIndex < settings.numMeshes; meshIndex++){
+		auto meshName = FString::Printf(TEXT("mesh_%d"), meshIndex);
+		auto assetPath = getAssetPath(TEXT("Meshes"), meshName + TEXT(".asset"));
+		const bool skinned = meshIndex < settings.numSkinnedMeshes;
+		const float meshSize = 1.0f + (meshIndex % 7);
+		const float phase = random.FRandRange(0.0f, PI * 2.0f);
+
+		FloatArray verts, normals, tangents, uv0, boneWeights;
+		IntArray boneIndexes, triangles;
+		verts.Reserve(numVerts * 3);
+		normals.Reserve(numVerts * 3);
+		tangents.Reserve(numVerts * 4);
+		uv0.Reserve(numVerts * 2);
+		for(int32 z = 0; z < gridSize; z++){
+			for(int32 x = 0; x < gridSize; x++){
+				const float u = (float)x / (gridSize - 1);
+				const float v = (float)z / (gridSize - 1);
+				verts.Append({(u - 0.5f) * meshSize, 0.05f * meshSize * FMath::Sin(u * 6.0f + phase), (v - 0.5f) * meshSize});
+				normals.Append({0.0f, 1.0f, 0.0f});
+				tangents.Append({1.0f, 0.0f, 0.0f, 1.0f});
+				uv0.Append({u, v});
+
+				if (skinned){
+					const float bonePos = v * (settings.bonesPerSkeleton - 1);
+					const int32 bone0 = FMath::Min(FMath::FloorToInt(bonePos), settings.bonesPerSkeleton - 1);
+					const int32 bone1 = FMath::Min(bone0 + 1, settings.bonesPerSkeleton - 1);
+					const float weight1 = (bone1 != bone0) ? bonePos - bone0: 0.0f;
+					boneIndexes.Append({bone0, bone1, 0, 0});
+					boneWeights.Append({1.0f - weight1, weight1, 0.0f, 0.0f});
+				}
+			}
+		}
+
+		triangles.Reserve((gridSize - 1) * (gridSize - 1) * 6);
+		for(int32 z = 0; z + 1 < gridSize; z++){
+			for(int32 x = 0; x + 1 < gridSize; x++){
+				const int32 a = z * gridSize + x;
+				const int32 b = a + 1;
+				const int32 c = a + gridSize;
+				const int32 d = c + 1;
+				//unity winding (clockwise when viewed from the normal side)
+				triangles.Append({a, c, d, a, d, b});
+			}
+		}
+
+		FString outString;
+		auto writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&outString);
+		writer->WriteObjectStart();
+		writer->WriteValue(TEXT("id"), meshIndex);
+		writer->WriteValue(TEXT("name"), meshName);
+		writer->WriteValue(TEXT("uniqueName"), meshName);
+		writer->WriteValue(TEXT("convexCollider"), false);
+		writer->WriteValue(TEXT("triangleCollider"), false);
+		writer->WriteValue(TEXT("path"), assetPath);
+		IntArray meshMaterials;
+		if (settings.numMaterials > 0)
+			meshMaterials.Add(meshIndex % settings.numMaterials);
+		writeIntArray(writer, TEXT("materials"), meshMaterials);
+		writer->WriteValue(TEXT("readable"), true);
+		writer->WriteValue(TEXT("vertexCount"), numVerts);
+		writer->WriteValue(TEXT("subMeshCount"), 1);
+		writer->WriteValue(TEXT("blendShapeCount"), 0);
+		writer->WriteValue(TEXT("defaultSkeletonId"), skinned ? meshIndex % settings.numSkeletons: -1);
+		writeStringArray(writer, TEXT("defaultBoneNames"), skinned ? boneNames: StringArray());
+		writer->WriteValue(TEXT("defaultMeshNodeName"), skinned ? meshName: FString());
+		writeMatrix(writer, TEXT("defaultMeshNodeMatrix"), FMatrix::Identity);
+
+		const bool binary = settings.binaryMeshes;
+		if (!binary){
+			writer->WriteArrayStart(TEXT("bindPoses"));
+			if (skinned){
+				for(const auto &cur: bindPoses){
+					writer->WriteObjectStart();
+					writeMatrix(writer, cur);
+					writer->WriteObjectEnd();
+				}
+			}
+			writer->WriteArrayEnd();
+			writer->WriteArrayStart(TEXT("inverseBindPoses"));
+			if (skinned){
+				for(const auto &cur: inverseBindPoses){
+					writer->WriteObjectStart();
+					writeMatrix(writer, cur);
+					writer->WriteObjectEnd();
+				}
+			}
+			writer->WriteArrayEnd();
+
+			writeFloatArray(writer, TEXT("verts"), verts);
+			writeFloatArray(writer, TEXT("normals"), normals);
+			writeFloatArray(writer, TEXT("tangents"), tangents);
+			writeFloatArray(writer, TEXT("uv0"), uv0);
+			writeFloatArray(writer, TEXT("boneWeights"), boneWeights);
+			writeIntArray(writer, TEXT("boneIndexes"), boneIndexes);
+		}
+		writer->WriteArrayStart(TEXT("blendShapes"));
+		writer->WriteArrayEnd();
+		writer->WriteArrayStart(TEXT("subMeshes"));
+		writer->WriteObjectStart();
+		if (!binary)
+			writeIntArray(writer, TEXT("triangles"), triangles);
+		writer->WriteObjectEnd();
+		writer->WriteArrayEnd();
+		writer->WriteObjectEnd();
+		writer->Close();
+
+		if (binary){
+			using BlockType = JsonBinaryMesh::BlockType;
+			//Matrix blocks use unity element order, see JsonBinaryMesh.h
+			FloatArray bindPoseFloats, inverseBindPoseFloats;
+			if (skinned){
+				for(int32 boneIndex = 0; boneIndex < bindPoses.Num(); boneIndex++){
+					for(int i = 0; i < 16; i++){
+						bindPoseFloats.Add((float)bindPoses[boneIndex].M[i / 4][i % 4]);
+						inverseBindPoseFloats.Add((float)inverseBindPoses[boneIndex].M[i / 4][i % 4]);
+					}
+				}
+			}
+
+			TArray<BinaryMeshBlock> blocks;
+			auto addBlock = [&](BlockType type, uint32 index, const auto &values){
+				if (values.Num() > 0)
+					blocks.Add({type, index, values.GetData(), (int64)values.Num() * (int64)values.GetTypeSize()});
+			};
+			addBlock(BlockType::Positions, 0, verts);
+			addBlock(BlockType::Normals, 0, normals);
+			addBlock(BlockType::Tangents, 0, tangents);
+			addBlock(BlockType::TexCoords, 0, uv0);
+			addBlock(BlockType::BoneIndexes, 0, boneIndexes);
+			addBlock(BlockType::BoneWeights, 0, boneWeights);
+			addBlock(BlockType::BindPoses, 0, bindPoseFloats);
+			addBlock(BlockType::InverseBindPoses, 0, inverseBindPoseFloats);
+			addBlock(BlockType::SubMeshTriangles, 0, triangles);
+
+			if (!saveBinaryMesh(FString::Printf(TEXT("meshes/%s.exmesh"), *meshName), blocks))
+				return false;
+		}
+
+		auto relPath = FString::Printf(TEXT("meshes/%s.json"), *meshName);
+		if (!saveJson(relPath, outString))
+			return false;
+		meshes.Add(relPath);
+		resources.Add(assetPath);
+	}
+	return true;
+}
+
+bool SyntheticProjectGenerator::generateAnimations(){
+	if ((settings.numSkeletons <= 0) || (settings.numAnimClips <= 0))
+		return true;
+
+	const float frameRate = 30.0f;
+	IntArray clipIds;
+	for(int32 clipIndex = 0; clipIndex < settings.numAnimClips; clipIndex++){
+		auto clipName = FString::Printf(TEXT("clip_%d"), clipIndex);
+		auto assetPath = getAssetPath(TEXT("Animation"), clipName + TEXT(".anim"));
+		const float length = (settings.framesPerClip - 1) / frameRate;
+
+		FString outString;
+		auto writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&outString);
+		writer->WriteObjectStart();
+		writer->WriteValue(TEXT("name"), clipName);
+		writer->WriteValue(TEXT("id"), clipIndex);
+		writer->WriteValue(TEXT("frameRate"), frameRate);
+		writer->WriteValue(TEXT("empty"), false);
+		writer->WriteValue(TEXT("isLooping"), true);
+		writer->WriteValue(TEXT("legacy"), false);
+		writer->WriteValue(TEXT("length"), length);
+		writeBounds(writer, TEXT("localBounds"), FVector::ZeroVector, FVector(1.0f, 0.1f * settings.bonesPerSkeleton, 1.0f));
+		writer->WriteValue(TEXT("wrapMode"), TEXT("Loop"));
+		writer->WriteArrayStart(TEXT("animEvents"));
+		writer->WriteArrayEnd();
+		writer->WriteArrayStart(TEXT("objBindings"));
+		writer->WriteArrayEnd();
+		writer->WriteArrayStart(TEXT("floatBindings"));
+		writer->WriteArrayEnd();
+
+		writer->WriteArrayStart(TEXT("matrixCurves"));
+		FString bonePath;
+		for(int32 boneIndex = 0; boneIndex < settings.bonesPerSkeleton; boneIndex++){
+			const auto boneName = getBoneName(boneIndex);
+			bonePath = bonePath.IsEmpty() ? boneName: bonePath + TEXT("/") + boneName;
+			writer->WriteObjectStart();
+			writer->WriteValue(TEXT("objectName"), boneName);
+			writer->WriteValue(TEXT("objectPath"), bonePath);
+			writer->WriteArrayStart(TEXT("keys"));
+			for(int32 frame = 0; frame < settings.framesPerClip; frame++){
+				const float angle = 0.2f * FMath::Sin(frame * 2.0f * PI / settings.framesPerClip + clipIndex + boneIndex * 0.3f);
+				const FMatrix local = FRotationMatrix(FRotator(0.0f, 0.0f, FMath::RadiansToDegrees(angle))) * getBoneLocalMatrix(boneIndex);
+				const FMatrix world = local * getBoneWorldMatrix(FMath::Max(boneIndex - 1, 0));
+				writer->WriteObjectStart();
+				writer->WriteValue(TEXT("time"), frame / frameRate);
+				writer->WriteValue(TEXT("frame"), frame);
+				for(int transformIndex = 0; transformIndex < 2; transformIndex++){
+					const auto &matrix = transformIndex ? world: local;
+					writer->WriteObjectStart(transformIndex ? TEXT("world"): TEXT("local"));
+					writeVector(writer, TEXT("x"), matrix.GetUnitAxis(EAxis::X));
+					writeVector(writer, TEXT("y"), matrix.GetUnitAxis(EAxis::Y));
+					writeVector(writer, TEXT("z"), matrix.GetUnitAxis(EAxis::Z));
+					writeVector(writer, TEXT("pos"), matrix.GetOrigin());
+					writer->WriteObjectEnd();
+				}
+				writer->WriteObjectEnd();
+			}
+			writer->WriteArrayEnd();
+			writer->WriteObjectEnd();
+		}
+		writer->WriteArrayEnd();
+		writer->WriteObjectEnd();
+		writer->Close();
+
+		auto relPath = FString::Printf(TEXT("animation/%s.json"), *clipName);
+		if (!saveJson(relPath, outString))
+			return false;
+		animationClips.Add(relPath);
+		resources.Add(assetPath);
+		clipIds.Add(clipIndex);
+	}
+
+	auto controllerName = TEXT("controller_0");
+	auto controllerAssetPath = getAssetPath(TEXT("Animation"), FString(controllerName) + TEXT(".controller"));
+	FString outString;
+	auto writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&outString);
+	writer->WriteObjectStart();
+	writer->WriteValue(TEXT("name"), controllerName);
+	writer->WriteValue(TEXT("path"), controllerAssetPath);
+	writer->WriteValue(TEXT("id"), 0);
+	writer->WriteArrayStart(TEXT("parameters"));
+	writer->WriteArrayEnd();
+	writeIntArray(writer, TEXT("animationIds"), clipIds);
+	writer->WriteObjectEnd();
+	writer->Close();
+
+	auto relPath = FString::Printf(TEXT("animation/%s.json"), controllerName);
+	if (!saveJson(relPath, outString))
+		return false;
+	animatorControllers.Add(relPath);
+	resources.Add(controllerAssetPath);
+	return true;
+}
+
+bool SyntheticProjectGenerator::generateTerrains(){
+	if (settings.heightmapSize <= 0)
+		return true;
+
+	const int32 hSize = FMath::Max(settings.heightmapSize, 2);
+	const int32 alphaSize = FMath::Max(hSize - 1, 1);
+	const int32 numLayers = settings.numSplatLayers;
+	const FVector worldSize(hSize, 50.0f, hSize);
+
+	auto terrainName = TEXT("terrain_0");
+	auto assetPath = getAssetPath(TEXT("Terrain"), FString(terrainName) + TEXT(".asset"));
+	auto binaryRelPath = FString::Printf(TEXT("terrain/%s.bin"), terrainName);
+
+	//Same layout JsonBinaryTerrain::load reads: 8 int32 sizes, then heights, alpha maps and detail maps as floats.
+	{
+		TArray<uint8> data;
+		const int64 numFloats = (int64)hSize * hSize + (int64)alphaSize * alphaSize * numLayers;
+		data.SetNumZeroed(sizeof(int32) * 8 + numFloats * sizeof(float));
+		int32 *header = (int32*)data.GetData();
+		header[0] = hSize;
+		header[1] = hSize;
+		header[2] = alphaSize;
+		header[3] = alphaSize;
+		header[4] = numLayers;
+		header[5] = 0;
+		header[6] = 0;
+		header[7] = 0;
+
+		float *heights = (float*)(header + 8);
+		for(int32 y = 0; y < hSize; y++){
+			for(int32 x = 0; x < hSize; x++){
+				const float fx = (float)x / hSize, fy = (float)y / hSize;
+				heights[y * hSize + x] = 0.5f + 0.25f * FMath::Sin(fx * 12.0f) * FMath::Cos(fy * 9.0f) + random.FRandRange(0.0f, 0.01f);
+			}
+		}
+		float *alphas = heights + hSize * hSize;
+		const float alphaValue = 1.0f / numLayers;
+		for(int64 i = 0; i < (int64)alphaSize * alphaSize * numLayers; i++)
+			alphas[i] = alphaValue;
+
+		auto binaryPath = FPaths::Combine(dataDir, binaryRelPath);
+		if (!FFileHelper::SaveArrayToFile(data, *binaryPath)){
+			UE_LOG(JsonLog, Error, TEXT("Could not write \"%s\""), *binaryPath);
+			return false;
+		}
+	}
+
+	FString outString;
+	auto writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&outString);
+	writer->WriteObjectStart();
+	writer->WriteValue(TEXT("name"), terrainName);
+	writer->WriteValue(TEXT("path"), assetPath);
+	writer->WriteValue(TEXT("exportPath"), binaryRelPath);
+	writer->WriteValue(TEXT("alphaMapWidth"), alphaSize);
+	writer->WriteValue(TEXT("alphaMapHeight"), alphaSize);
+	writer->WriteValue(TEXT("alphaMapLayers"), numLayers);
+	writer->WriteValue(TEXT("alphaMapResolution"), alphaSize);
+	writer->WriteValue(TEXT("baseMapResolution"), 1024);
+	writeBounds(writer, TEXT("bounds"), worldSize * 0.5f, worldSize);
+	writer->WriteValue(TEXT("detailWidth"), 0);
+	writer->WriteValue(TEXT("detailHeight"), 0);
+	writer->WriteValue(TEXT("heightMapRawPath"), FString());
+	writeStringArray(writer, TEXT("alphaMapRawPaths"), StringArray());
+	writeStringArray(writer, TEXT("detailMapRawPaths"), StringArray());
+	writer->WriteArrayStart(TEXT("detailPrototypes"));
+	writer->WriteArrayEnd();
+	writer->WriteValue(TEXT("detailResolution"), 0);
+	writer->WriteValue(TEXT("heightmapWidth"), hSize);
+	writer->WriteValue(TEXT("heightmapHeight"), hSize);
+	writer->WriteValue(TEXT("heightmapResolution"), hSize);
+	writeVector(writer, TEXT("heightmapScale"), FVector(worldSize.X / (hSize - 1), worldSize.Y, worldSize.Z / (hSize - 1)));
+	writeVector(writer, TEXT("worldSize"), worldSize);
+	writer->WriteValue(TEXT("thickness"), 1.0f);
+	writer->WriteValue(TEXT("treeInstanceCount"), 0);
+	writer->WriteArrayStart(TEXT("splatPrototypes"));
+	for(int32 layerIndex = 0; layerIndex < numLayers; layerIndex++){
+		writer->WriteObjectStart();
+		writer->WriteValue(TEXT("textureId"), (settings.numTextures > 0) ? layerIndex % settings.numTextures: -1);
+		writer->WriteValue(TEXT("normalMapId"), -1);
+		writer->WriteValue(TEXT("metallic"), 0.0f);
+		writer->WriteValue(TEXT("smoothness"), 0.0f);
+		writeColor(writer, TEXT("specular"), FLinearColor::White);
+		writeVector2(writer, TEXT("tileOffset"), FVector2D(0.0f, 0.0f));
+		writeVector2(writer, TEXT("tileSize"), FVector2D(15.0f, 15.0f));
+		writer->WriteObjectEnd();
+	}
+	writer->WriteArrayEnd();
+	writer->WriteArrayStart(TEXT("treeInstances"));
+	writer->WriteArrayEnd();
+	writer->WriteArrayStart(TEXT("treePrototypes"));
+	writer->WriteArrayEnd();
+	writer->WriteValue(TEXT("wavingGrassAmount"), 0.5f);
+	writer->WriteValue(TEXT("wavingGrassSpeed"), 0.5f);
+	writer->WriteValue(TEXT("wavingGrassStrength"), 0.5f);
+	writeColor(writer, TEXT("wavingGrassTint"), FLinearColor::White);
+	writer->WriteObjectEnd();
+	writer->Close();
+
+	auto relPath = FString::Printf(TEXT("terrain/%s.json"), terrainName);
+	if (!saveJson(relPath, outString))
+		return false;
+	terrains.Add(relPath);
+	resources.Add(assetPath);
+	return true;
+}
+
+bool SyntheticProjectGenerator::generateScene(){
+	auto sceneName = settings.name;
+	auto scenePath = getAssetPath(TEXT("Scenes"), sceneName + TEXT(".unity"));
+
+	FString outString;
+	auto writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&outString);
+	writer->WriteObjectStart();
+	writer->WriteValue(TEXT("name"), sceneName);
+	writer->WriteValue(TEXT("path"), scenePath);
+	writer->WriteValue(TEXT("buildIndex"), 0);
+	writer->WriteArrayStart(TEXT("objects"));
+
+	int32 objId = 0;
+	auto writeObjectHeader = [&](const FString &objName, const FVector &position, int32 meshId){
+		const FMatrix matrix = FTranslationMatrix(position);
+		writer->WriteValue(TEXT("name"), objName);
+		writer->WriteValue(TEXT("id"), objId);
+		writer->WriteValue(TEXT("scenePath"), scenePath);
+		writer->WriteValue(TEXT("instanceId"), 1000 + objId);
+		writeVector(writer, TEXT("localPosition"), position);
+		writeQuat(writer, TEXT("localRotation"), FQuat::Identity);
+		writeVector(writer, TEXT("localScale"), FVector::OneVector);
+		writeMatrix(writer, TEXT("worldMatrix"), matrix);
+		writeMatrix(writer, TEXT("localMatrix"), matrix);
+		writer->WriteValue(TEXT("parent"), -1);
+		writer->WriteValue(TEXT("parentName"), FString());
+		writer->WriteValue(TEXT("mesh"), meshId);
+		writer->WriteValue(TEXT("activeSelf"), true);
+		writer->WriteValue(TEXT("activeInHierarchy"), true);
+		const TCHAR* staticFlags[] = {TEXT("isStatic"), TEXT("lightMapStatic"), TEXT("navigationStatic"), TEXT("occluderStatic"), TEXT("occludeeStatic")};
+		for(auto flagName: staticFlags)
+			writer->WriteValue(flagName, meshId >= 0);
+		writer->WriteValue(TEXT("nameClash"), false);
+		writer->WriteValue(TEXT("uniqueName"), objName);
+		writer->WriteValue(TEXT("prefabRootId"), -1);
+		writer->WriteValue(TEXT("prefabObjectId"), -1);
+		writer->WriteValue(TEXT("prefabInstance"), false);
+		writer->WriteValue(TEXT("prefabModelInstance"), false);
+		writer->WriteValue(TEXT("prefabType"), TEXT("None"));
+		objId++;
+	};
+
+	const int32 gridWidth = FMath::Max(1, FMath::CeilToInt(FMath::Sqrt((float)settings.numMeshes)));
+	for(int32 meshIndex = 0; meshIndex < settings.numMeshes; meshIndex++){
+		const bool skinned = meshIndex < settings.numSkinnedMeshes;
+		const FVector position((meshIndex % gridWidth) * 10.0f, 0.0f, (meshIndex / gridWidth) * 10.0f);
+		IntArray objMaterials;
+		if (settings.numMaterials > 0)
+			objMaterials.Add(meshIndex % settings.numMaterials);
+
+		writer->WriteObjectStart();
+		writeObjectHeader(FString::Printf(TEXT("object_%d"), meshIndex), position, skinned ? -1: meshIndex);
+		if (!skinned){
+			writer->WriteArrayStart(TEXT("renderer"));
+			writer->WriteObjectStart();
+			writer->WriteValue(TEXT("lightmapIndex"), -1);
+			writer->WriteValue(TEXT("shadowCastingMode"), TEXT("On"));
+			writer->WriteValue(TEXT("receiveShadows"), true);
+			writeIntArray(writer, TEXT("materials"), objMaterials);
+			writer->WriteObjectEnd();
+			writer->WriteArrayEnd();
+		}
+		else{
+			const int32 skelId = meshIndex % settings.numSkeletons;
+			StringArray boneNames;
+			IntArray boneIds;
+			for(int32 boneIndex = 0; boneIndex < settings.bonesPerSkeleton; boneIndex++){
+				boneNames.Add(getBoneName(boneIndex));
+				boneIds.Add(boneIndex);
+			}
+
+			writer->WriteArrayStart(TEXT("skinRenderers"));
+			writer->WriteObjectStart();
+			writer->WriteValue(TEXT("quality"), TEXT("Auto"));
+			writer->WriteValue(TEXT("skinnedMotionVectors"), false);
+			writer->WriteValue(TEXT("updateWhenOffscreen"), false);
+			writeStringArray(writer, TEXT("boneNames"), boneNames);
+			writeIntArray(writer, TEXT("boneIds"), boneIds);
+			writer->WriteArrayStart(TEXT("boneTransforms"));
+			for(int32 boneIndex = 0; boneIndex < settings.bonesPerSkeleton; boneIndex++){
+				writer->WriteObjectStart();
+				writeMatrix(writer, getBoneWorldMatrix(boneIndex) * FTranslationMatrix(position));
+				writer->WriteObjectEnd();
+			}
+			writer->WriteArrayEnd();
+			writer->WriteValue(TEXT("meshId"), meshIndex);
+			writeIntArray(writer, TEXT("materials"), objMaterials);
+			writer->WriteObjectEnd();
+			writer->WriteArrayEnd();
+
+			if (animatorControllers.Num() > 0){
+				writer->WriteArrayStart(TEXT("animators"));
+				writer->WriteObjectStart();
+				writer->WriteValue(TEXT("name"), FString::Printf(TEXT("animator_%d"), meshIndex));
+				writer->WriteValue(TEXT("skeletonId"), skelId);
+				writeIntArray(writer, TEXT("skinMeshIds"), {meshIndex});
+				writer->WriteValue(TEXT("animatorControllerId"), 0);
+				writer->WriteValue(TEXT("applyRootMotion"), false);
+				writer->WriteValue(TEXT("cullingMode"), TEXT("AlwaysAnimate"));
+				writer->WriteValue(TEXT("hasRootMotion"), false);
+				writer->WriteValue(TEXT("hasTransformHierarchy"), true);
+				writer->WriteValue(TEXT("humanScale"), 1.0f);
+				writer->WriteValue(TEXT("isHuman"), false);
+				writer->WriteValue(TEXT("layerCount"), 1);
+				writer->WriteValue(TEXT("layersAffectMassCenter"), false);
+				writer->WriteValue(TEXT("linearVelocityBlending"), false);
+				writer->WriteValue(TEXT("speed"), 1.0f);
+				writer->WriteArrayStart(TEXT("humanBones"));
+				writer->WriteArrayEnd();
+				writer->WriteObjectEnd();
+				writer->WriteArrayEnd();
+			}
+		}
+		writer->WriteObjectEnd();
+	}
+
+	if (terrains.Num() > 0){
+		writer->WriteObjectStart();
+		writeObjectHeader(TEXT("terrain"), FVector(-settings.heightmapSize * 0.5f, -10.0f, -settings.heightmapSize * 0.5f), -1);
+		writer->WriteArrayStart(TEXT("terrains"));
+		writer->WriteObjectStart();
+		writer->WriteValue(TEXT("castShadows"), true);
+		writer->WriteValue(TEXT("detailObjectDensity"), 1.0f);
+		writer->WriteValue(TEXT("detailObjectDistance"), 80.0f);
+		writer->WriteValue(TEXT("drawHeightmap"), true);
+		writer->WriteValue(TEXT("drawTreesAndFoliage"), true);
+		writer->WriteValue(TEXT("renderHeightmap"), true);
+		writer->WriteValue(TEXT("renderTrees"), true);
+		writer->WriteValue(TEXT("renderDetails"), true);
+		writer->WriteValue(TEXT("heightmapPixelError"), 5.0f);
+		writer->WriteValue(TEXT("legacyShininess"), 0.078f);
+		writeColor(writer, TEXT("legacySpecular"), FLinearColor::Gray);
+		writer->WriteValue(TEXT("lightmapIndex"), -1);
+		writeVector4(writer, TEXT("lightmapScaleOffet"), FVector4(1.0f, 1.0f, 0.0f, 0.0f));
+		writer->WriteValue(TEXT("materialTemplateIndex"), -1);
+		writer->WriteValue(TEXT("materialType"), TEXT("BuiltInStandard"));
+		writeVector(writer, TEXT("patchBoundsMultiplier"), FVector::OneVector);
+		writer->WriteValue(TEXT("preserveTreePrototypeLayers"), false);
+		writer->WriteValue(TEXT("realtimeLightmapIndex"), -1);
+		writeVector4(writer, TEXT("realtimeLightmapScaleOffset"), FVector4(1.0f, 1.0f, 0.0f, 0.0f));
+		writer->WriteValue(TEXT("terrainDataId"), 0);
+		writer->WriteValue(TEXT("treeBillboardDistance"), 50.0f);
+		writer->WriteValue(TEXT("treeCrossFadeLength"), 5.0f);
+		writer->WriteValue(TEXT("treeDistance"), 5000.0f);
+		writer->WriteValue(TEXT("treeLodBiasMultiplier"), 1.0f);
+		writer->WriteValue(TEXT("treeMaximumFullLODCount"), 50);
+		writer->WriteObjectEnd();
+		writer->WriteArrayEnd();
+		writer->WriteObjectEnd();
+	}
+
+	writer->WriteArrayEnd();
+	writer->WriteObjectEnd();
+	writer->Close();
+
+	auto relPath = FString::Printf(TEXT("scenes/%s.json"), *sceneName);
+	if (!saveJson(relPath, outString))
+		return false;
+	scenes.Add(relPath);
+	resources.Add(scenePath);
+	return true;
+}
+
+bool SyntheticProjectGenerator::generateProject(const FString &projectFile){
+	FString outString;
+	auto writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&outString);
+	writer->WriteObjectStart();
+	writer->WriteObjectStart(TEXT("config"));
+	writer->WriteObjectEnd();
+	writer->WriteObjectStart(TEXT("externResources"));
+	writeStringArray(writer, TEXT("scenes"), scenes);
+	writeStringArray(writer, TEXT("materials"), materials);
+	writeStringArray(writer, TEXT("skeletons"), skeletons);
+	writeStringArray(writer, TEXT("meshes"), meshes);
+	writeStringArray(writer, TEXT("textures"), textures);
+	writeStringArray(writer, TEXT("prefabs"), StringArray());
+	writeStringArray(writer, TEXT("terrains"), terrains);
+	writeStringArray(writer, TEXT("cubemaps"), StringArray());
+	writeStringArray(writer, TEXT("audioClips"), StringArray());
+	writeStringArray(writer, TEXT("animationClips"), animationClips);
+	writeStringArray(writer, TEXT("animatorControllers"), animatorControllers);
+	writeStringArray(writer, TEXT("resources"), resources);
+	writer->WriteObjectEnd();
+	writer->WriteObjectEnd();
+	writer->Close();
+
+	if (!FFileHelper::SaveStringToFile(outString, *projectFile, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM)){
+		UE_LOG(JsonLog, Error, TEXT("Could not write \"%s\""), *projectFile);
+		return false;
+	}
+	return true;
+}
+
+bool SyntheticProjectGenerator::generate(const FString &outDir, FString *outProjectFile){
+	auto rootDir = FPaths::ConvertRelativePathToFull(outDir);
+	dataDir = FPaths::Combine(rootDir, settings.name);
+	auto projectFile = FPaths::Combine(rootDir, settings.name + TEXT(".json"));
+
+	if (IFileManager::Get().DirectoryExists(*dataDir) && !IFileManager::Get().DeleteDirectory(*dataDir, false, true)){
+		UE_LOG(JsonLog, Error, TEXT("Could not clear dataset directory \"%s\""), *dataDir);
+		return false;
+	}
+
+	random.Initialize(settings.seed);
+	scenes.Empty();
+	textures.Empty();
+	materials.Empty();
+	skeletons.Empty();
+	meshes.Empty();
+	terrains.Empty();
+	animationClips.Empty();
+	animatorControllers.Empty();
+	resources.Empty();
+
+	UE_LOG(JsonLog, Display, TEXT("Generating synthetic project \"%s\": %s"), *projectFile, *settings.toString());
+
+	//Scene has to go last, it references everything else
+	bool result = generateTextures() && generateMaterials() && generateSkeletons() && generateMeshes()
+		&& generateAnimations() && generateTerrains() && generateScene() && generateProject(projectFile);
+	if (!result){
+		UE_LOG(JsonLog, Error, TEXT("Synthetic project generation failed"));
+		return false;
+	}
+
+	if (outProjectFile)
+		*outProjectFile = projectFile;
+	return true;
+}
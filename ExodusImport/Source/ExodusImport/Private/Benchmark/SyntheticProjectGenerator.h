@@ -0,0 +1,109 @@
+#pragma once
+
+#include "JsonTypes.h"
+#include "JsonObjects/JsonBinaryMesh.h"
+#include "Math/RandomStream.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+
+/*
+Size of the generated dataset. Zero counts disable the corresponding resource type.
+*/
+class SyntheticProjectSettings{
+public:
+	FString name = TEXT("synthetic");
+	int32 seed = 1;
+
+	int32 numMeshes = 64;
+	//Approximate, meshes are square grids
+	int32 vertsPerMesh = 4096;
+	int32 numMaterials = 16;
+	int32 numTextures = 16;
+	int32 textureSize = 256;
+
+	int32 numSkeletons = 0;
+	int32 bonesPerSkeleton = 32;
+	//Number of meshes (out of numMeshes) that get skin weights
+	int32 numSkinnedMeshes = 0;
+	int32 numAnimClips = 0;
+	int32 framesPerClip = 60;
+
+	//Heightmap resolution, 0 means no terrain
+	int32 heightmapSize = 0;
+	int32 numSplatLayers = 4;
+
+	//Write vertex and index data into ".exmesh" sidecars instead of mesh json
+	bool binaryMeshes = false;
+
+	FString toString() const;
+};
+
+/*
+Writes an export tree that matches ExodusExport output: <outDir>/<name>.json project file and
+resource files in <outDir>/<name>/.
+
+Used by the benchmark commandlet to get reproducible import workloads of a given scale.
+*/
+class SyntheticProjectGenerator{
+public:
+	using JsonStringWriter = TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>;
+	using JsonStringWriterRef = TSharedRef<JsonStringWriter>;
+
+	class BinaryMeshBlock{
+	public:
+		JsonBinaryMesh::BlockType type;
+		uint32 index;
+		const void* data;
+		int64 size;
+	};
+protected:
+	SyntheticProjectSettings settings;
+	FRandomStream random;
+	FString dataDir;
+
+	StringArray scenes;
+	StringArray textures;
+	StringArray materials;
+	StringArray skeletons;
+	StringArray meshes;
+	StringArray terrains;
+	StringArray animationClips;
+	StringArray animatorControllers;
+	StringArray resources;
+
+	FString getAssetPath(const FString &folder, const FString &fileName) const;
+	bool saveJson(const FString &relPath, const FString &content) const;
+	bool saveBinaryMesh(const FString &relPath, const TArray<BinaryMeshBlock> &blocks) const;
+	FString getBoneName(int32 boneIndex) const;
+	FMatrix getBoneLocalMatrix(int32 boneIndex) const;
+	FMatrix getBoneWorldMatrix(int32 boneIndex) const;
+
+	static void writeVector(JsonStringWriterRef writer, const FString &name, const FVector &value);
+	static void writeVector2(JsonStringWriterRef writer, const FString &name, const FVector2D &value);
+	static void writeVector4(JsonStringWriterRef writer, const FString &name, const FVector4 &value);
+	static void writeQuat(JsonStringWriterRef writer, const FString &name, const FQuat &value);
+	static void writeColor(JsonStringWriterRef writer, const FString &name, const FLinearColor &value);
+	static void writeMatrix(JsonStringWriterRef writer, const FMatrix &value);
+	static void writeMatrix(JsonStringWriterRef writer, const FString &name, const FMatrix &value);
+	static void writeBounds(JsonStringWriterRef writer, const FString &name, const FVector &center, const FVector &size);
+	static void writeFloatArray(JsonStringWriterRef writer, const FString &name, const FloatArray &values);
+	static void writeIntArray(JsonStringWriterRef writer, const FString &name, const IntArray &values);
+	static void writeStringArray(JsonStringWriterRef writer, const FString &name, const StringArray &values);
+
+	bool writeTextureImage(const FString &filename, int32 texIndex);
+	bool generateTextures();
+	bool generateMaterials();
+	bool generateSkeletons();
+	bool generateMeshes();
+	bool generateAnimations();
+	bool generateTerrains();
+	bool generateScene();
+	bool generateProject(const FString &projectFile);
+public:
+	/*
+	Returns full path of the project json in outProjectFile.
+	*/
+	bool generate(const FString &outDir, FString *outProjectFile = nullptr);
+
+	SyntheticProjectGenerator(const SyntheticProjectSettings &settings_);
+};
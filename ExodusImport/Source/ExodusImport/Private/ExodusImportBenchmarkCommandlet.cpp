@@ -0,0 +1,141 @@
+#include "JsonImportPrivatePCH.h"
+#include "ExodusImportBenchmarkCommandlet.h"
+#include "Benchmark/SyntheticProjectGenerator.h"
+#include "JsonImporter.h"
+#include "JsonLog.h"
+#include "ImportProfiler.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+
+UExodusImportBenchmarkCommandlet::UExodusImportBenchmarkCommandlet(){
+	HelpDescription = TEXT("Generates synthetic ExodusExport dataset, imports it and reports per-stage timings");
+	HelpUsage = TEXT("-run=ExodusImportBenchmark -dataset=<dir> [-generate] [-meshes=N] [-verts=N] [-textures=N] [-skeletons=N] [-clips=N] [-heightmap=N] [-binarymeshes] [-out=/Game/Benchmark] [-profiledir=<dir>] [-save]");
+}
+
+void UExodusImportBenchmarkCommandlet::parseSettings(const FString &params, SyntheticProjectSettings &settings){
+	FParse::Value(*params, TEXT("name="), settings.name);
+	FParse::Value(*params, TEXT("seed="), settings.seed);
+	FParse::Value(*params, TEXT("meshes="), settings.numMeshes);
+	FParse::Value(*params, TEXT("verts="), settings.vertsPerMesh);
+	FParse::Value(*params, TEXT("materials="), settings.numMaterials);
+	FParse::Value(*params, TEXT("textures="), settings.numTextures);
+	FParse::Value(*params, TEXT("texturesize="), settings.textureSize);
+	FParse::Value(*params, TEXT("skeletons="), settings.numSkeletons);
+	FParse::Value(*params, TEXT("bones="), settings.bonesPerSkeleton);
+	FParse::Value(*params, TEXT("skinned="), settings.numSkinnedMeshes);
+	FParse::Value(*params, TEXT("clips="), settings.numAnimClips);
+	FParse::Value(*params, TEXT("frames="), settings.framesPerClip);
+	FParse::Value(*params, TEXT("heightmap="), settings.heightmapSize);
+	FParse::Value(*params, TEXT("splats="), settings.numSplatLayers);
+	settings.binaryMeshes = FParse::Param(*params, TEXT("binarymeshes"));
+}
+
+bool UExodusImportBenchmarkCommandlet::saveReport(const FString &filename, const SyntheticProjectSettings &settings, double importTime, bool imported){
+	const double toMs = 1000.0;
+	const double toMb = 1.0 / (1024.0 * 1024.0);
+
+	TArray<ImportProfiler::StageStats> stats;
+	ImportProfiler::get().getStats(stats, false);
+
+	FString outString;
+	auto writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&outString);
+	writer->WriteObjectStart();
+	writer->WriteValue(TEXT("dataset"), settings.toString());
+	writer->WriteValue(TEXT("imported"), imported);
+	writer->WriteValue(TEXT("importTimeMs"), importTime * toMs);
+	writer->WriteValue(TEXT("profiledTimeMs"), ImportProfiler::get().getElapsedTime() * toMs);
+	writer->WriteArrayStart(TEXT("stages"));
+	for(const auto &cur: stats){
+		writer->WriteObjectStart();
+		writer->WriteValue(TEXT("stage"), FString(cur.stage));
+		writer->WriteValue(TEXT("calls"), cur.calls);
+		writer->WriteValue(TEXT("totalMs"), cur.totalTime * toMs);
+		writer->WriteValue(TEXT("maxMs"), cur.maxTime * toMs);
+		writer->WriteValue(TEXT("bytes"), cur.bytes);
+		writer->WriteValue(TEXT("elements"), cur.elements);
+		writer->WriteValue(TEXT("maxUsedMB"), cur.maxUsedMemory * toMb);
+		writer->WriteValue(TEXT("peakMB"), cur.peakMemory * toMb);
+		writer->WriteObjectEnd();
+	}
+	writer->WriteArrayEnd();
+	writer->WriteObjectEnd();
+	writer->Close();
+
+	if (!FFileHelper::SaveStringToFile(outString, *filename)){
+		UE_LOG(JsonLog, Error, TEXT("Could not write benchmark report \"%s\""), *filename);
+		return false;
+	}
+	UE_LOG(JsonLog, Display, TEXT("Benchmark report saved to \"%s\""), *filename);
+
+	for(const auto &cur: stats){
+		UE_LOG(JsonLog, Display, TEXT("%-32s calls: %6d total: %10.2f ms max: %9.2f ms peak: %8.1f MB"),
+			cur.stage, cur.calls, cur.totalTime * toMs, cur.maxTime * toMs, cur.peakMemory * toMb);
+	}
+	return true;
+}
+
+int32 UExodusImportBenchmarkCommandlet::Main(const FString &params){
+	FString datasetDir;
+	if (!FParse::Value(*params, TEXT("dataset="), datasetDir) || datasetDir.IsEmpty()){
+		UE_LOG(JsonLog, Error, TEXT("Dataset directory is not specified. Usage: %s"), *HelpUsage);
+		return ExitInvalidArguments;
+	}
+	datasetDir = FPaths::ConvertRelativePathToFull(datasetDir);
+
+	SyntheticProjectSettings settings;
+	parseSettings(params, settings);
+
+	FString projectPath = FPaths::Combine(datasetDir, settings.name + TEXT(".json"));
+	if (FParse::Param(*params, TEXT("generate")) || !FPaths::FileExists(projectPath)){
+		const double genStart = FPlatformTime::Seconds();
+		SyntheticProjectGenerator generator(settings);
+		if (!generator.generate(datasetDir, &projectPath)){
+			UE_LOG(JsonLog, Error, TEXT("Could not generate dataset in \"%s\""), *datasetDir);
+			return ExitInvalidArguments;
+		}
+		UE_LOG(JsonLog, Display, TEXT("Dataset generated in %f seconds"), FPlatformTime::Seconds() - genStart);
+	}
+
+	FString outPath = TEXT("/Game/Benchmark");
+	FParse::Value(*params, TEXT("out="), outPath);
+	FText reason;
+	if (!FPackageName::IsValidLongPackageName(outPath, true, &reason)){
+		UE_LOG(JsonLog, Error, TEXT("Invalid output package path \"%s\": %s"), *outPath, *reason.ToString());
+		return ExitInvalidArguments;
+	}
+
+	FString profileDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ExodusImport"), TEXT("Benchmark"));
+	FParse::Value(*params, TEXT("profiledir="), profileDir);
+
+	JsonImporter importer;
+	auto options = importer.getOptions();
+	options.interactive = false;
+	options.incrementalImport = false;
+	options.packageRoot = outPath;
+	options.profile = true;
+	options.profileMemory = true;
+	options.profileDir = profileDir;
+	importer.setOptions(options);
+
+	UE_LOG(JsonLog, Display, TEXT("Benchmarking import of \"%s\" (%s)"), *projectPath, *settings.toString());
+	const double startTime = FPlatformTime::Seconds();
+	bool imported = importer.importProject(projectPath);
+	const double importTime = FPlatformTime::Seconds() - startTime;
+	UE_LOG(JsonLog, Display, TEXT("Import finished in %f seconds"), importTime);
+
+	auto reportFile = FPaths::Combine(profileDir,
+		FString::Printf(TEXT("%s_%s.benchmark.json"), *settings.name, *FDateTime::Now().ToString()));
+	saveReport(reportFile, settings, importTime, imported);
+
+	int32 numSaveFailures = 0;
+	if (FParse::Param(*params, TEXT("save")))
+		numSaveFailures = saveDirtyPackages();
+
+	if (!imported){
+		UE_LOG(JsonLog, Error, TEXT("Import of \"%s\" failed"), *projectPath);
+		return ExitImportFailed;
+	}
+	if (numSaveFailures > 0)
+		return ExitSaveFailed;
+	return ExitSuccess;
+}
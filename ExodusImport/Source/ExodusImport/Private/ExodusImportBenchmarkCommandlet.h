@@ -0,0 +1,32 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ExodusImportCommandlet.h"
+#include "ExodusImportBenchmarkCommandlet.generated.h"
+
+class SyntheticProjectSettings;
+
+/*
+End-to-end import benchmark on a synthetic dataset.
+
+Usage:
+	UE4Editor-Cmd <uproject> -run=ExodusImportBenchmark -dataset=<dir> [-generate] [-name=synthetic] [-seed=1]
+		[-meshes=64] [-verts=4096] [-materials=16] [-textures=16] [-texturesize=256]
+		[-skeletons=0] [-bones=32] [-skinned=0] [-clips=0] [-frames=60] [-heightmap=0]
+		[-out=/Game/Benchmark] [-profiledir=<dir>] [-save]
+
+Dataset is (re)generated when -generate is passed or when it does not exist yet, so the same dataset
+can be imported repeatedly. Import runs non-incrementally with memory profiling enabled; profiler trace,
+per-asset csv and <name>_<timestamp>.benchmark.json with per-stage totals are written to -profiledir.
+Imported packages are only saved with -save.
+*/
+UCLASS()
+class UExodusImportBenchmarkCommandlet: public UExodusImportCommandlet{
+	GENERATED_BODY()
+public:
+	UExodusImportBenchmarkCommandlet();
+	virtual int32 Main(const FString &params) override;
+protected:
+	static void parseSettings(const FString &params, SyntheticProjectSettings &settings);
+	static bool saveReport(const FString &filename, const SyntheticProjectSettings &settings, double importTime, bool imported);
+};
@@ -0,0 +1,106 @@
+#include "JsonImportPrivatePCH.h"
+#include "ExodusImportCommandlet.h"
+#include "JsonImporter.h"
+#include "JsonLog.h"
+#include "UnrealUtilities.h"
+#include "Misc/PackageName.h"
+#include "UObject/UObjectIterator.h"
+#include "UObject/Package.h"
+
+UExodusImportCommandlet::UExodusImportCommandlet(){
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+	ShowErrorCount = true;
+	HelpDescription = TEXT("Imports project exported by ExodusExport without user interface");
+	HelpUsage = TEXT("-run=ExodusImport -project=<project.json> [-out=/Game/Import] [-profiledir=<dir>] [-noprofile] [-instance] [-merge] [-mergecell=<size>] [-lods=<count>] [-skeletallods=<count>] [-optimizemeshes] [-defermeshbuild] [-collisionpolicy] [-mergeskeletons] [-autolightmaps] [-lightmapdensity=<texels per meter>]");
+}
+
+int32 UExodusImportCommandlet::saveDirtyPackages(){
+	TArray<UPackage*> packages;
+	for(TObjectIterator<UPackage> it; it; ++it){
+		auto package = *it;
+		if (!package->IsDirty() || package->HasAnyFlags(RF_Transient) || (package == GetTransientPackage()))
+			continue;
+		if (!FPackageName::IsValidLongPackageName(package->GetName()) || package->GetName().StartsWith(TEXT("/Script/")))
+			continue;
+		packages.Add(package);
+	}
+
+	int32 numFailed = 0;
+	for(auto package: packages){
+		const auto &extension = package->ContainsMap() ? FPackageName::GetMapPackageExtension(): FPackageName::GetAssetPackageExtension();
+		auto filename = FPackageName::LongPackageNameToFilename(package->GetName(), extension);
+		if (!UPackage::SavePackage(package, nullptr, RF_Standalone, *filename, GError, nullptr, false, true, SAVE_NoError)){
+			UE_LOG(JsonLog, Error, TEXT("Could not save package \"%s\" to \"%s\""), *package->GetName(), *filename);
+			numFailed++;
+			continue;
+		}
+		UE_LOG(JsonLog, Log, TEXT("Saved package \"%s\""), *package->GetName());
+	}
+
+	UE_LOG(JsonLog, Display, TEXT("Saved %d packages, %d failed"), packages.Num() - numFailed, numFailed);
+	return numFailed;
+}
+
+int32 UExodusImportCommandlet::Main(const FString &params){
+	FString projectPath, outPath;
+	if (!FParse::Value(*params, TEXT("project="), projectPath) || projectPath.IsEmpty()){
+		UE_LOG(JsonLog, Error, TEXT("Project file is not specified. Usage: %s"), *HelpUsage);
+		return ExitInvalidArguments;
+	}
+
+	projectPath = FPaths::ConvertRelativePathToFull(projectPath);
+	if (!FPaths::FileExists(projectPath)){
+		UE_LOG(JsonLog, Error, TEXT("Project file \"%s\" does not exist"), *projectPath);
+		return ExitInvalidArguments;
+	}
+
+	FParse::Value(*params, TEXT("out="), outPath);
+	if (outPath.IsEmpty())
+		outPath = UnrealUtilities::getDefaultImportPath();
+	while(outPath.Len() > 1 && outPath.EndsWith(TEXT("/")))
+		outPath.RemoveAt(outPath.Len() - 1);
+
+	FText reason;
+	if (!FPackageName::IsValidLongPackageName(outPath, true, &reason)){
+		UE_LOG(JsonLog, Error, TEXT("Invalid output package path \"%s\": %s"), *outPath, *reason.ToString());
+		return ExitInvalidArguments;
+	}
+
+	UE_LOG(JsonLog, Display, TEXT("Importing \"%s\" into \"%s\""), *projectPath, *outPath);
+	const double startTime = FPlatformTime::Seconds();
+
+	JsonImporter importer;
+	auto options = importer.getOptions();
+	options.interactive = false;
+	options.packageRoot = outPath;
+	options.profile = !FParse::Param(*params, TEXT("noprofile"));
+	FParse::Value(*params, TEXT("profiledir="), options.profileDir);
+	options.instanceStaticMeshes = FParse::Param(*params, TEXT("instance"));
+	options.mergeStaticMeshes = FParse::Param(*params, TEXT("merge"));
+	FParse::Value(*params, TEXT("mergecell="), options.mergeCellSize);
+	FParse::Value(*params, TEXT("lods="), options.numStaticMeshLods);
+	FParse::Value(*params, TEXT("skeletallods="), options.numSkeletalMeshLods);
+	options.optimizeMeshes = FParse::Param(*params, TEXT("optimizemeshes"));
+	options.deferStaticMeshBuild = FParse::Param(*params, TEXT("defermeshbuild"));
+	options.useCollisionPolicy = FParse::Param(*params, TEXT("collisionpolicy"));
+	options.mergeSkeletons = FParse::Param(*params, TEXT("mergeskeletons"));
+	options.autoLightmaps = FParse::Param(*params, TEXT("autolightmaps"));
+	FParse::Value(*params, TEXT("lightmapdensity="), options.lightmapTexelsPerMeter);
+	importer.setOptions(options);
+
+	bool imported = importer.importProject(projectPath);
+	UE_LOG(JsonLog, Display, TEXT("Import finished in %f seconds"), FPlatformTime::Seconds() - startTime);
+
+	auto numSaveFailures = saveDirtyPackages();
+
+	if (!imported){
+		UE_LOG(JsonLog, Error, TEXT("Import of \"%s\" failed"), *projectPath);
+		return ExitImportFailed;
+	}
+	if (numSaveFailures > 0)
+		return ExitSaveFailed;
+	return ExitSuccess;
+}
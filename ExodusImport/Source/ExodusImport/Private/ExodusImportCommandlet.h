@@ -0,0 +1,32 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ExodusImportCommandlet.generated.h"
+
+/*
+Headless project import.
+
+Usage:
+	UE4Editor-Cmd <uproject> -run=ExodusImport -project=<path to exported project json> [-out=/Game/Import] [-profiledir=<dir>] [-noprofile]
+
+-out sets the long package path assets are created in, defaults to UnrealUtilities::getDefaultImportPath().
+-profiledir sets where ImportProfiler results go, -noprofile disables profiling.
+Every package dirtied by the import is saved once import finishes.
+*/
+UCLASS()
+class UExodusImportCommandlet: public UCommandlet{
+	GENERATED_BODY()
+public:
+	enum ExitCode{
+		ExitSuccess = 0,
+		ExitInvalidArguments = 1,
+		ExitImportFailed = 2,
+		ExitSaveFailed = 3
+	};
+
+	UExodusImportCommandlet();
+	virtual int32 Main(const FString &params) override;
+protected:
+	static int32 saveDirtyPackages();
+};
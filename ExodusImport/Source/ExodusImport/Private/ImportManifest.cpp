@@ -0,0 +1,217 @@
+#include "JsonImportPrivatePCH.h"
+#include "ImportManifest.h"
+#include "JsonObjects.h"
+#include "Misc/SecureHash.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Serialization/JsonWriter.h"
+#include "Serialization/JsonSerializer.h"
+
+using namespace JsonObjects;
+
+static const TCHAR* recordTypeNames[] = {
+	TEXT("unknown"),
+	TEXT("texture"),
+	TEXT("cubemap"),
+	TEXT("materialInstance"),
+	TEXT("staticMesh"),
+	TEXT("skeletalMesh"),
+	TEXT("skeleton"),
+	TEXT("animSequence"),
+	TEXT("meshGeometry")
+};
+
+static ImportManifestRecordType recordTypeFromString(const FString &arg){
+	for(int i = 0; i < sizeof(recordTypeNames)/sizeof(recordTypeNames[0]); i++){
+		if (arg == recordTypeNames[i])
+			return (ImportManifestRecordType)i;
+	}
+	return ImportManifestRecordType::Unknown;
+}
+
+void ImportManifest::clear(){
+	prevEntries.Empty();
+	curEntries.Empty();
+	rebuiltKeys.Empty();
+	activeKey.Empty();
+}
+
+bool ImportManifest::load(const FString &filename){
+	clear();
+	if (!FPaths::FileExists(filename)){
+		UE_LOG(JsonLog, Log, TEXT("Import manifest \"%s\" not found, full import will be performed"), *filename);
+		return false;
+	}
+
+	auto data = loadJsonFromFile(filename);
+	if (!data.IsValid())
+		return false;
+
+	int32 version = 0;
+	data->TryGetNumberField(TEXT("version"), version);
+	if (version != currentVersion){
+		UE_LOG(JsonLog, Warning, TEXT("Import manifest \"%s\" has version %d, expected %d. Ignoring it."),
+			*filename, version, (int32)currentVersion);
+		return false;
+	}
+
+	const JsonValPtrs *entries = nullptr;
+	if (!data->TryGetArrayField(TEXT("entries"), entries) || !entries)
+		return false;
+
+	for(const auto &curVal: *entries){
+		auto curObj = curVal.IsValid() ? curVal->AsObject(): nullptr;
+		if (!curObj.IsValid())
+			continue;
+
+		FString key = getString(curObj, "key");
+		ImportManifestEntry entry;
+		entry.hash = getString(curObj, "hash");
+		entry.dependencies = getStringArray(curObj, "dependencies", true);
+
+		const JsonValPtrs *records = nullptr;
+		if (curObj->TryGetArrayField(TEXT("records"), records) && records){
+			for(const auto &recVal: *records){
+				auto recObj = recVal.IsValid() ? recVal->AsObject(): nullptr;
+				if (!recObj.IsValid())
+					continue;
+				ImportManifestRecord record;
+				record.type = recordTypeFromString(getString(recObj, "type"));
+				record.id = getInt(recObj, "id");
+				record.subId = getInt(recObj, "subId");
+				record.objectPath = getString(recObj, "path");
+				recObj->TryGetStringField(TEXT("geometryKey"), record.geometryKey);
+				entry.records.Add(record);
+			}
+		}
+		prevEntries.Add(key, entry);
+	}
+
+	UE_LOG(JsonLog, Log, TEXT("Loaded import manifest \"%s\", %d entries"), *filename, prevEntries.Num());
+	return true;
+}
+
+bool ImportManifest::save(const FString &filename) const{
+	FString outString;
+	auto writer = TJsonWriterFactory<>::Create(&outString);
+
+	writer->WriteObjectStart();
+	writer->WriteValue(TEXT("version"), (int32)currentVersion);
+	writer->WriteArrayStart(TEXT("entries"));
+
+	StringArray keys;
+	curEntries.GetKeys(keys);
+	keys.Sort();
+	for(const auto &key: keys){
+		const auto &entry = curEntries[key];
+		writer->WriteObjectStart();
+		writer->WriteValue(TEXT("key"), key);
+		writer->WriteValue(TEXT("hash"), entry.hash);
+		writer->WriteArrayStart(TEXT("dependencies"));
+		for(const auto &dep: entry.dependencies)
+			writer->WriteValue(dep);
+		writer->WriteArrayEnd();
+		writer->WriteArrayStart(TEXT("records"));
+		for(const auto &record: entry.records){
+			writer->WriteObjectStart();
+			writer->WriteValue(TEXT("type"), recordTypeNames[(int)record.type]);
+			writer->WriteValue(TEXT("id"), record.id);
+			writer->WriteValue(TEXT("subId"), record.subId);
+			writer->WriteValue(TEXT("path"), record.objectPath);
+			if (!record.geometryKey.IsEmpty())
+				writer->WriteValue(TEXT("geometryKey"), record.geometryKey);
+			writer->WriteObjectEnd();
+		}
+		writer->WriteArrayEnd();
+		writer->WriteObjectEnd();
+	}
+
+	writer->WriteArrayEnd();
+	writer->WriteObjectEnd();
+	writer->Close();
+
+	if (!FFileHelper::SaveStringToFile(outString, *filename)){
+		UE_LOG(JsonLog, Warning, TEXT("Could not save import manifest \"%s\""), *filename);
+		return false;
+	}
+	UE_LOG(JsonLog, Log, TEXT("Saved import manifest \"%s\", %d entries"), *filename, curEntries.Num());
+	return true;
+}
+
+FString ImportManifest::hashFiles(const StringArray &filenames){
+	FMD5 md5;
+	auto &platformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const int64 chunkSize = 1024 * 1024;
+	TArray<uint8> chunk;
+
+	for(const auto &curFilename: filenames){
+		TUniquePtr<IFileHandle> handle(platformFile.OpenRead(*curFilename));
+		if (!handle.IsValid()){
+			//missing files still have to affect the hash
+			static const uint8 missingMarker[] = {'-', '-', 'n', 'o', 'f', 'i', 'l', 'e', '-', '-'};
+			md5.Update(missingMarker, sizeof(missingMarker));
+			continue;
+		}
+
+		chunk.SetNumUninitialized(chunkSize);
+		int64 remaining = handle->Size();
+		while(remaining > 0){
+			const int64 curSize = FMath::Min(remaining, chunkSize);
+			if (!handle->Read(chunk.GetData(), curSize))
+				break;
+			md5.Update(chunk.GetData(), curSize);
+			remaining -= curSize;
+		}
+	}
+
+	uint8 digest[16];
+	md5.Final(digest);
+	return BytesToHex(digest, sizeof(digest));
+}
+
+const ImportManifestEntry* ImportManifest::findUpToDateEntry(const FString &key, const FString &hash) const{
+	auto found = prevEntries.Find(key);
+	if (!found || (found->hash != hash))
+		return nullptr;
+
+	for(const auto &dep: found->dependencies){
+		if (rebuiltKeys.Contains(dep) || !curEntries.Contains(dep))
+			return nullptr;
+	}
+	return found;
+}
+
+void ImportManifest::keepEntry(const FString &key){
+	auto found = prevEntries.Find(key);
+	check(found);
+	curEntries.Add(key, *found);
+	rebuiltKeys.Remove(key);
+}
+
+void ImportManifest::beginEntry(const FString &key, const FString &hash, const StringArray &dependencies){
+	ImportManifestEntry entry;
+	entry.hash = hash;
+	entry.dependencies = dependencies;
+	curEntries.Add(key, entry);
+	rebuiltKeys.Add(key);
+	activeKey = key;
+}
+
+void ImportManifest::endEntry(){
+	activeKey.Empty();
+}
+
+void ImportManifest::addDependency(const FString &key){
+	if (activeKey.IsEmpty() || (key == activeKey))
+		return;
+	auto entry = curEntries.Find(activeKey);
+	if (entry)
+		entry->dependencies.AddUnique(key);
+}
+
+void ImportManifest::addRecord(const ImportManifestRecord &record){
+	if (activeKey.IsEmpty())
+		return;
+	auto entry = curEntries.Find(activeKey);
+	if (entry)
+		entry->records.Add(record);
+}
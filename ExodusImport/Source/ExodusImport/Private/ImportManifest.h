@@ -0,0 +1,91 @@
+#pragma once
+
+#include "JsonTypes.h"
+
+enum class ImportManifestRecordType{
+	Unknown = 0,
+	Texture,
+	Cubemap,
+	MaterialInstance,
+	StaticMesh,
+	SkeletalMesh,
+	Skeleton,
+	AnimSequence,
+	//Static mesh registered for deduplication under geometryKey, see JsonImporter::staticMeshGeometryMap
+	MeshGeometry
+};
+
+/*
+Describes one id->asset registration performed while importing a resource.
+Registrations are replayed when the resource is skipped during re-import.
+*/
+class ImportManifestRecord{
+public:
+	ImportManifestRecordType type = ImportManifestRecordType::Unknown;
+	JsonId id = -1;
+	JsonId subId = -1;
+	FString objectPath;
+	//Only used by MeshGeometry records
+	FString geometryKey;
+
+	ImportManifestRecord() = default;
+	ImportManifestRecord(ImportManifestRecordType type_, JsonId id_, JsonId subId_, const FString &objectPath_)
+	:type(type_), id(id_), subId(subId_), objectPath(objectPath_){
+	}
+};
+
+class ImportManifestEntry{
+public:
+	FString hash;
+	StringArray dependencies;
+	TArray<ImportManifestRecord> records;
+};
+
+/*
+Persistent map of extern resources to content hashes and the assets they produced.
+
+Resource is considered up to date when its hash matches the previous run, and none of its dependencies
+were rebuilt in the current run. Dependencies must be processed before resources that use them.
+*/
+class ImportManifest{
+protected:
+	TMap<FString, ImportManifestEntry> prevEntries;
+	TMap<FString, ImportManifestEntry> curEntries;
+	TSet<FString> rebuiltKeys;
+	FString activeKey;
+public:
+	enum{
+		currentVersion = 1
+	};
+
+	void clear();
+	bool load(const FString &filename);
+	bool save(const FString &filename) const;
+
+	static FString hashFiles(const StringArray &filenames);
+
+	bool hasPrevEntry(const FString &key) const{
+		return prevEntries.Contains(key);
+	}
+	//Previous run data does not change during import and can be read from worker threads.
+	const ImportManifestEntry* findPrevEntry(const FString &key) const{
+		return prevEntries.Find(key);
+	}
+	const ImportManifestEntry* findUpToDateEntry(const FString &key, const FString &hash) const;
+	bool isRebuilt(const FString &key) const{
+		return rebuiltKeys.Contains(key);
+	}
+
+	/*
+	Marks resource as unchanged and carries its previous records into the current run.
+	*/
+	void keepEntry(const FString &key);
+	/*
+	Starts a rebuilt entry, records added till endEntry() are stored in it.
+	*/
+	void beginEntry(const FString &key, const FString &hash, const StringArray &dependencies);
+	void endEntry();
+	//Adds dependency discovered while building the active entry.
+	void addDependency(const FString &key);
+	void addRecord(const ImportManifestRecord &record);
+};
@@ -0,0 +1,26 @@
+#include "JsonImportPrivatePCH.h"
+#include "ImportOptions.h"
+#include "Async/TaskGraphInterfaces.h"
+
+int32 ImportOptions::getNumParseThreads(int32 numTasks) const{
+	int32 result = maxParseThreads;
+	if (result <= 0)
+		result = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;//game thread participates in ParallelFor too
+	return FMath::Clamp(result, 1, FMath::Max(numTasks, 1));
+}
+
+static float getLodValue(const TArray<float> &values, int32 lod){
+	if (lod <= 0)
+		return 1.0f;
+	if (lod <= values.Num())
+		return FMath::Clamp(values[lod - 1], 0.0f, 1.0f);
+	return getLodValue(values, lod - 1) * 0.5f;
+}
+
+float ImportOptions::getLodTriangleFraction(int32 lod) const{
+	return getLodValue(lodTriangleFractions, lod);
+}
+
+float ImportOptions::getLodScreenSize(int32 lod) const{
+	return getLodValue(lodScreenSizes, lod);
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+Settings that affect the whole import run.
+*/
+class ImportOptions{
+public:
+	//Maximum number of threads used to read and parse resource files. 0 or less means "use all task graph workers".
+	int32 maxParseThreads = 0;
+	/*
+	Lower bound on the number of resources the import scheduler prepares ahead of the one being built (see ImportScheduler::run),
+	the actual limit is the larger of this and twice the number of preparation threads. Limits parsed data kept in memory.
+	*/
+	int32 meshParseBatchSize = 64;
+	//Skip resources that did not change since the previous import (see ImportManifest).
+	bool incrementalImport = true;
+	//Meshes with identical geometry and materials share a single UStaticMesh (see JsonMesh::computeGeometryHash).
+	bool deduplicateMeshes = true;
+	/*
+	Repeated static, collider-less mesh objects of a scene are imported as hierarchical instanced static mesh components
+	(see InstancedMeshBuilder) instead of one actor per object. Groups smaller than minInstanceCount are imported as usual.
+	*/
+	bool instanceStaticMeshes = false;
+	int32 minInstanceCount = 4;
+	/*
+	Static, collider-less scenery is merged into one mesh per world-space grid cell (see MergedMeshBuilder).
+	Runs after instancing, so repeated meshes are still instanced when both are enabled. Cell size is in unreal units.
+	*/
+	bool mergeStaticMeshes = false;
+	float mergeCellSize = 5000.0f;
+	int32 minMergeCount = 2;
+	/*
+	Weld identical vertices and reorder triangles and vertices of imported meshes for the GPU (see JsonMesh::optimizeForRendering).
+	Overdraw reordering trades a little vertex cache efficiency for drawing outer triangles first.
+	*/
+	bool optimizeMeshes = false;
+	bool optimizeMeshOverdraw = true;
+	/*
+	Number of LODs generated for static meshes in addition to LOD0 (see MeshSimplifier), 0 disables generation.
+	lodTriangleFractions and lodScreenSizes hold values for LOD1, LOD2 and so on. LODs without an entry halve the previous value.
+	*/
+	int32 numStaticMeshLods = 0;
+	TArray<float> lodTriangleFractions = {0.5f, 0.25f, 0.125f};
+	TArray<float> lodScreenSizes = {0.5f, 0.25f, 0.125f};
+	/*
+	Same for skinned meshes, which use the same fractions and screen sizes. Triangles are only collapsed between vertices 
+	with the same dominant bone, and every LOD drops leaf bones whose skinned area is smaller than lod * lodBoneSizeFraction
+	of the mesh bounds (fingers, facial bones), their weights go to the nearest remaining parent. 0 keeps all bones.
+	*/
+	int32 numSkeletalMeshLods = 0;
+	float lodBoneSizeFraction = 0.03f;
+	/*
+	Simple collision policy for static meshes (see JsonImporter::prepareMeshCollision). Without it every mesh gets an 18-DOP hull.
+	With it, meshes that no mesh collider refers to get no collision, convex collider meshes are split into up to maxConvexHulls hulls,
+	and the rest get a box (box-like meshes up to collisionBoxMaxTriangles), a sphere (sphere-like meshes from collisionSphereMinTriangles) or an 18-DOP hull.
+	*/
+	bool useCollisionPolicy = false;
+	int32 collisionBoxMaxTriangles = 12;
+	int32 collisionSphereMinTriangles = 48;
+	int32 maxConvexHulls = 8;
+	/*
+	Skeletons whose bone hierarchy is identical to, or a subset of, another skeleton's share one USkeleton, 
+	along with their animation clips (see JsonImporter::buildSkeletonMergeMap).
+	*/
+	bool mergeSkeletons = false;
+	/*
+	Lightmaps of static meshes. Every mesh gets a power of two lightmap resolution that gives lightmapTexelsPerMeter texels
+	per meter of its surface, clamped to min/maxLightmapResolution, and meshes without uv1 get lightmap uvs unwrapped
+	on the preparation threads (see JsonMesh::generateLightmapUvs). Without it, meshes use resolution 64.
+	*/
+	bool autoLightmaps = false;
+	float lightmapTexelsPerMeter = 8.0f;
+	int32 minLightmapResolution = 16;
+	int32 maxLightmapResolution = 1024;
+	/*
+	Static meshes are filled during resource import and built together once all resources are imported,
+	several at a time (see MeshBuilder::buildStaticMeshes), instead of one by one as they are created.
+	*/
+	bool deferStaticMeshBuild = false;
+	/*
+	Interactive import shows progress dialogs and message boxes, and imports a single scene into the current editor level.
+	Headless (commandlet) import only logs, and always imports scenes as new levels.
+	*/
+	bool interactive = true;
+	//Long package path assets are imported into. Empty means UnrealUtilities::getDefaultImportPath().
+	FString packageRoot;
+	//Record import stages with ImportProfiler and save trace/csv when import finishes. Commandlets turn it on.
+	bool profile = false;
+	//Sample process memory at the end of every profiled scope.
+	bool profileMemory = false;
+	//Directory for profiling results. Empty means <ProjectSaved>/ExodusImport.
+	FString profileDir;
+
+	int32 getNumParseThreads(int32 numTasks) const;
+	//lod starts from 1
+	float getLodTriangleFraction(int32 lod) const;
+	float getLodScreenSize(int32 lod) const;
+};
@@ -0,0 +1,203 @@
+#include "JsonImportPrivatePCH.h"
+#include "ImportProfiler.h"
+#include "JsonLog.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformTLS.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/JsonWriter.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+
+ImportProfiler& ImportProfiler::get(){
+	static ImportProfiler profiler;
+	return profiler;
+}
+
+void ImportProfiler::begin(bool trackMemory_){
+	FScopeLock lock(&eventLock);
+	events.Empty();
+	trackMemory = trackMemory_;
+	startTime = FPlatformTime::Seconds();
+	enabled = true;
+}
+
+void ImportProfiler::end(){
+	enabled = false;
+}
+
+void ImportProfiler::addEvent(const Event &event){
+	FScopeLock lock(&eventLock);
+	events.Add(event);
+}
+
+int32 ImportProfiler::getNumEvents() const{
+	FScopeLock lock(&eventLock);
+	return events.Num();
+}
+
+double ImportProfiler::getElapsedTime() const{
+	FScopeLock lock(&eventLock);
+	double endTime = startTime;
+	for(const auto &cur: events)
+		endTime = FMath::Max(endTime, cur.startTime + cur.duration);
+	return endTime - startTime;
+}
+
+void ImportProfiler::getStats(TArray<StageStats> &outStats, bool perAsset) const{
+	outStats.Empty();
+	{
+		FScopeLock lock(&eventLock);
+		TMap<FString, int32> statIndexes;
+		for(const auto &cur: events){
+			auto key = perAsset ? cur.asset + TEXT("|") + cur.stage: FString(cur.stage);
+			auto found = statIndexes.Find(key);
+			if (!found){
+				auto index = outStats.AddDefaulted();
+				if (perAsset)
+					outStats[index].asset = cur.asset;
+				outStats[index].stage = cur.stage;
+				found = &statIndexes.Add(key, index);
+			}
+			auto &dst = outStats[*found];
+			dst.calls++;
+			dst.totalTime += cur.duration;
+			dst.maxTime = FMath::Max(dst.maxTime, cur.duration);
+			dst.bytes += cur.bytes;
+			dst.elements += cur.elements;
+			dst.maxUsedMemory = FMath::Max(dst.maxUsedMemory, cur.usedMemory);
+			dst.peakMemory = FMath::Max(dst.peakMemory, cur.peakMemory);
+		}
+	}
+
+	outStats.Sort([](const StageStats &a, const StageStats &b){
+		return a.totalTime > b.totalTime;
+	});
+}
+
+bool ImportProfiler::saveChromeTrace(const FString &filename) const{
+	FScopeLock lock(&eventLock);
+	FString outString;
+	auto writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&outString);
+
+	writer->WriteObjectStart();
+	writer->WriteValue(TEXT("displayTimeUnit"), TEXT("ms"));
+	writer->WriteArrayStart(TEXT("traceEvents"));
+
+	writer->WriteObjectStart();
+	writer->WriteValue(TEXT("name"), TEXT("thread_name"));
+	writer->WriteValue(TEXT("ph"), TEXT("M"));
+	writer->WriteValue(TEXT("pid"), 1);
+	writer->WriteValue(TEXT("tid"), (int64)GGameThreadId);
+	writer->WriteObjectStart(TEXT("args"));
+	writer->WriteValue(TEXT("name"), TEXT("GameThread"));
+	writer->WriteObjectEnd();
+	writer->WriteObjectEnd();
+
+	for(const auto &cur: events){
+		writer->WriteObjectStart();
+		writer->WriteValue(TEXT("name"), cur.stage);
+		writer->WriteValue(TEXT("cat"), TEXT("import"));
+		writer->WriteValue(TEXT("ph"), TEXT("X"));
+		writer->WriteValue(TEXT("ts"), (cur.startTime - startTime) * 1000000.0);
+		writer->WriteValue(TEXT("dur"), cur.duration * 1000000.0);
+		writer->WriteValue(TEXT("pid"), 1);
+		writer->WriteValue(TEXT("tid"), (int64)cur.threadId);
+		writer->WriteObjectStart(TEXT("args"));
+		if (!cur.asset.IsEmpty())
+			writer->WriteValue(TEXT("asset"), cur.asset);
+		if (cur.bytes)
+			writer->WriteValue(TEXT("bytes"), cur.bytes);
+		if (cur.elements)
+			writer->WriteValue(TEXT("elements"), cur.elements);
+		writer->WriteObjectEnd();
+		writer->WriteObjectEnd();
+
+		if (!trackMemory)
+			continue;
+		writer->WriteObjectStart();
+		writer->WriteValue(TEXT("name"), TEXT("memory"));
+		writer->WriteValue(TEXT("ph"), TEXT("C"));
+		writer->WriteValue(TEXT("ts"), (cur.startTime + cur.duration - startTime) * 1000000.0);
+		writer->WriteValue(TEXT("pid"), 1);
+		writer->WriteObjectStart(TEXT("args"));
+		writer->WriteValue(TEXT("usedMB"), cur.usedMemory / (1024.0 * 1024.0));
+		writer->WriteObjectEnd();
+		writer->WriteObjectEnd();
+	}
+
+	writer->WriteArrayEnd();
+	writer->WriteObjectEnd();
+	writer->Close();
+
+	if (!FFileHelper::SaveStringToFile(outString, *filename)){
+		UE_LOG(JsonLog, Warning, TEXT("Could not save import trace \"%s\""), *filename);
+		return false;
+	}
+	return true;
+}
+
+static FString escapeCsvField(const FString &arg){
+	if (!arg.Contains(TEXT(",")) && !arg.Contains(TEXT("\"")))
+		return arg;
+	return FString::Printf(TEXT("\"%s\""), *arg.Replace(TEXT("\""), TEXT("\"\"")));
+}
+
+bool ImportProfiler::saveAssetCsv(const FString &filename) const{
+	TArray<StageStats> stats;
+	getStats(stats, true);
+
+	const double megabyte = 1024.0 * 1024.0;
+	FString outString = TEXT("asset,stage,calls,totalMs,maxMs,bytes,elements,usedMemoryMB\n");
+	for(const auto &cur: stats){
+		outString += FString::Printf(TEXT("%s,%s,%d,%.3f,%.3f,%lld,%lld,%.1f\n"),
+			*escapeCsvField(cur.asset), cur.stage, cur.calls, cur.totalTime * 1000.0, cur.maxTime * 1000.0, 
+			cur.bytes, cur.elements, cur.maxUsedMemory / megabyte);
+	}
+
+	if (!FFileHelper::SaveStringToFile(outString, *filename)){
+		UE_LOG(JsonLog, Warning, TEXT("Could not save import stats \"%s\""), *filename);
+		return false;
+	}
+	return true;
+}
+
+bool ImportProfiler::save(const FString &baseFilename) const{
+	auto traceFilename = baseFilename + TEXT(".trace.json");
+	auto csvFilename = baseFilename + TEXT(".csv");
+	bool result = saveChromeTrace(traceFilename);
+	result = saveAssetCsv(csvFilename) && result;
+	if (result){
+		UE_LOG(JsonLog, Log, TEXT("Import profile (%d events) saved to \"%s\" and \"%s\""), 
+			getNumEvents(), *traceFilename, *csvFilename);
+	}
+	return result;
+}
+
+ImportProfileScope::ImportProfileScope(const TCHAR *stage, const FString &asset){
+	auto &profiler = ImportProfiler::get();
+	if (!profiler.isEnabled())
+		return;
+	active = true;
+	event.stage = stage;
+	event.asset = asset;
+	event.threadId = FPlatformTLS::GetCurrentThreadId();
+	event.startTime = FPlatformTime::Seconds();
+}
+
+ImportProfileScope::~ImportProfileScope(){
+	finish();
+}
+
+void ImportProfileScope::finish(){
+	if (!active)
+		return;
+	active = false;
+	event.duration = FPlatformTime::Seconds() - event.startTime;
+	auto &profiler = ImportProfiler::get();
+	if (profiler.isTrackingMemory()){
+		auto memStats = FPlatformMemory::GetStats();
+		event.usedMemory = memStats.UsedPhysical;
+		event.peakMemory = memStats.PeakUsedPhysical;
+	}
+	profiler.addEvent(event);
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
+
+/*
+Collects timed import scopes from all threads.
+
+Events are recorded only between begin() and end(), so scopes left in the code cost a flag check otherwise.
+Results are written as a Chrome trace (chrome://tracing, Perfetto) and as a CSV aggregated per asset and stage.
+*/
+class ImportProfiler{
+public:
+	class Event{
+	public:
+		const TCHAR *stage = nullptr;
+		FString asset;
+		uint32 threadId = 0;
+		double startTime = 0.0;
+		double duration = 0.0;
+		int64 bytes = 0;
+		int64 elements = 0;
+		//process memory sampled when the scope ends, only when memory tracking is on
+		uint64 usedMemory = 0;
+		uint64 peakMemory = 0;
+	};
+
+	class StageStats{
+	public:
+		const TCHAR *stage = nullptr;
+		FString asset;
+		int32 calls = 0;
+		double totalTime = 0.0;
+		double maxTime = 0.0;
+		int64 bytes = 0;
+		int64 elements = 0;
+		uint64 maxUsedMemory = 0;
+		uint64 peakMemory = 0;
+	};
+protected:
+	FThreadSafeBool enabled;
+	bool trackMemory = false;
+	double startTime = 0.0;
+	mutable FCriticalSection eventLock;
+	TArray<Event> events;
+public:
+	static ImportProfiler& get();
+
+	bool isEnabled() const{
+		return enabled;
+	}
+	bool isTrackingMemory() const{
+		return trackMemory;
+	}
+	/*
+	Memory tracking queries process memory stats at the end of every scope, which is slow on some platforms.
+	*/
+	void begin(bool trackMemory_ = false);
+	void end();
+	void addEvent(const Event &event);
+	int32 getNumEvents() const;
+	double getElapsedTime() const;
+	/*
+	Aggregates events by stage, or by asset and stage. Sorted by total time, slowest first.
+	*/
+	void getStats(TArray<StageStats> &outStats, bool perAsset) const;
+
+	bool saveChromeTrace(const FString &filename) const;
+	bool saveAssetCsv(const FString &filename) const;
+	/*
+	Writes <baseFilename>.trace.json and <baseFilename>.csv
+	*/
+	bool save(const FString &baseFilename) const;
+};
+
+/*
+Measures wall time of the enclosing block. Bytes and element counts are optional.
+Stage name must be a string literal (or otherwise outlive the profiler).
+*/
+class ImportProfileScope{
+protected:
+	bool active = false;
+	ImportProfiler::Event event;
+public:
+	ImportProfileScope(const TCHAR *stage, const FString &asset = FString());
+	~ImportProfileScope();
+	//Records the scope before it goes out of scope.
+	void finish();
+
+	void setAsset(const FString &asset){
+		if (active)
+			event.asset = asset;
+	}
+	void addBytes(int64 bytes){
+		event.bytes += bytes;
+	}
+	void addElements(int64 elements){
+		event.elements += elements;
+	}
+};
+
+#define IMPORT_PROFILE_SCOPE(stage) ImportProfileScope PREPROCESSOR_JOIN(importProfileScope, __LINE__)(TEXT(stage))
+#define IMPORT_PROFILE_SCOPE_ASSET(stage, asset) ImportProfileScope PREPROCESSOR_JOIN(importProfileScope, __LINE__)(TEXT(stage), asset)
@@ -0,0 +1,130 @@
+#include "JsonImportPrivatePCH.h"
+#include "ImportScheduler.h"
+#include "ImportOptions.h"
+#include "JsonLog.h"
+#include "ImportProfiler.h"
+#include "Async/Async.h"
+#include "Misc/ScopedSlowTask.h"
+
+ImportNodeId ImportScheduler::addNode(const FString &name, PrepareFunc prepare, BuildFunc build){
+	auto result = nodes.AddDefaulted();
+	auto &node = nodes[result];
+	node.name = name;
+	node.prepare = prepare;
+	node.build = build;
+	return result;
+}
+
+void ImportScheduler::clear(){
+	nodes.Empty();
+}
+
+void ImportScheduler::validateDependencies(ImportNodeId nodeId){
+	auto &node = nodes[nodeId];
+	auto &deps = node.prepareResult.dependencies;
+	for(int i = deps.Num() - 1; i >= 0; i--){
+		auto depId = deps[i];
+		if ((depId < 0) || (depId >= nodeId)){
+			UE_LOG(JsonLog, Warning, TEXT("Import node %d (%s) has invalid dependency %d, ignoring it"),
+				nodeId, *node.name, depId);
+			deps.RemoveAtSwap(i);
+		}
+	}
+}
+
+bool ImportScheduler::canBuild(ImportNodeId nodeId, ImportNodeId firstUnbuilt) const{
+	const auto &node = nodes[nodeId];
+	for(auto depId: node.prepareResult.dependencies){
+		if (nodes[depId].state != NodeState::Built)
+			return false;
+	}
+
+	const auto orderGroup = node.prepareResult.orderGroup;
+	if (orderGroup < 0)
+		return true;
+
+	//Earlier nodes have to be prepared to know their group
+	for(ImportNodeId prevId = firstUnbuilt; prevId < nodeId; prevId++){
+		const auto &prevNode = nodes[prevId];
+		if (prevNode.state == NodeState::Built)
+			continue;
+		if (prevNode.state != NodeState::Prepared)
+			return false;
+		if (prevNode.prepareResult.orderGroup == orderGroup)
+			return false;
+	}
+	return true;
+}
+
+void ImportScheduler::run(const ImportOptions &options, FScopedSlowTask *progress){
+	const int32 numNodes = nodes.Num();
+	if (!numNodes)
+		return;
+
+	const int32 maxPreparing = options.getNumParseThreads(numNodes);
+	//limits memory held by prepared data waiting for dependencies
+	const int32 maxAhead = FMath::Max(maxPreparing * 2, options.meshParseBatchSize);
+
+	ImportNodeId nextLaunch = 0;
+	ImportNodeId firstUnbuilt = 0;
+	int32 numPreparing = 0;
+	int32 numPrepared = 0;
+	int32 numBuilt = 0;
+
+	UE_LOG(JsonLog, Log, TEXT("Running import scheduler: %d nodes, %d preparation threads"), numNodes, maxPreparing);
+
+	while(numBuilt < numNodes){
+		bool progressed = false;
+
+		while((nextLaunch < numNodes) && (numPreparing < maxPreparing) && ((numPreparing + numPrepared) < maxAhead)){
+			auto *node = &nodes[nextLaunch];
+			node->state = NodeState::Preparing;
+			node->prepareFuture = Async(EAsyncExecution::ThreadPool, [node](){
+				IMPORT_PROFILE_SCOPE_ASSET("prepare", node->name);
+				if (node->prepare)
+					node->prepare(node->prepareResult);
+			});
+			numPreparing++;
+			nextLaunch++;
+			progressed = true;
+		}
+
+		for(ImportNodeId nodeId = firstUnbuilt; nodeId < nextLaunch; nodeId++){
+			auto &node = nodes[nodeId];
+			if ((node.state == NodeState::Preparing) && node.prepareFuture.IsReady()){
+				node.prepareFuture = TFuture<void>();
+				validateDependencies(nodeId);
+				node.state = NodeState::Prepared;
+				numPreparing--;
+				numPrepared++;
+				progressed = true;
+			}
+		}
+
+		for(ImportNodeId nodeId = firstUnbuilt; nodeId < nextLaunch; nodeId++){
+			auto &node = nodes[nodeId];
+			if ((node.state != NodeState::Prepared) || !canBuild(nodeId, firstUnbuilt))
+				continue;
+
+			if (node.build){
+				IMPORT_PROFILE_SCOPE_ASSET("build", node.name);
+				node.build();
+			}
+			//Prepared data is owned by node callbacks, release it as early as possible.
+			node.prepare = nullptr;
+			node.build = nullptr;
+			node.state = NodeState::Built;
+			numPrepared--;
+			numBuilt++;
+			progressed = true;
+			if (progress)
+				progress->EnterProgressFrame(1.0f);
+		}
+
+		while((firstUnbuilt < numNodes) && (nodes[firstUnbuilt].state == NodeState::Built))
+			firstUnbuilt++;
+
+		if (!progressed)
+			FPlatformProcess::Sleep(0.001f);
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include <functional>
+
+class ImportOptions;
+class FScopedSlowTask;
+
+using ImportNodeId = int32;
+using ImportNodeIdArray = TArray<ImportNodeId>;
+
+/*
+Output of the preparation step of a node.
+*/
+class ImportNodePrepareResult{
+public:
+	//Nodes that must be built before this one. Only nodes added before this node are accepted.
+	ImportNodeIdArray dependencies;
+	/*
+	Nodes with the same non-negative order group are built in the order they were added.
+	Used when build steps share state that is created by whichever node is built first (skeletons, for example).
+	*/
+	int32 orderGroup = -1;
+};
+
+/*
+Dependency-driven executor for the resource import.
+
+Each node has a prepare step (runs on the thread pool, must not touch UObjects, reports dependencies)
+and a build step (runs on the game thread). Node is built as soon as it is prepared and all of its
+dependencies were built, independent nodes are prepared concurrently.
+
+Nodes should be added roughly in dependency order: the number of prepared-but-not-built nodes is limited,
+and the limit is applied in the order nodes were added.
+*/
+class ImportScheduler{
+public:
+	using PrepareFunc = std::function<void(ImportNodePrepareResult &outResult)>;
+	using BuildFunc = std::function<void()>;
+protected:
+	enum class NodeState{
+		Waiting,
+		Preparing,
+		Prepared,
+		Built
+	};
+
+	struct Node{
+		FString name;
+		PrepareFunc prepare;
+		BuildFunc build;
+		ImportNodePrepareResult prepareResult;
+		NodeState state = NodeState::Waiting;
+		TFuture<void> prepareFuture;
+	};
+
+	TArray<Node> nodes;
+
+	bool canBuild(ImportNodeId nodeId, ImportNodeId firstUnbuilt) const;
+	void validateDependencies(ImportNodeId nodeId);
+public:
+	ImportNodeId addNode(const FString &name, PrepareFunc prepare, BuildFunc build);
+	int32 getNumNodes() const{
+		return nodes.Num();
+	}
+
+	void run(const ImportOptions &options, FScopedSlowTask *progress = nullptr);
+	void clear();
+};
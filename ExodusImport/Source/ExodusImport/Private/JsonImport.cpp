@@ -56,6 +56,9 @@ static const FName JsonImportTabName("JsonImport");
 
 void FJsonImportModule::StartupModule(){
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+	//Commandlet (see UExodusImportCommandlet) has no editor UI to extend.
+	if (IsRunningCommandlet())
+		return;
 	LOCTEXT("Importing textures", "Importing textures");
 	FJsonImportStyle::Initialize();
 	FJsonImportStyle::ReloadTextures();
@@ -107,6 +110,8 @@ void FJsonImportModule::StartupModule(){
 void FJsonImportModule::ShutdownModule(){
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+	if (IsRunningCommandlet())
+		return;
 	FJsonImportStyle::Shutdown();
 
 	FJsonImportCommands::Unregister();
@@ -3,6 +3,15 @@
 #include "JsonImporter.h"
 #include "UnrealUtilities.h"
 #include "builders/JointBuilder.h"
+#include "builders/InstancedMeshBuilder.h"
+#include "builders/MergedMeshBuilder.h"
+#include "MeshCollisionGenerator.h"
+#include "LightmapUvGenerator.h"
+#include "Misc/PackageName.h"
+#include "Misc/ScopedSlowTask.h"
+#include "ImportProfiler.h"
+#include "Hash/CityHash.h"
+#include "Async/ParallelFor.h"
 
 #include "LocTextNamespace.h"
 
@@ -11,171 +20,705 @@
 using namespace JsonObjects;
 using namespace UnrealUtilities;
 
+FString JsonImporter::getPackageRoot() const{
+	if (!options.packageRoot.IsEmpty())
+		return options.packageRoot;
+	return getDefaultImportPath();
+}
+
 FString JsonImporter::getProjectImportPath() const{
-	auto result = getDefaultImportPath();
+	auto result = getPackageRoot();
 	if (result.Len() && sourceBaseName.Len())
 		result = FPaths::Combine(*result, *sourceBaseName);
 	return result;
 }
 
-void JsonImporter::importTerrainData(JsonObjPtr jsonData, JsonId terrainId, const FString &rootPath){
-	//
-	JsonTerrainData terrainData;
-	terrainData.load(jsonData);
+void JsonImporter::ResourceNodeMap::clear(){
+	textures.Empty();
+	cubemaps.Empty();
+	materials.Empty();
+	skeletons.Empty();
+	meshes.Empty();
+	terrains.Empty();
+	byKey.Empty();
+}
 
-	terrainDataMap.Add(terrainId, terrainData);
+void JsonImporter::ResourceNodeMap::addNode(ImportNodeIdArray &nodes, const FString &key, ImportNodeId nodeId){
+	nodes.Add(nodeId);
+	byKey.Add(key, nodeId);
 }
 
-void JsonImporter::loadTerrains(const StringArray &terrains){
-	FScopedSlowTask terProgress(terrains.Num(), LOCTEXT("Importing terrains", "Importing terrains"));
-	terProgress.MakeDialog();
-	JsonId id = 0;
-	for(auto curFilename: terrains){
-		auto obj = loadExternResourceFromFile(curFilename);//cur->AsObject();
-		auto curId= id;
-		id++;
-		if (!obj.IsValid())
-			continue;
+void JsonImporter::ResourceNodeMap::addDependency(ImportNodePrepareResult &result, const ImportNodeIdArray &nodes, JsonId resourceId){
+	if ((resourceId < 0) || (resourceId >= nodes.Num()))
+		return;
+	result.dependencies.AddUnique(nodes[resourceId]);
+}
 
-		importTerrainData(obj, curId, assetRootPath);
-		terProgress.EnterProgressFrame(1.0f);
+void JsonImporter::scheduleTerrains(ImportScheduler &scheduler, const StringArray &terrains){
+	for(JsonId curId = 0; curId < terrains.Num(); curId++){
+		const auto key = terrains[curId];
+		auto prepared = makePreparedResource<JsonTerrainData>();
+		auto nodeId = scheduler.addNode(key, 
+			[this, key, prepared](ImportNodePrepareResult &result){
+				auto obj = loadExternResourceFromFile(key);
+				if (!obj.IsValid())
+					return;
+				auto &terrainData = prepared->data;
+				terrainData.load(obj);
+				prepared->loaded = true;
+
+				for(const auto &detail: terrainData.detailPrototypes){
+					ResourceNodeMap::addDependency(result, resourceNodes.meshes, detail.detailMeshId);
+					ResourceNodeMap::addDependency(result, resourceNodes.textures, detail.textureId);
+					for(auto matId: detail.detailMeshMaterials)
+						ResourceNodeMap::addDependency(result, resourceNodes.materials, matId);
+				}
+				for(const auto &tree: terrainData.treePrototypes){
+					ResourceNodeMap::addDependency(result, resourceNodes.meshes, tree.meshId.toIndex());
+					for(auto matId: tree.materials)
+						ResourceNodeMap::addDependency(result, resourceNodes.materials, matId);
+				}
+				for(const auto &splat: terrainData.splatPrototypes){
+					ResourceNodeMap::addDependency(result, resourceNodes.textures, splat.textureId);
+					ResourceNodeMap::addDependency(result, resourceNodes.textures, splat.normalMapId);
+				}
+			},
+			[this, curId, prepared](){
+				if (prepared->loaded)
+					terrainDataMap.Add(curId, prepared->data);
+			}
+		);
+		resourceNodes.addNode(resourceNodes.terrains, key, nodeId);
 	}
-
 }
 
-void JsonImporter::loadCubemaps(const StringArray &cubemaps){
-	FScopedSlowTask texProgress(cubemaps.Num(), LOCTEXT("Importing cubemaps", "Importing cubemaps"));
-	texProgress.MakeDialog();
-	UE_LOG(JsonLog, Log, TEXT("Processing textures"));
-	for(auto curFilename: cubemaps){
-		auto obj = loadExternResourceFromFile(curFilename);
-		if (!obj.IsValid())
-			continue;
-		importCubemap(obj, assetRootPath);
-		texProgress.EnterProgressFrame(1.0f);
+void JsonImporter::scheduleCubemaps(ImportScheduler &scheduler, const StringArray &cubemaps){
+	for(int i = 0; i < cubemaps.Num(); i++){
+		const auto key = cubemaps[i];
+		auto prepared = makePreparedResource<JsonCubemap>();
+		auto nodeId = scheduler.addNode(key, 
+			[this, key, prepared](ImportNodePrepareResult &result){
+				auto obj = loadExternResourceFromFile(key);
+				if (!obj.IsValid())
+					return;
+				prepared->data.load(obj);
+				prepared->loaded = true;
+				prepared->hash = hashExternResource(key, {FPaths::Combine(*assetRootPath, *prepared->data.rawPath)});
+			},
+			[this, key, prepared](){
+				if (!prepared->loaded || reuseManifestEntry(key, prepared->hash))
+					return;
+				manifest.beginEntry(key, prepared->hash, StringArray());
+				importCubemap(prepared->data, assetRootPath, manifest.hasPrevEntry(key));
+				manifest.endEntry();
+			}
+		);
+		resourceNodes.addNode(resourceNodes.cubemaps, key, nodeId);
 	}
 }
 
-void JsonImporter::loadTextures(const StringArray & textures){
-	FScopedSlowTask texProgress(textures.Num(), LOCTEXT("Importing textures", "Importing textures"));
-	texProgress.MakeDialog();
-	UE_LOG(JsonLog, Log, TEXT("Processing textures"));
-	for(auto curFilename: textures){
-		auto obj = loadExternResourceFromFile(curFilename);
-		if (!obj.IsValid())
-			continue;
-		importTexture(obj, assetRootPath);
-		texProgress.EnterProgressFrame(1.0f);
+void JsonImporter::scheduleTextures(ImportScheduler &scheduler, const StringArray &textures){
+	for(int i = 0; i < textures.Num(); i++){
+		const auto key = textures[i];
+		auto prepared = makePreparedResource<JsonTexture>();
+		auto nodeId = scheduler.addNode(key, 
+			[this, key, prepared](ImportNodePrepareResult &result){
+				auto obj = loadExternResourceFromFile(key);
+				if (!obj.IsValid())
+					return;
+				prepared->data.load(obj);
+				prepared->loaded = true;
+				prepared->hash = hashExternResource(key, {FPaths::Combine(*assetRootPath, *prepared->data.path)});
+			},
+			[this, key, prepared](){
+				if (!prepared->loaded || reuseManifestEntry(key, prepared->hash))
+					return;
+				manifest.beginEntry(key, prepared->hash, StringArray());
+				importTexture(prepared->data, assetRootPath, manifest.hasPrevEntry(key));
+				manifest.endEntry();
+			}
+		);
+		resourceNodes.addNode(resourceNodes.textures, key, nodeId);
 	}
 }
 
-void JsonImporter::loadSkeletons(const StringArray &skeletons){
-	FScopedSlowTask skelProgress(skeletons.Num(), LOCTEXT("Importing skeletons", "Importing skeletons"));
-	skelProgress.MakeDialog();
-	UE_LOG(JsonLog, Log, TEXT("Processing skeletons"));
-
+void JsonImporter::scheduleSkeletons(ImportScheduler &scheduler, const StringArray &skeletons){
 	jsonSkeletons.Empty();
 
 	for(int id = 0; id < skeletons.Num(); id++){
-		const auto& curFilename = skeletons[id];
-		auto obj = loadExternResourceFromFile(curFilename);
-		if (!obj.IsValid()){
-			continue;
-		}
+		const auto key = skeletons[id];
+		auto prepared = makePreparedResource<JsonSkeleton>();
+		auto nodeId = scheduler.addNode(key, 
+			[this, id, key, prepared](ImportNodePrepareResult &result){
+				auto obj = loadExternResourceFromFile(key);
+				if (!obj.IsValid())
+					return;
+				prepared->data.load(obj);
+				prepared->loaded = true;
+				prepared->hash = hashExternResource(key) + getSkeletonMergeKey(id);
+			},
+			[this, id, key, prepared](){
+				if (!prepared->loaded)
+					return;
+
+				const auto &jsonSkel = prepared->data;
+				jsonSkeletons.Add(id, jsonSkel);
+				UE_LOG(JsonLog, Log, TEXT("Loaded json skeleotn #%d (%s)"), jsonSkel.id, *jsonSkel.name);
+
+				//Skeleton assets are created by skinned meshes, skeleton entry only tracks changes for dependents.
+				if (!reuseManifestEntry(key, prepared->hash)){
+					manifest.beginEntry(key, prepared->hash, StringArray());
+					manifest.endEntry();
+				}
+			}
+		);
+		resourceNodes.addNode(resourceNodes.skeletons, key, nodeId);
+	}
+}
 
-		JsonSkeleton jsonSkel(obj);
-		jsonSkeletons.Add(id, jsonSkel);
-		UE_LOG(JsonLog, Log, TEXT("Loaded json skeleotn #%d (%s)"), jsonSkel.id, *jsonSkel.name);
+void JsonImporter::scheduleMaterials(ImportScheduler &scheduler, const StringArray &materials){
+	jsonMaterials.Empty();
+	jsonMaterials.SetNum(materials.Num());
+
+	for(int32 curId = 0; curId < materials.Num(); curId++){
+		const auto key = materials[curId];
+		auto prepared = makePreparedResource<JsonMaterial>();
+		auto nodeId = scheduler.addNode(key, 
+			[this, key, prepared](ImportNodePrepareResult &result){
+				auto obj = loadExternResourceFromFile(key);
+				if (!obj.IsValid())
+					return;
+				prepared->data.load(obj);
+				prepared->loaded = true;
+				prepared->hash = hashExternResource(key);
+				for(auto texId: prepared->data.getTextureIds())
+					ResourceNodeMap::addDependency(result, resourceNodes.textures, texId);
+			},
+			[this, curId, key, prepared](){
+				if (!prepared->loaded)
+					return;
+
+				const JsonMaterial &jsonMat = prepared->data;
+				jsonMaterials[curId] = jsonMat;
+				if (reuseManifestEntry(key, prepared->hash))
+					return;
+
+				StringArray dependencies;
+				for(auto texId: jsonMat.getTextureIds()){
+					auto texKey = getExternResourceKey(externResources.textures, texId);
+					if (!texKey.IsEmpty())
+						dependencies.Add(texKey);
+				}
+				manifest.beginEntry(key, prepared->hash, dependencies);
+
+				//importMasterMaterial(obj, curId);
+				if (!jsonMat.supportedShader){
+					UE_LOG(JsonLog, Warning, TEXT("Material \"%s\"(id: %d) is marked as having unsupported shader \"%s\""),
+						*jsonMat.name, jsonMat.id, *jsonMat.shader);
+				}
+
+				auto matInst = materialBuilder.importMaterialInstance(jsonMat, this);
+				if (matInst){
+					//registerMaterialInstancePath(curId, matInst->GetPathName());
+					registerMaterialInstancePath(jsonMat.id, matInst->GetPathName());
+				}
+
+				manifest.endEntry();
+			}
+		);
+		resourceNodes.addNode(resourceNodes.materials, key, nodeId);
+	}
+}
 
-		skelProgress.EnterProgressFrame(1.0f);
+StringArray JsonImporter::getMeshDependencyKeys(const JsonMesh &jsonMesh) const{
+	StringArray result;
+	for(auto matId: jsonMesh.materials){
+		auto matKey = getExternResourceKey(externResources.materials, matId);
+		if (!matKey.IsEmpty())
+			result.AddUnique(matKey);
 	}
+	auto skelKey = getExternResourceKey(externResources.skeletons, jsonMesh.defaultSkeletonId);
+	if (!skelKey.IsEmpty())
+		result.Add(skelKey);
+	auto mergedSkelKey = getExternResourceKey(externResources.skeletons, getMergedSkeletonId(jsonMesh.defaultSkeletonId));
+	if (!mergedSkelKey.IsEmpty())
+		result.AddUnique(mergedSkelKey);
+	return result;
 }
 
-void JsonImporter::loadMaterials(const StringArray &materials){
-	FScopedSlowTask matProgress(materials.Num(), LOCTEXT("Importing materials", "Importing materials"));
-	matProgress.MakeDialog();
-	UE_LOG(JsonLog, Log, TEXT("Processing materials"));
-	jsonMaterials.Empty();
-	int32 matId = 0;
-	for(auto curFilename: materials){
-		auto obj = loadExternResourceFromFile(curFilename);
-		auto curId = matId;
-		matId++;//hmm.... I should probably axe this?
-		if (!obj.IsValid())
-			continue;
+void JsonImporter::prepareMeshGeometry(JsonMesh &jsonMesh) const{
+	//Lightmap uvs come first, so welding and lods work with the split vertices
+	if (options.autoLightmaps && !jsonMesh.hasBoneWeights() && !jsonMesh.hasBlendShapes()){
+		//Unity units are meters
+		jsonMesh.lightmapResolution = LightmapUvGenerator::computeResolution(jsonMesh.computeSurfaceArea(), 
+			options.lightmapTexelsPerMeter, options.minLightmapResolution, options.maxLightmapResolution);
+		if (jsonMesh.uv1.Num() == 0)
+			jsonMesh.generateLightmapUvs(jsonMesh.lightmapResolution);
+	}
+	if (options.optimizeMeshes)
+		jsonMesh.optimizeForRendering(options.optimizeMeshOverdraw);
+	const bool skeletal = jsonMesh.hasBoneWeights() || jsonMesh.hasBlendShapes();
+	const int32 numLods = skeletal ? options.numSkeletalMeshLods: options.numStaticMeshLods;
+	if (numLods <= 0)
+		return;
+	TArray<float> triangleFractions, screenSizes;
+	for(int32 lod = 1; lod <= numLods; lod++){
+		triangleFractions.Add(options.getLodTriangleFraction(lod));
+		screenSizes.Add(options.getLodScreenSize(lod));
+	}
+	//Bone reduction happens when skeletal lods are built, it needs the skeleton
+	const auto dominantBones = jsonMesh.getDominantBones();
+	jsonMesh.generateLods(triangleFractions, screenSizes, options.optimizeMeshes, dominantBones.Num() ? &dominantBones: nullptr);
+}
+
+FString JsonImporter::getMeshSettingsKey() const{
+	FString result;
+	if (options.optimizeMeshes)
+		result += options.optimizeMeshOverdraw ? TEXT("_optOverdraw"): TEXT("_opt");
+	for(int32 lod = 1; lod <= options.numStaticMeshLods; lod++)
+		result += FString::Printf(TEXT("_lod%d:%f:%f"), lod, options.getLodTriangleFraction(lod), options.getLodScreenSize(lod));
+	for(int32 lod = 1; lod <= options.numSkeletalMeshLods; lod++){
+		result += FString::Printf(TEXT("_skelLod%d:%f:%f:%f"), lod, options.getLodTriangleFraction(lod), options.getLodScreenSize(lod), 
+			options.lodBoneSizeFraction);
+	}
+	if (options.autoLightmaps){
+		result += FString::Printf(TEXT("_lm%f:%d:%d"), 
+			options.lightmapTexelsPerMeter, options.minLightmapResolution, options.maxLightmapResolution);
+	}
+	return result;
+}
+
+void JsonImporter::prepareMeshCollision(JsonMesh &jsonMesh) const{
+	jsonMesh.convexHulls.Empty();
+	if (!options.useCollisionPolicy){
+		jsonMesh.simpleCollision = MeshSimpleCollision::KDop18;
+		return;
+	}
+	if (jsonMesh.hasBoneWeights() || jsonMesh.hasBlendShapes())
+		return;
+
+	const bool referenced = jsonMesh.convexCollider || jsonMesh.triangleCollider || colliderMeshIds.Contains(jsonMesh.id.toIndex());
+	if (!referenced){
+		jsonMesh.simpleCollision = MeshSimpleCollision::None;
+		return;
+	}
+	if (jsonMesh.triangleCollider && !jsonMesh.convexCollider){
+		jsonMesh.simpleCollision = MeshSimpleCollision::Complex;
+		return;
+	}
 
-		JsonMaterial jsonMat(obj);
-		jsonMaterials.Add(jsonMat);
-		//importMasterMaterial(obj, curId);
-		if (!jsonMat.supportedShader){
-			UE_LOG(JsonLog, Warning, TEXT("Material \"%s\"(id: %d) is marked as having unsupported shader \"%s\""),
-				*jsonMat.name, jsonMat.id, *jsonMat.shader);
+	IntArray indices;
+	for(const auto &subMesh: jsonMesh.subMeshes)
+		indices.Append(subMesh.triangles);
+	const int32 numTriangles = indices.Num() / 3;
+
+	if (!jsonMesh.convexCollider){
+		if ((numTriangles <= options.collisionBoxMaxTriangles) && (MeshCollisionGenerator::getBoundsFillRatio(jsonMesh.verts, indices) > 0.9f))
+			jsonMesh.simpleCollision = MeshSimpleCollision::Box;
+		else if ((numTriangles >= options.collisionSphereMinTriangles) && (MeshCollisionGenerator::getRadiusDeviation(jsonMesh.verts) < 0.05f))
+			jsonMesh.simpleCollision = MeshSimpleCollision::Sphere;
+		else
+			jsonMesh.simpleCollision = MeshSimpleCollision::KDop18;
+		return;
+	}
+
+	jsonMesh.simpleCollision = MeshSimpleCollision::ConvexHulls;
+	const auto cacheKey = FString::Printf(TEXT("%s_%d"), *jsonMesh.getGeometryHash(), options.maxConvexHulls);
+	{
+		FScopeLock lock(&convexHullCacheLock);
+		auto found = convexHullCache.Find(cacheKey);
+		if (found){
+			jsonMesh.convexHulls = *found;
+			return;
 		}
+	}
+
+	{
+		ImportProfileScope profileScope(TEXT("MeshCollisionGenerator::decomposeConvex"), jsonMesh.name);
+		profileScope.addElements(numTriangles);
+		const int32 minHullTriangles = 4;
+		const float maxConcavity = 0.02f;
+		MeshCollisionGenerator::decomposeConvex(jsonMesh.verts, indices, options.maxConvexHulls, minHullTriangles, maxConcavity, jsonMesh.convexHulls);
+	}
+	FScopeLock lock(&convexHullCacheLock);
+	convexHullCache.Add(cacheKey, jsonMesh.convexHulls);
+}
 
-		auto matInst = materialBuilder.importMaterialInstance(jsonMat, this);
-		if (matInst){
-			//registerMaterialInstancePath(curId, matInst->GetPathName());
-			registerMaterialInstancePath(jsonMat.id, matInst->GetPathName());
+FString JsonImporter::getMeshCollisionKey(JsonId meshId) const{
+	if (!options.useCollisionPolicy)
+		return FString();
+	return FString::Printf(TEXT("_col%d:%d:%d:%d"), colliderMeshIds.Contains(meshId) ? 1: 0,
+		options.collisionBoxMaxTriangles, options.collisionSphereMinTriangles, options.maxConvexHulls);
+}
+
+void JsonImporter::collectColliderMeshIds(const JsonExternResourceList &externRes){
+	colliderMeshIds.Empty();
+	if (!options.useCollisionPolicy)
+		return;
+	IMPORT_PROFILE_SCOPE("collectColliderMeshIds");
+
+	/*
+	Scenes and prefabs are imported later, so only collider mesh ids are read here, 
+	without building game objects, and files are parsed in parallel.
+	*/
+	StringArray files = externRes.scenes;
+	files.Append(externRes.prefabs);
+	TArray<IdSet> fileMeshIds;
+	fileMeshIds.SetNum(files.Num());
+	ParallelFor(files.Num(), [&](int32 fileIndex){
+		auto data = loadExternResourceFromFile(files[fileIndex]);
+		if (!data.IsValid())
+			return;
+		const JsonValPtrs *objects = nullptr;
+		if (!data->TryGetArrayField(TEXT("objects"), objects) || !objects)
+			return;
+		for(const auto &objVal: *objects){
+			const auto obj = objVal.IsValid() ? objVal->AsObject(): JsonObjPtr();
+			if (!obj.IsValid())
+				continue;
+			TArray<JsonCollider> colliders;
+			getJsonObjArray(obj, colliders, "colliders", true);
+			for(const auto &collider: colliders){
+				if (collider.isMeshCollider() && collider.meshId.isValid())
+					fileMeshIds[fileIndex].Add(collider.meshId.toIndex());
+			}
 		}
+	});
+	for(const auto &cur: fileMeshIds)
+		colliderMeshIds.Append(cur);
+	UE_LOG(JsonLog, Log, TEXT("%d meshes are used by mesh colliders"), colliderMeshIds.Num());
+}
+
+/*
+Bone of a skeleton identified by its name and its parent's name, case-insensitive like FName.
+A skeleton is compatible with another one when all of its bones are found there.
+*/
+static uint64 hashSkeletonBone(const JsonSkeleton &skeleton, int32 boneIndex){
+	const auto &bone = skeleton.bones[boneIndex];
+	const auto parentId = bone.parentId;
+	const auto parentName = ((parentId >= 0) && (parentId < skeleton.bones.Num())) ? skeleton.bones[parentId].name: FString();
+	const auto key = (bone.name + TEXT("\n") + parentName).ToLower();
+	return CityHash64((const char*)*key, key.Len() * sizeof(TCHAR));
+}
 
-		//importMaterialInstance(jsonMat, curId);
-		matProgress.EnterProgressFrame(1.0f);
+void JsonImporter::buildSkeletonMergeMap(const JsonExternResourceList &externRes){
+	skeletonMergeMap.Empty();
+	if (!options.mergeSkeletons || (externRes.skeletons.Num() < 2))
+		return;
+	IMPORT_PROFILE_SCOPE("buildSkeletonMergeMap");
+
+	struct SkeletonSignature{
+		JsonId id = -1;
+		//Sorted, without duplicates
+		TArray<uint64> boneHashes;
+	};
+	TArray<SkeletonSignature> signatures;
+	signatures.SetNum(externRes.skeletons.Num());
+	ParallelFor(externRes.skeletons.Num(), [&](int32 id){
+		auto data = loadExternResourceFromFile(externRes.skeletons[id]);
+		if (!data.IsValid())
+			return;
+		JsonSkeleton skeleton(data);
+		auto &signature = signatures[id];
+		signature.id = id;
+		signature.boneHashes.SetNumUninitialized(skeleton.bones.Num());
+		for(int32 boneIndex = 0; boneIndex < skeleton.bones.Num(); boneIndex++)
+			signature.boneHashes[boneIndex] = hashSkeletonBone(skeleton, boneIndex);
+		signature.boneHashes.Sort();
+		for(int32 i = signature.boneHashes.Num() - 1; i > 0; i--){
+			if (signature.boneHashes[i] == signature.boneHashes[i - 1])
+				signature.boneHashes.RemoveAt(i);
+		}
+	});
+	signatures.RemoveAll([](const SkeletonSignature &signature){
+		return (signature.id < 0) || (signature.boneHashes.Num() == 0);
+	});
+
+	//Largest skeletons come first and keep their assets, smaller ones join the first skeleton that contains them
+	signatures.Sort([](const SkeletonSignature &a, const SkeletonSignature &b){
+		if (a.boneHashes.Num() != b.boneHashes.Num())
+			return a.boneHashes.Num() > b.boneHashes.Num();
+		return a.id < b.id;
+	});
+	auto isSubset = [](const TArray<uint64> &subset, const TArray<uint64> &superset){
+		if (subset.Num() > superset.Num())
+			return false;
+		int32 supIndex = 0;
+		for(auto hash: subset){
+			while((supIndex < superset.Num()) && (superset[supIndex] < hash))
+				supIndex++;
+			if ((supIndex >= superset.Num()) || (superset[supIndex] != hash))
+				return false;
+		}
+		return true;
+	};
+
+	TArray<int32> keptSignatures;
+	for(int32 i = 0; i < signatures.Num(); i++){
+		const auto &cur = signatures[i];
+		bool merged = false;
+		for(auto keptIndex: keptSignatures){
+			const auto &kept = signatures[keptIndex];
+			if (!isSubset(cur.boneHashes, kept.boneHashes))
+				continue;
+			skeletonMergeMap.Add(cur.id, kept.id);
+			UE_LOG(JsonLog, Log, TEXT("Skeleton %d (%d bones) is merged into skeleton %d (%d bones)"), 
+				cur.id, cur.boneHashes.Num(), kept.id, kept.boneHashes.Num());
+			merged = true;
+			break;
+		}
+		if (!merged)
+			keptSignatures.Add(i);
 	}
+	UE_LOG(JsonLog, Log, TEXT("%d skeletons merged into %d"), signatures.Num(), keptSignatures.Num());
 }
 
-void JsonImporter::loadMeshes(const StringArray &meshes){
-	FScopedSlowTask meshProgress(meshes.Num(), LOCTEXT("Importing materials", "Importing meshes"));
-	meshProgress.MakeDialog();
-	UE_LOG(JsonLog, Log, TEXT("Processing meshes"));
-	int32 meshId = 0;
-	for(auto curFilename: meshes){
-		auto obj = loadExternResourceFromFile(curFilename);
-		auto curId = meshId;
-		meshId++;//and this one too...
-		if (!obj.IsValid())
-			continue;
-		importMesh(obj, curId);
-		meshProgress.EnterProgressFrame(1.0f);
+JsonId JsonImporter::getMergedSkeletonId(JsonId id) const{
+	auto found = skeletonMergeMap.Find(id);
+	return found ? *found: id;
+}
+
+FString JsonImporter::getSkeletonMergeKey(JsonId id) const{
+	const auto mergedId = getMergedSkeletonId(id);
+	if (mergedId == id)
+		return FString();
+	return FString::Printf(TEXT("_merged:%s"), *getExternResourceKey(externResources.skeletons, mergedId));
+}
+
+void JsonImporter::scheduleMeshes(ImportScheduler &scheduler, const StringArray &meshes){
+	for(int32 curId = 0; curId < meshes.Num(); curId++){
+		const auto key = meshes[curId];
+		auto prepared = makePreparedResource<JsonMesh>();
+		auto nodeId = scheduler.addNode(key, 
+			[this, curId, key, prepared](ImportNodePrepareResult &result){
+				prepared->hash = hashExternResource(key, {JsonBinaryMesh::getSidecarPath(FPaths::Combine(sourceExternDataPath, key))});
+				prepared->hash += getMeshSettingsKey() + getMeshCollisionKey(curId);
+
+				//Unchanged meshes are not parsed, dependencies are taken from the previous run.
+				auto prevEntry = options.incrementalImport ? manifest.findPrevEntry(key): nullptr;
+				if (prevEntry && (prevEntry->hash == prepared->hash)){
+					prepared->skipParse = true;
+					for(const auto &depKey: prevEntry->dependencies){
+						auto depNode = resourceNodes.byKey.Find(depKey);
+						if (depNode)
+							result.dependencies.AddUnique(*depNode);
+						auto skelIndex = externResources.skeletons.IndexOfByKey(depKey);
+						if (skelIndex != INDEX_NONE)
+							result.orderGroup = getMergedSkeletonId(skelIndex);
+					}
+					return;
+				}
+
+				prepared->loaded = loadExternMeshFromFile(prepared->data, key);
+				if (!prepared->loaded)
+					return;
+				//Hashed after optimization, so meshes rebuilt on the game thread produce the same hash
+				prepareMeshGeometry(prepared->data);
+				if (options.deduplicateMeshes || options.useCollisionPolicy)
+					prepared->data.geometryHash = prepared->data.computeGeometryHash();
+				prepareMeshCollision(prepared->data);
+
+				const auto &jsonMesh = prepared->data;
+				for(auto matId: jsonMesh.materials)
+					ResourceNodeMap::addDependency(result, resourceNodes.materials, matId);
+				ResourceNodeMap::addDependency(result, resourceNodes.skeletons, jsonMesh.defaultSkeletonId);
+				ResourceNodeMap::addDependency(result, resourceNodes.skeletons, getMergedSkeletonId(jsonMesh.defaultSkeletonId));
+				//Meshes sharing a skeleton are built in order, the first one creates the skeleton asset.
+				if (jsonMesh.hasBoneWeights() || jsonMesh.hasBlendShapes())
+					result.orderGroup = FMath::Max(getMergedSkeletonId(jsonMesh.defaultSkeletonId), 0);
+			},
+			[this, curId, key, prepared](){
+				if (prepared->skipParse){
+					if (reuseManifestEntry(key, prepared->hash))
+						return;
+					//assets went missing, the mesh has to be rebuilt after all
+					prepared->loaded = loadExternMeshFromFile(prepared->data, key);
+					if (prepared->loaded){
+						prepareMeshGeometry(prepared->data);
+						prepareMeshCollision(prepared->data);
+					}
+				}
+				if (!prepared->loaded)
+					return;
+
+				UE_LOG(JsonLog, Log, TEXT("Importing mesh %d"), curId);
+				manifest.beginEntry(key, prepared->hash, getMeshDependencyKeys(prepared->data));
+				importMesh(prepared->data, curId);
+				manifest.endEntry();
+			}
+		);
+		resourceNodes.addNode(resourceNodes.meshes, key, nodeId);
 	}
 }
 
 void JsonImporter::loadObjects(const TArray<JsonGameObject> &objects, ImportWorkData &importData){
 	FScopedSlowTask objProgress(objects.Num(), LOCTEXT("Importing objects", "Importing objects"));
-	objProgress.MakeDialog();
+	if (options.interactive)
+		objProgress.MakeDialog();
 	UE_LOG(JsonLog, Log, TEXT("Import objects"));
+
+	IdSet replacedObjects;
+	if (options.instanceStaticMeshes)
+		InstancedMeshBuilder::processInstancedMeshes(importData, objects, replacedObjects, this);
+	if (options.mergeStaticMeshes)
+		MergedMeshBuilder::processMergedMeshes(importData, objects, replacedObjects, this);
+
 	//int32 objId = 0;
 	for(const auto &curObj: objects){
 		//auto curId = objId;
 		//objId++;
-		importObject(curObj, importData);
+		if (!replacedObjects.Contains(curObj.id))
+			importObject(curObj, importData);
 		objProgress.EnterProgressFrame(1.0f);
 	}
 
 	JointBuilder jointBuilder;
-	jointBuilder.processPhysicsJoints(objects, importData);
+	jointBuilder.processPhysicsJoints(objects, importData, options.interactive);
 	processDelayedAnimators(objects, importData);
 }
 
 void JsonImporter::importResources(const JsonExternResourceList &externRes){
+	IMPORT_PROFILE_SCOPE("importResources");
 	assetCommonPath = findCommonPath(externRes.resources);
 
-	loadTextures(externRes.textures);
-	loadCubemaps(externRes.cubemaps);
-	loadMaterials(externRes.materials);
-	loadSkeletons(externRes.skeletons);
-	loadMeshes(externRes.meshes);
+	/*
+	Nodes are added in dependency order: material -> textures, mesh -> materials/skeleton, 
+	terrain -> meshes/materials/textures. Each node is built as soon as its dependencies are built.
+	*/
+	ImportScheduler scheduler;
+	resourceNodes.clear();
+	scheduleTextures(scheduler, externRes.textures);
+	scheduleCubemaps(scheduler, externRes.cubemaps);
+	scheduleMaterials(scheduler, externRes.materials);
+	scheduleSkeletons(scheduler, externRes.skeletons);
+	scheduleMeshes(scheduler, externRes.meshes);
+	scheduleTerrains(scheduler, externRes.terrains);
+
+	{
+		FScopedSlowTask progress(scheduler.getNumNodes(), LOCTEXT("Importing resources", "Importing resources"));
+		if (options.interactive)
+			progress.MakeDialog();
+		scheduler.run(options, &progress);
+	}
+	resourceNodes.clear();
+	buildDeferredStaticMeshes();
+
 	importPrefabs(externRes.prefabs);
-	loadTerrains(externRes.terrains);
 
 	//loadAnimClipsDebug(externRes.animationClips);
 	//loadAnimatorsDebug(externRes.animatorControllers); 
 }
 
 JsonObjPtr JsonImporter::loadExternResourceFromFile(const FString &filename) const{
+	ImportProfileScope profileScope(TEXT("loadExternResourceFromFile"), filename);
 	auto fullPath = FPaths::Combine(sourceExternDataPath, filename);
+	if (ImportProfiler::get().isEnabled())
+		profileScope.addBytes(FMath::Max(IFileManager::Get().FileSize(*fullPath), (int64)0));
 	return loadJsonFromFile(fullPath);
 }
 
+void JsonImporter::saveImportProfile() const{
+	auto &profiler = ImportProfiler::get();
+	if (!profiler.isEnabled())
+		return;
+	profiler.end();
+
+	auto profileDir = options.profileDir;
+	if (profileDir.IsEmpty())
+		profileDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ExodusImport"));
+	auto baseName = FString::Printf(TEXT("%s_%s"), *sourceBaseName, *genTimestamp());
+	profiler.save(FPaths::Combine(profileDir, baseName));
+}
+
+FString JsonImporter::getManifestFilename() const{
+	return FPackageName::LongPackageNameToFilename(getProjectImportPath(), TEXT(".exodusmanifest"));
+}
+
+FString JsonImporter::getExternResourceKey(const StringArray &resources, JsonId id) const{
+	if ((id < 0) || (id >= resources.Num()))
+		return FString();
+	return resources[id];
+}
+
+FString JsonImporter::hashExternResource(const FString &filename, const StringArray &extraFiles) const{
+	StringArray files;
+	files.Add(FPaths::Combine(sourceExternDataPath, filename));
+	files.Append(extraFiles);
+	return ImportManifest::hashFiles(files);
+}
+
+bool JsonImporter::reuseManifestEntry(const FString &key, const FString &hash){
+	if (!options.incrementalImport)
+		return false;
+
+	auto entry = manifest.findUpToDateEntry(key, hash);
+	if (!entry)
+		return false;
+
+	for(const auto &record: entry->records){
+		if (record.objectPath.IsEmpty())
+			continue;
+		bool exists = (FindObject<UObject>(nullptr, *record.objectPath) != nullptr) 
+			|| FPackageName::DoesPackageExist(FPackageName::ObjectPathToPackageName(record.objectPath));
+		if (!exists){
+			UE_LOG(JsonLog, Log, TEXT("Asset \"%s\" of unchanged resource \"%s\" is missing, rebuilding"), *record.objectPath, *key);
+			return false;
+		}
+	}
+
+	UE_LOG(JsonLog, Log, TEXT("Resource \"%s\" is unchanged, skipping"), *key);
+	for(const auto &record: entry->records){
+		switch(record.type){
+			case ImportManifestRecordType::Texture:
+				texIdMap.Add(record.id, record.objectPath);
+				break;
+			case ImportManifestRecordType::Cubemap:
+				cubeIdMap.Add(record.id, record.objectPath);
+				break;
+			case ImportManifestRecordType::MaterialInstance:
+				matInstIdMap.Add(record.id, record.objectPath);
+				break;
+			case ImportManifestRecordType::StaticMesh:
+				meshIdMap.Add(ResId::fromIndex(record.id), record.objectPath);
+				break;
+			case ImportManifestRecordType::SkeletalMesh:
+				skinMeshIdMap.Add(ResId::fromIndex(record.id), record.objectPath);
+				break;
+			case ImportManifestRecordType::Skeleton:
+				if (!skeletonIdMap.Contains(record.id))
+					skeletonIdMap.Add(record.id, record.objectPath);
+				break;
+			case ImportManifestRecordType::AnimSequence:
+				animClipPaths.Add(AnimClipIdKey(record.id, record.subId), record.objectPath);
+				break;
+			case ImportManifestRecordType::MeshGeometry:
+				//Changed meshes with the same geometry can still reuse the asset of an unchanged one
+				if (options.deduplicateMeshes && !staticMeshGeometryMap.Contains(record.geometryKey)){
+					auto &geometryEntry = staticMeshGeometryMap.Add(record.geometryKey);
+					geometryEntry.meshPath = record.objectPath;
+					geometryEntry.resourceKey = key;
+				}
+				break;
+			default:
+				UE_LOG(JsonLog, Warning, TEXT("Unknown manifest record type %d for \"%s\""), (int32)record.type, *key);
+				break;
+		}
+	}
+
+	manifest.keepEntry(key);
+	return true;
+}
+
+void JsonImporter::addManifestRecord(ImportManifestRecordType type, JsonId id, JsonId subId, const FString &path){
+	manifest.addRecord(ImportManifestRecord(type, id, subId, path));
+}
+
+bool JsonImporter::loadExternMeshFromFile(JsonMesh &outMesh, const FString &filename) const{
+	IMPORT_PROFILE_SCOPE_ASSET("loadExternMeshFromFile", filename);
+	auto fullPath = FPaths::Combine(sourceExternDataPath, filename);
+	return loadJsonMeshFromFile(outMesh, fullPath);
+}
+
 void JsonImporter::setupAssetPaths(const FString &jsonFilename){
 	assetRootPath = FPaths::GetPath(jsonFilename);
 	sourceBaseName = FPaths::GetBaseFilename(jsonFilename);
@@ -214,6 +757,7 @@ void JsonImporter::registerMaterialInstancePath(int32 id, FString path){
 		UE_LOG(JsonLog, Warning, TEXT("Duplicate material registration for id %d, path \"%s\""), id, *path);
 	}
 	matInstIdMap.Add(id, path);
+	addManifestRecord(ImportManifestRecordType::MaterialInstance, id, -1, path);
 }
 
 UMaterialInterface* JsonImporter::loadMaterialInterface(int32 id) const{
@@ -222,7 +766,7 @@ UMaterialInterface* JsonImporter::loadMaterialInterface(int32 id) const{
 
 
 USkeleton* JsonImporter::getSkeletonObject(int32 id) const{
-	auto found = skeletonIdMap.Find(id);
+	auto found = skeletonIdMap.Find(getMergedSkeletonId(id));
 	if (!found)
 		return nullptr;
 	auto result = LoadObject<USkeleton>(nullptr, **found);
@@ -232,6 +776,7 @@ USkeleton* JsonImporter::getSkeletonObject(int32 id) const{
 void JsonImporter::registerSkeleton(int32 id, USkeleton *skel){
 	check(skel);
 	check(id >= 0);
+	id = getMergedSkeletonId(id);
 
 	if (skeletonIdMap.Contains(id)){
 		UE_LOG(JsonLog, Log, TEXT("Duplicate skeleton registration for id %d"), id);
@@ -240,6 +785,7 @@ void JsonImporter::registerSkeleton(int32 id, USkeleton *skel){
 
 	auto path = skel->GetPathName();
 	skeletonIdMap.Add(id, path);
+	addManifestRecord(ImportManifestRecordType::Skeleton, id, -1, path);
 	//auto outer = skel->
 }
 
@@ -258,6 +804,7 @@ void JsonImporter::registerAnimSequence(AnimClipIdKey key, UAnimSequence *sequen
 	}
 	auto path = sequence->GetPathName();
 	animClipPaths.Add(key, path);
+	addManifestRecord(ImportManifestRecordType::AnimSequence, key.Key, key.Value, path);
 }
 
 const FString* JsonImporter::findMeshPath(ResId meshId) const{
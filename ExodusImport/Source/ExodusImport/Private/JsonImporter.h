@@ -9,8 +9,13 @@
 #include "JsonObjects/JsonMaterial.h"
 #include "JsonObjects.h"
 #include "ImportWorkData.h"
+#include "ImportOptions.h"
+#include "ImportManifest.h"
+#include "ImportScheduler.h"
+#include "MeshBuilder.h"
 #include "ObjectTools.h"
 #include "Editor/UnrealEd/Public/PackageTools.h"
+#include <functional>
 
 class USkeletalMesh;
 class UTexture;
@@ -20,11 +25,25 @@ class UAnimSequence;
 
 class JsonImporter{
 protected:
+	ImportOptions options;
+	ImportManifest manifest;
+
 	FString assetRootPath;//TODO: rename to srcAssetRootPath. Points to json file folder.
 	FString sourceExternDataPath;
 	FString assetCommonPath;
 	FString sourceBaseName;
 	ResIdNameMap meshIdMap;
+	/*
+	Static mesh built for a geometry hash and collision setup, and the extern resource it was built from. Used for mesh deduplication.
+	*/
+	class GeometryMeshEntry{
+	public:
+		FString meshPath;
+		FString resourceKey;
+	};
+	TMap<FString, GeometryMeshEntry> staticMeshGeometryMap;
+	//Meshes waiting for buildDeferredStaticMeshes, when ImportOptions::deferStaticMeshBuild is set.
+	TArray<PendingStaticMeshBuild> deferredStaticMeshes;
 	ResIdNameMap skinMeshIdMap;
 	IdNameMap texIdMap;
 	IdNameMap cubeIdMap;
@@ -67,13 +86,93 @@ protected:
 	//void importPrefab(const JsonPrefabData& prefab);
 	void importPrefabs(const StringArray &prefabs);
 
-	void importTerrainData(JsonObjPtr jsonData, JsonId terrainId, const FString &rootPath);
-	void loadTerrains(const StringArray &terrains);
+	/*
+	Result of preparation step of a scheduler node. Shared between prepare and build callbacks.
+	*/
+	template<typename T> class PreparedResource{
+	public:
+		T data;
+		FString hash;
+		bool loaded = false;
+		bool skipParse = false;
+	};
+	template<typename T> using PreparedResourcePtr = TSharedPtr<PreparedResource<T>, ESPMode::ThreadSafe>;
+	template<typename T> static PreparedResourcePtr<T> makePreparedResource(){
+		return MakeShared<PreparedResource<T>, ESPMode::ThreadSafe>();
+	}
+
+	/*
+	Scheduler nodes of extern resources, indexed by resource index. Valid while importResources is running.
+	*/
+	class ResourceNodeMap{
+	public:
+		ImportNodeIdArray textures;
+		ImportNodeIdArray cubemaps;
+		ImportNodeIdArray materials;
+		ImportNodeIdArray skeletons;
+		ImportNodeIdArray meshes;
+		ImportNodeIdArray terrains;
+		TMap<FString, ImportNodeId> byKey;
+
+		void clear();
+		void addNode(ImportNodeIdArray &nodes, const FString &key, ImportNodeId nodeId);
+		static void addDependency(ImportNodePrepareResult &result, const ImportNodeIdArray &nodes, JsonId resourceId);
+	};
+	ResourceNodeMap resourceNodes;
+
+	void scheduleTextures(ImportScheduler &scheduler, const StringArray &textures);
+	void scheduleCubemaps(ImportScheduler &scheduler, const StringArray &cubemaps);
+	void scheduleMaterials(ImportScheduler &scheduler, const StringArray &materials);
+	void scheduleSkeletons(ImportScheduler &scheduler, const StringArray &skeletons);
+	void scheduleMeshes(ImportScheduler &scheduler, const StringArray &meshes);
+	void scheduleTerrains(ImportScheduler &scheduler, const StringArray &terrains);
+	StringArray getMeshDependencyKeys(const JsonMesh &jsonMesh) const;
+	//Optimizes mesh data and generates lods as requested by options. Thread-safe, called on the preparation thread.
+	void prepareMeshGeometry(JsonMesh &jsonMesh) const;
+	//Appended to mesh hashes, so changed geometry settings rebuild meshes during incremental import.
+	FString getMeshSettingsKey() const;
+	/*
+	Chooses simple collision of a static mesh according to the collision policy and computes convex hulls when needed.
+	Thread-safe, called on the preparation thread after prepareMeshGeometry.
+	*/
+	void prepareMeshCollision(JsonMesh &jsonMesh) const;
+	//Like getMeshSettingsKey, for collision settings of one mesh.
+	FString getMeshCollisionKey(JsonId meshId) const;
+	//Fills colliderMeshIds from mesh colliders of all scenes and prefabs.
+	void collectColliderMeshIds(const JsonExternResourceList &externRes);
+
+	//Meshes referenced by mesh colliders, filled only when the collision policy is used.
+	IdSet colliderMeshIds;
+	/*
+	Loads all skeletons and maps every skeleton whose hierarchy (bone names and parents) is contained in another one
+	to the largest such skeleton. Does nothing unless ImportOptions::mergeSkeletons is set.
+	*/
+	void buildSkeletonMergeMap(const JsonExternResourceList &externRes);
+	//Skeleton id -> id of the skeleton whose USkeleton it shares. Skeletons that keep their own are not listed.
+	TMap<JsonId, JsonId> skeletonMergeMap;
+	//Added to skeleton hashes, so changed merges rebuild dependent meshes during incremental import.
+	FString getSkeletonMergeKey(JsonId id) const;
+	//Convex decompositions by geometry hash and settings, shared by preparation threads.
+	mutable TMap<FString, TArray<FloatArray>> convexHullCache;
+	mutable FCriticalSection convexHullCacheLock;
+
+	FString getManifestFilename() const;
+	//Stops ImportProfiler and writes its results, if profiling was enabled.
+	void saveImportProfile() const;
+	FString getExternResourceKey(const StringArray &resources, JsonId id) const;
+	FString hashExternResource(const FString &filename, const StringArray &extraFiles = StringArray()) const;
+	/*
+	Replays asset registrations of an unchanged resource. Returns false if the resource has to be rebuilt.
+	*/
+	bool reuseManifestEntry(const FString &key, const FString &hash);
+	void addManifestRecord(ImportManifestRecordType type, JsonId id, JsonId subId, const FString &path);
 
 	void registerMaterialInstancePath(int32 id, FString path);
 	void registerMasterMaterialPath(int32 id, FString path);
 
 	void importStaticMesh(const JsonMesh &jsonMesh, int32 meshId);
+	//Builds meshes whose build was deferred and registers them in meshIdMap.
+	void buildDeferredStaticMeshes();
 	void importSkeletalMesh(const JsonMesh &jsonMesh, int32 meshId);
 
 	void loadAnimatorsDebug(const StringArray &animatorPaths);
@@ -98,7 +197,15 @@ protected:
 		outObj.load(data);
 		return true;
 	}
+
 public:
+	const ImportOptions& getOptions() const{
+		return options;
+	}
+	void setOptions(const ImportOptions &newOptions){
+		options = newOptions;
+	}
+
 	const TMap<JsonId, JsonTerrainData>& getTerrainDataMap() const{
 		return terrainDataMap;
 	}
@@ -112,8 +219,11 @@ public:
 	UAnimSequence* getAnimSequence(AnimClipIdKey key) const;
 	void registerAnimSequence(AnimClipIdKey key, UAnimSequence *sequence);
 
+	//Both work with merged skeleton ids (see getMergedSkeletonId), any skeleton of a merged group can be passed.
 	USkeleton* getSkeletonObject(int32 id) const;
 	void registerSkeleton(int32 id, USkeleton *skel);
+	//Id of the skeleton whose USkeleton is used for the given one. Same id unless skeletons are merged.
+	JsonId getMergedSkeletonId(JsonId id) const;
 
 	JsonMesh loadJsonMesh(int32 id) const;
 	const JsonMaterial* getJsonMaterial(int32 id) const;
@@ -132,6 +242,7 @@ public:
 	UTextureCube* getCubemap(int32 id) const;
 	UTextureCube* loadCubemap(int32 id) const;
 	void importCubemap(JsonObjPtr data, const FString &rootPath);
+	void importCubemap(const JsonCubemap &jsonCube, const FString &rootPath, bool replaceExisting = false);
 
 	//UMaterialInstanceConstant* getMaterialInstance(int32 id) const;
 	const JsonSkeleton* getSkeleton(int32 id) const;
@@ -147,24 +258,20 @@ public:
 	UStaticMesh *loadStaticMeshById(ResId id) const;
 	USkeletalMesh *loadSkeletalMeshById(ResId id) const;
 
-	void importProject(const FString& path);
+	bool importProject(const FString& path);
 
 	void importResources(const JsonExternResourceList &resources);
-	void loadCubemaps(const StringArray &cubemaps);
-	void loadTextures(const StringArray & textures);
-	void loadMaterials(const StringArray &materials);
-	void loadSkeletons(const StringArray &materials);
-	void loadMeshes(const StringArray &meshes);
 
 	void loadObjects(const TArray<JsonGameObject> &objects, ImportWorkData &importData);
 
 	void setupAssetPaths(const FString &jsonFilename);
 
 	JsonObjPtr loadExternResourceFromFile(const FString &filename) const;
+	bool loadExternMeshFromFile(JsonMesh &outMesh, const FString &filename) const;
 
 	void importTexture(JsonObjPtr obj, const FString &rootPath);
 
-	void importTexture(const JsonTexture &tex, const FString &rootPath);
+	void importTexture(const JsonTexture &tex, const FString &rootPath, bool replaceExisting = false);
 
 	void importMesh(JsonObjPtr obj, int32 meshId);
 	void importMesh(const JsonMesh &jsonMesh, int32 meshId);
@@ -173,6 +280,7 @@ public:
 	static int findMatchingLength(const FString& arg1, const FString& arg2);
 	FString findCommonPath(const JsonValPtrs* resources) const;
 	FString findCommonPath(const StringArray &resources) const;
+	FString getPackageRoot() const;
 	FString getProjectImportPath() const;
 
 	/*
@@ -192,9 +300,7 @@ public:
 
 		FString packageName;
 
-		FString packageRoot = TEXT("/Game/Import");
-		if (sourceBaseName.Len())
-			packageRoot = packageRoot + TEXT("/") + sourceBaseName;
+		FString packageRoot = getProjectImportPath();
 		const int maxObjDirLength = 64;
 
 		if (objDir.Len() > 0){
@@ -101,6 +101,8 @@ void JsonImporter::processDelayedAnimators(const TArray<JsonGameObject> &objects
 }
 
 void JsonImporter::processDelayedAnimator(JsonId skelId, JsonId controllerId){
+	//Merged skeletons share clips with the skeleton they were merged into
+	skelId = getMergedSkeletonId(skelId);
 	UE_LOG(JsonLog, Log, TEXT("Processing animator: skelId: %d, controllerId: %d"), skelId, controllerId);
 	if (skelId < 0){
 		UE_LOG(JsonLog, Warning, TEXT("Skeleton not found while processing delayed animator %d(skel) %d(controller)"),
@@ -133,22 +135,43 @@ void JsonImporter::processDelayedAnimator(JsonId skelId, JsonId controllerId){
 
 	auto clipDir = FString::Printf(TEXT("%s/%s"), *controllerPath, *animBaseName);
 
+	const auto controllerKey = getExternResourceKey(externResources.animatorControllers, controllerId);
+	const auto skelKey = getExternResourceKey(externResources.skeletons, skelId);
+
 	for(const auto clipIndex: animController.animationIds){
+		if (getAnimSequence(AnimClipIdKey(skelId, clipIndex)))
+			continue;
+		const auto clipFile = getExternResourceKey(externResources.animationClips, clipIndex);
+		const auto clipKey = FString::Printf(TEXT("%s|%s|skel%d"), *controllerKey, *clipFile, skelId);
+		const auto clipHash = clipFile.IsEmpty() ? FString(): 
+			hashExternResource(clipFile, {FPaths::Combine(sourceExternDataPath, controllerKey)});
+		if (!clipFile.IsEmpty() && reuseManifestEntry(clipKey, clipHash)){
+			continue;
+		}
+
 		JsonAnimationClip animClip;
 		if (!loadIndexedExternResource(animClip, clipIndex, externResources.animationClips)){
 			UE_LOG(JsonLog, Warning, TEXT("Coudl not load animation clip %d while processing animation with skelId: %d; controllerId: %d"),
 				clipIndex, skelId, controllerId);
 		}
 
+		StringArray dependencies;
+		if (!skelKey.IsEmpty())
+			dependencies.Add(skelKey);
+		manifest.beginEntry(clipKey, clipHash, dependencies);
+
 		AnimationBuilder animBuilder;
 
 		UAnimSequence *newSeq = createAssetObject<UAnimSequence>(animClip.name, &clipDir, this, 
 			[&](UAnimSequence *newSeq){
 				newSeq->SetSkeleton(skeleton);
-				animBuilder.buildAnimation(newSeq, skeleton, animClip);
+				animBuilder.buildAnimation(newSeq, skeleton, animClip, getSkeleton(skelId));
 			}, RF_Standalone|RF_Public
 		);
 		UE_LOG(JsonLog, Log, TEXT("Created anim clip at \"%s\""), *newSeq->GetPathName());
+		if (newSeq)
+			registerAnimSequence(AnimClipIdKey(skelId, clipIndex), newSeq);
+		manifest.endEntry();
 		//createAssetObject(
 		//auto assetObj = createAssetObject(
 	}	
@@ -1,6 +1,7 @@
 #include "JsonImportPrivatePCH.h"
 
 #include "JsonImporter.h"
+#include "ImportProfiler.h"
 
 #include "Engine/PointLight.h"
 #include "Engine/SpotLight.h"
@@ -39,6 +40,23 @@ using namespace UnrealUtilities;
 using namespace JsonObjects;
 
 void JsonImporter::importStaticMesh(const JsonMesh &jsonMesh, int32 meshId){
+	FString geometryHash;
+	if (options.deduplicateMeshes){
+		//Meshes with the same geometry can still get different collision (see prepareMeshCollision)
+		geometryHash = jsonMesh.getGeometryHash() + getMeshCollisionKey(meshId) 
+			+ FString::Printf(TEXT("_simple%d"), (int32)jsonMesh.simpleCollision);
+		auto existing = staticMeshGeometryMap.Find(geometryHash);
+		if (existing){
+			UE_LOG(JsonLog, Log, TEXT("Mesh %s(%d) has the same geometry as \"%s\", reusing it"), 
+				*jsonMesh.name, jsonMesh.id.toIndex(), *existing->meshPath);
+			meshIdMap.Add(jsonMesh.id, existing->meshPath);
+			//Shared asset is rebuilt when its source changes, so this mesh has to follow it.
+			manifest.addDependency(existing->resourceKey);
+			addManifestRecord(ImportManifestRecordType::StaticMesh, jsonMesh.id.toIndex(), -1, existing->meshPath);
+			return;
+		}
+	}
+
 	auto unrealMeshName = jsonMesh.makeUnrealMeshName();
 	auto desiredDir = FPaths::GetPath(jsonMesh.path);
 	auto mesh = createAssetObject<UStaticMesh>(unrealMeshName, &desiredDir, this, 
@@ -50,7 +68,7 @@ void JsonImporter::importStaticMesh(const JsonMesh &jsonMesh, int32 meshId){
 					UMaterialInterface *material = loadMaterialInterface(matId);
 					materials.Add(material);
 				}
-			});
+			}, options.deferStaticMeshBuild ? &deferredStaticMeshes: nullptr);
 		},
 		[&](auto pkg, auto objName){
 			return NewObject<UStaticMesh>(pkg, FName(*objName), RF_Standalone|RF_Public);
@@ -59,10 +77,33 @@ void JsonImporter::importStaticMesh(const JsonMesh &jsonMesh, int32 meshId){
 
 	if (mesh){
 		auto meshPath = mesh->GetPathName();
-		meshIdMap.Add(jsonMesh.id, meshPath);
+		//Deferred meshes are registered once they are built
+		if (!options.deferStaticMeshBuild)
+			meshIdMap.Add(jsonMesh.id, meshPath);
+		addManifestRecord(ImportManifestRecordType::StaticMesh, jsonMesh.id.toIndex(), -1, meshPath);
+		if (!geometryHash.IsEmpty()){
+			auto &entry = staticMeshGeometryMap.Add(geometryHash);
+			entry.meshPath = meshPath;
+			entry.resourceKey = getExternResourceKey(externResources.meshes, meshId);
+
+			ImportManifestRecord geometryRecord(ImportManifestRecordType::MeshGeometry, jsonMesh.id.toIndex(), -1, meshPath);
+			geometryRecord.geometryKey = geometryHash;
+			manifest.addRecord(geometryRecord);
+		}
 	}
 }
 
+void JsonImporter::buildDeferredStaticMeshes(){
+	if (deferredStaticMeshes.Num() == 0)
+		return;
+	IMPORT_PROFILE_SCOPE("buildDeferredStaticMeshes");
+	UE_LOG(JsonLog, Log, TEXT("Building %d deferred static meshes"), deferredStaticMeshes.Num());
+	MeshBuilder::buildStaticMeshes(deferredStaticMeshes);
+	for(const auto &build: deferredStaticMeshes)
+		meshIdMap.Add(build.id, build.mesh->GetPathName());
+	deferredStaticMeshes.Empty();
+}
+
 void JsonImporter::importSkeletalMesh(const JsonMesh &jsonMesh, int32 meshId){
 	auto skelId = jsonMesh.defaultSkeletonId;
 	auto foundSkeleton = getSkeleton(skelId);
@@ -100,6 +141,7 @@ void JsonImporter::importSkeletalMesh(const JsonMesh &jsonMesh, int32 meshId){
 	if (mesh){
 		auto meshPath = mesh->GetPathName();
 		skinMeshIdMap.Add(jsonMesh.id, meshPath);
+		addManifestRecord(ImportManifestRecordType::SkeletalMesh, jsonMesh.id.toIndex(), -1, meshPath);
 	}
 }
 
@@ -137,8 +179,10 @@ JsonMesh JsonImporter::loadJsonMesh(int32 id) const{
 		return JsonMesh();
 	}
 
-	auto meshData = loadExternResourceFromFile(externResources.meshes[id]);
-	return JsonMesh(meshData);
+	JsonMesh result;
+	if (!loadExternMeshFromFile(result, externResources.meshes[id]))
+		return JsonMesh();
+	return result;
 }
 
 const JsonSkeleton* JsonImporter::getSkeleton(int32 id) const{
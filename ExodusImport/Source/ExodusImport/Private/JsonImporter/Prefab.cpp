@@ -2,6 +2,7 @@
 #include "CoreMinimal.h"
 #include "JsonTypes.h"
 #include "JsonImporter.h"
+#include "ImportProfiler.h"
 
 #include "Classes/Engine/Blueprint.h"
 #include "AssetRegistry/Public/AssetRegistryModule.h"
@@ -88,8 +89,10 @@ void JsonImporter::importPrefabs(const StringArray &prefabs){
 	return;
 #endif
 
+	IMPORT_PROFILE_SCOPE("importPrefabs");
 	FScopedSlowTask progress(prefabs.Num(), LOCTEXT("Importing prefabs", "Importing prefabs"));
-	progress.MakeDialog();
+	if (options.interactive)
+		progress.MakeDialog();
 	UE_LOG(JsonLog, Log, TEXT("Import prefabs"));
 	int32 objId = 0;
 	for(auto curFilename: prefabs){
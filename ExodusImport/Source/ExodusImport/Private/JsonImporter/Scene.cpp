@@ -34,6 +34,7 @@
 
 #include "UnrealUtilities.h"
 #include "JsonObjects.h"
+#include "ImportProfiler.h"
 #include "Runtime/AssetRegistry/Public/AssetRegistryModule.h"
 #include "UnrealEd/Public/Editor.h"
 #include "LocTextNamespace.h"
@@ -44,6 +45,7 @@ using namespace UnrealUtilities;
 using namespace JsonObjects;
 
 UWorld* JsonImporter::importScene(const JsonScene &scene, bool createWorld){
+	IMPORT_PROFILE_SCOPE_ASSET("importScene", scene.name);
 	const JsonValPtrs *sceneObjects = 0;
 
 	bool editorMode = !createWorld;
@@ -136,38 +138,53 @@ FString getWorldPackagePath(UWorld *world){
 	return filePath;
 }
 
-void JsonImporter::importProject(const FString& filename){
+bool JsonImporter::importProject(const FString& filename){
 	setupAssetPaths(filename);
 	auto jsonData = loadJsonFromFile(filename);
 	if (!jsonData){
 		UE_LOG(JsonLog, Error, TEXT("Json loading failed, aborting. \"%s\""), *filename);
-		return;
+		return false;
 	}
 
+	if (options.profile)
+		ImportProfiler::get().begin(options.profileMemory);
+	ImportProfileScope projectScope(TEXT("importProject"), filename);
+
 	JsonProject project(jsonData);
 	externResources = project.externResources;
 
+	const auto manifestFilename = getManifestFilename();
+	manifest.clear();
+	if (options.incrementalImport)
+		manifest.load(manifestFilename);
+
+	collectColliderMeshIds(externResources);
+	buildSkeletonMergeMap(externResources);
 	importResources(externResources);
 	const auto& scenes = externResources.scenes;
 
 	auto singleScene = externResources.scenes.Num() == 1;
-	auto createWorldFlag = !singleScene;
+	//There's no editor level to import into when running headless
+	auto createWorldFlag = !singleScene || !options.interactive;
 	FString lastWorldPackage;
 	FScopedSlowTask sceneProgress(scenes.Num(), LOCTEXT("Importing scenes", "Importing scenes"));
 
 	StringArray importedWorlds;
 
-	sceneProgress.MakeDialog();
+	if (options.interactive)
+		sceneProgress.MakeDialog();
+	bool result = true;
 	for(int i = 0; i < scenes.Num(); i++){
 		const auto& sceneFile = scenes[i];
 		auto curSceneData = loadExternResourceFromFile(sceneFile);//(*scenes)[i];
 		if (!curSceneData.IsValid()){
 			UE_LOG(JsonLog, Error, TEXT("Invalid scene data %d, file \"%s\""), i, *sceneFile);
+			result = false;
 		}
 		else{
 			JsonScene scene(curSceneData);
 			bool createWorldRequired = false;
-			if (singleScene){
+			if (singleScene && options.interactive){
 				if (scene.containsTerrain()){
 					//FMessageDialog::Debugf(TEXT("The scene you're importing contains terrain, and will be imported as a new level"));
 					FMessageDialog::Debugf(LOCTEXT("Scene contains terrain", "The scene you're importing contains terrain, and will be imported as a new level"));
@@ -186,7 +203,16 @@ void JsonImporter::importProject(const FString& filename){
 		sceneProgress.EnterProgressFrame();
 	}
 
+	manifest.save(manifestFilename);
+	projectScope.finish();
+	saveImportProfile();
+
 	if (importedWorlds.Num() > 0){
+		if (!options.interactive){
+			for(const auto& cur: importedWorlds)
+				UE_LOG(JsonLog, Log, TEXT("Scene imported as: %s"), *cur);
+			return result;
+		}
 		FString text = TEXT("Scenes imported as:\n");
 		for(const auto& cur: importedWorlds){
 			text += FString::Printf(TEXT("%s\n"), *cur);
@@ -194,6 +220,7 @@ void JsonImporter::importProject(const FString& filename){
 		text += TEXT("If you imported scenes with terrain, please wait till shaders finish compiling.");
 		FMessageDialog::Debugf(FText::FromString(text));
 	}
+	return result;
 }
 
 #undef LOCTEXT_NAMESPACE
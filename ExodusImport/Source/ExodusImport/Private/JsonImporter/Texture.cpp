@@ -111,6 +111,10 @@ static bool loadCompressedBinary(ByteArray &outData, const FString &filename){
 
 void JsonImporter::importCubemap(JsonObjPtr data, const FString &rootPath){
 	JsonCubemap jsonCube(data);
+	importCubemap(jsonCube, rootPath);
+}
+
+void JsonImporter::importCubemap(const JsonCubemap &jsonCube, const FString &rootPath, bool replaceExisting){
 	UE_LOG(JsonLog, Log, TEXT("Cubemap: %d, %s, %s (%s), %dx%d"), 
 		jsonCube.id, *jsonCube.name, *jsonCube.assetPath, *jsonCube.exportPath, 
 		jsonCube.texParams.width, jsonCube.texParams.height);
@@ -125,9 +129,15 @@ void JsonImporter::importCubemap(JsonObjPtr data, const FString &rootPath){
 		&packageName, &textureName, &existingTexture);
 
 	if (existingTexture){
-		cubeIdMap.Add(jsonCube.id, existingTexture->GetPathName());
-		UE_LOG(JsonLog, Warning, TEXT("Cube texture %s already exists, package %s"), *textureName, *packageName);
-		return;
+		if (!replaceExisting){
+			cubeIdMap.Add(jsonCube.id, existingTexture->GetPathName());
+			addManifestRecord(ImportManifestRecordType::Cubemap, jsonCube.id, -1, existingTexture->GetPathName());
+			UE_LOG(JsonLog, Warning, TEXT("Cube texture %s already exists, package %s"), *textureName, *packageName);
+			return;
+		}
+		//Source changed since the previous import, existing object is rebuilt in place.
+		UE_LOG(JsonLog, Log, TEXT("Replacing cube texture %s, package %s"), *textureName, *packageName);
+		textureName = existingTexture->GetName();
 	}
 
 	ByteArray binaryData; 
@@ -209,6 +219,7 @@ void JsonImporter::importCubemap(JsonObjPtr data, const FString &rootPath){
 
 	if (cubeTex){
 		cubeIdMap.Add(jsonCube.id, cubeTex->GetPathName());
+		addManifestRecord(ImportManifestRecordType::Cubemap, jsonCube.id, -1, cubeTex->GetPathName());
 		cubeTex->PostEditChange();
 		FAssetRegistryModule::AssetCreated(cubeTex);
 		texturePackage->SetDirtyFlag(true);
@@ -230,7 +241,7 @@ void JsonImporter::importTexture(JsonObjPtr obj, const FString &rootPath){
 	importTexture(jsonTex, rootPath);
 }
 
-void JsonImporter::importTexture(const JsonTexture &jsonTex, const FString &rootPath){
+void JsonImporter::importTexture(const JsonTexture &jsonTex, const FString &rootPath, bool replaceExisting){
 	UE_LOG(JsonLog, Log, TEXT("Texture: %s, %s, %d x %d"), 
 		*jsonTex.path, *jsonTex.name, jsonTex.width, jsonTex.height);
 
@@ -257,9 +268,15 @@ void JsonImporter::importTexture(const JsonTexture &jsonTex, const FString &root
 		&packageName, &textureName, &existingTexture);
 
 	if (existingTexture){
-		texIdMap.Add(jsonTex.id, existingTexture->GetPathName());
-		UE_LOG(JsonLog, Warning, TEXT("Texutre %s already exists, package %s"), *textureName, *packageName);
-		return;
+		if (!replaceExisting){
+			texIdMap.Add(jsonTex.id, existingTexture->GetPathName());
+			addManifestRecord(ImportManifestRecordType::Texture, jsonTex.id, -1, existingTexture->GetPathName());
+			UE_LOG(JsonLog, Warning, TEXT("Texutre %s already exists, package %s"), *textureName, *packageName);
+			return;
+		}
+		//Source changed since the previous import, existing object is rebuilt in place.
+		UE_LOG(JsonLog, Log, TEXT("Replacing texture %s, package %s"), *textureName, *packageName);
+		textureName = existingTexture->GetName();
 	}
 
 	TArray<uint8> binaryData;
@@ -304,6 +321,7 @@ void JsonImporter::importTexture(const JsonTexture &jsonTex, const FString &root
 
 	if (unrealTexture){
 		texIdMap.Add(jsonTex.id, unrealTexture->GetPathName());
+		addManifestRecord(ImportManifestRecordType::Texture, jsonTex.id, -1, unrealTexture->GetPathName());
 		FAssetRegistryModule::AssetCreated(unrealTexture);
 		texturePackage->SetDirtyFlag(true);
 	}
@@ -1,27 +1,91 @@
 #include "JsonImportPrivatePCH.h"
 #include "JsonObjects.h"
 #include "JsonLog.h"
+#include "ImportProfiler.h"
+#include "MappedUtf8Archive.h"
+#include "MappedFileData.h"
 
 #define LOCTEXT_NAMESPACE LOCTEXT_NAMESPACE_NAME
 
 using namespace JsonObjects;
 
+/*
+Opens json reader over the file. UTF-8 files are decoded directly from the mapped file,
+other encodings are loaded into outString first.
+*/
+static bool createJsonFileReader(const FString &filename, MappedUtf8Archive &archive, FString &outString, TSharedPtr<TJsonReader<>> &outReader){
+	if (archive.open(filename)){
+		outReader = TJsonReaderFactory<>::Create(&archive);
+		return true;
+	}
+
+	if (!FFileHelper::LoadFileToString(outString, *filename)){
+		UE_LOG(JsonLog, Warning, TEXT("Could not load json file \"%s\""), *filename);
+		return false;
+	}
+	outReader = TJsonReaderFactory<>::Create(outString);
+	return true;
+}
+
 JsonObjPtr JsonObjects::loadJsonFromFile(const FString &filename){
+	MappedUtf8Archive archive;
 	FString jsonString;
-	if (!FFileHelper::LoadFileToString(jsonString, *filename)){
-		UE_LOG(JsonLog, Warning, TEXT("Could not load json file \"%s\""), *filename);
+	TSharedPtr<TJsonReader<>> reader;
+	if (!createJsonFileReader(filename, archive, jsonString, reader))
 		return 0;
-	}
 
 	UE_LOG(JsonLog, Log, TEXT("Loaded json file \"%s\""), *filename);
-	JsonReaderRef reader = TJsonReaderFactory<>::Create(jsonString);
 
 	JsonObjPtr jsonData = MakeShareable(new FJsonObject());
-	if (!FJsonSerializer::Deserialize(reader, jsonData)){
+	if (!FJsonSerializer::Deserialize(reader.ToSharedRef(), jsonData)){
 		UE_LOG(JsonLog, Warning, TEXT("Could not parse json file \"%s\""), *filename);
 		return 0;
 	}
 	return jsonData;
 }
 
+bool JsonObjects::loadJsonMeshFromFile(JsonMesh &outMesh, const FString &filename){
+	//Sidecar is checked first, so the json parser can skip arrays it provides
+	auto binaryPath = JsonBinaryMesh::getSidecarPath(filename);
+	MappedFileData binaryData;
+	TSet<uint64> sidecarBlocks;
+	const bool hasSidecar = FPaths::FileExists(binaryPath);
+	if (hasSidecar){
+		if (!binaryData.open(binaryPath) 
+				|| !JsonBinaryMesh::getBlockKeys(sidecarBlocks, binaryData.getData(), binaryData.getSize(), binaryPath)){
+			UE_LOG(JsonLog, Warning, TEXT("Could not load binary mesh data \"%s\""), *binaryPath);
+			return false;
+		}
+	}
+
+	MappedUtf8Archive archive;
+	FString jsonString;
+	TSharedPtr<TJsonReader<>> reader;
+	if (!createJsonFileReader(filename, archive, jsonString, reader))
+		return false;
+
+	UE_LOG(JsonLog, Log, TEXT("Loaded json file \"%s\""), *filename);
+
+	{
+		ImportProfileScope profileScope(TEXT("JsonMesh::loadFromStream"), filename);
+		profileScope.addBytes(archive.isOpen() ? archive.TotalSize(): jsonString.Len());
+		if (!outMesh.loadFromStream(reader.ToSharedRef(), hasSidecar ? &sidecarBlocks: nullptr)){
+			UE_LOG(JsonLog, Warning, TEXT("Could not parse mesh json file \"%s\""), *filename);
+			return false;
+		}
+		profileScope.addElements(outMesh.verts.Num() / 3);
+	}
+
+	if (hasSidecar){
+		ImportProfileScope profileScope(TEXT("JsonBinaryMesh::load"), binaryPath);
+		profileScope.addBytes(binaryData.getSize());
+		if (!JsonBinaryMesh::load(outMesh, binaryData.getData(), binaryData.getSize(), binaryPath)){
+			UE_LOG(JsonLog, Warning, TEXT("Could not load binary mesh data \"%s\""), *binaryPath);
+			return false;
+		}
+		profileScope.addElements(outMesh.verts.Num() / 3);
+	}
+	return true;
+}
+
 #undef LOCTEXT_NAMESPACE
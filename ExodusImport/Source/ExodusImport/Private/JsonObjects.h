@@ -17,10 +17,12 @@
 #include "JsonObjects/loggers.h"
 #include "JsonObjects/getters.h"
 #include "JsonObjects/utilities.h"
+#include "JsonObjects/streamGetters.h"
 
 #include "JsonObjects/JsonTexture.h"
 #include "JsonObjects/JsonCubemap.h"
 #include "JsonObjects/JsonMesh.h"
+#include "JsonObjects/JsonBinaryMesh.h"
 #include "JsonObjects/JsonExternResourceList.h"
 #include "JsonObjects/JsonProject.h"
 #include "JsonObjects/JsonScene.h"
@@ -30,4 +32,5 @@
 
 namespace JsonObjects{
 	JsonObjPtr loadJsonFromFile(const FString &filename);
+	bool loadJsonMeshFromFile(JsonMesh &outMesh, const FString &filename);
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 namespace DataPlaneUtility{
+	//Transposed data has srcHeight elements per row.
 	template<typename T> void transpose2dData(T* transposed, const T* src, int32 srcWidth, int32 srcHeight){
 		auto srcRowData = src;
 		auto dstRowData = transposed;
@@ -10,7 +11,7 @@ namespace DataPlaneUtility{
 			for(int32 x = 0; x < srcWidth; x++){
 				*dstPixData = *srcPixData;
 				srcPixData ++;
-				dstPixData += srcWidth;
+				dstPixData += srcHeight;
 			}
 			srcRowData += srcWidth;
 			dstRowData ++;
@@ -0,0 +1,190 @@
+#include "JsonImportPrivatePCH.h"
+#include "JsonBinaryMesh.h"
+#include "JsonMesh.h"
+#include "MappedFileData.h"
+
+#pragma pack(push, 1)
+struct ExMeshHeader{
+	char magic[4];
+	uint32 version;
+	uint32 numBlocks;
+	uint32 reserved;
+};
+
+struct ExMeshBlockEntry{
+	uint32 type;
+	uint32 index;
+	uint64 offset;
+	uint64 size;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(ExMeshHeader) == 16, "Invalid exmesh header size");
+static_assert(sizeof(ExMeshBlockEntry) == 24, "Invalid exmesh block entry size");
+
+template<typename T> static bool copyBlock(TArray<T> &outData, const uint8* src, const ExMeshBlockEntry &block, const FString &filename){
+	if ((block.size % sizeof(T)) != 0){
+		UE_LOG(JsonLog, Warning, TEXT("Block %d(%d) in \"%s\" has size %d, which is not a multiple of %d"),
+			block.type, block.index, *filename, (int32)block.size, (int32)sizeof(T));
+		return false;
+	}
+	const auto numElements = (int32)(block.size / sizeof(T));
+	outData.SetNumUninitialized(numElements);
+	FMemory::Memcpy(outData.GetData(), src + block.offset, block.size);
+	return true;
+}
+
+static bool copyMatrixBlock(MatrixArray &outData, const uint8* src, const ExMeshBlockEntry &block, const FString &filename){
+	FloatArray floats;
+	if (!copyBlock(floats, src, block, filename))
+		return false;
+
+	const int32 matrixSize = 16;
+	if ((floats.Num() % matrixSize) != 0){
+		UE_LOG(JsonLog, Warning, TEXT("Matrix block in \"%s\" has %d floats"), *filename, floats.Num());
+		return false;
+	}
+
+	//Unity stores matrices column-major, which matches the order used by JsonObjects::toMatrix
+	outData.SetNum(floats.Num() / matrixSize);
+	for(int matIndex = 0; matIndex < outData.Num(); matIndex++){
+		auto &dst = outData[matIndex];
+		const float *srcFloats = floats.GetData() + matIndex * matrixSize;
+		for(int i = 0; i < matrixSize; i++)
+			dst.M[i / 4][i % 4] = srcFloats[i];
+	}
+	return true;
+}
+
+FString JsonBinaryMesh::getSidecarPath(const FString &jsonFilename){
+	return FPaths::ChangeExtension(jsonFilename, TEXT("exmesh"));
+}
+
+bool JsonBinaryMesh::load(JsonMesh &outMesh, const FString &filename){
+	MappedFileData fileData;
+	if (!fileData.open(filename)){
+		UE_LOG(JsonLog, Error, TEXT("Could not open binary mesh \"%s\""), *filename);
+		return false;
+	}
+	UE_LOG(JsonLog, Log, TEXT("Loading binary mesh \"%s\" (%s)"), *filename, fileData.isMapped() ? TEXT("mapped"): TEXT("loaded"));
+	return load(outMesh, fileData.getData(), fileData.getSize(), filename);
+}
+
+static bool readHeader(ExMeshHeader &outHeader, const uint8 *data, int64 dataSize, const FString &filename){
+	if (!data || (dataSize < (int64)sizeof(ExMeshHeader))){
+		UE_LOG(JsonLog, Error, TEXT("File \"%s\" is too small to store binary mesh header"), *filename);
+		return false;
+	}
+
+	FMemory::Memcpy(&outHeader, data, sizeof(outHeader));
+	if (FMemory::Memcmp(outHeader.magic, "EXMS", 4) != 0){
+		UE_LOG(JsonLog, Error, TEXT("Invalid binary mesh signature in \"%s\""), *filename);
+		return false;
+	}
+	if (outHeader.version > JsonBinaryMesh::currentVersion){
+		UE_LOG(JsonLog, Error, TEXT("Unsupported binary mesh version %d in \"%s\" (max supported %d)"), 
+			outHeader.version, *filename, (int32)JsonBinaryMesh::currentVersion);
+		return false;
+	}
+
+	const int64 tocEnd = (int64)sizeof(ExMeshHeader) + (int64)outHeader.numBlocks * (int64)sizeof(ExMeshBlockEntry);
+	if (dataSize < tocEnd){
+		UE_LOG(JsonLog, Error, TEXT("File \"%s\" is too small to store %d block entries"), *filename, outHeader.numBlocks);
+		return false;
+	}
+	return true;
+}
+
+uint64 JsonBinaryMesh::getBlockKey(BlockType type, uint32 index){
+	return ((uint64)type << 32) | (uint64)index;
+}
+
+bool JsonBinaryMesh::getBlockKeys(TSet<uint64> &outKeys, const uint8 *data, int64 dataSize, const FString &filename){
+	outKeys.Empty();
+	ExMeshHeader header;
+	if (!readHeader(header, data, dataSize, filename))
+		return false;
+
+	const auto *entries = data + sizeof(ExMeshHeader);
+	for(uint32 blockIndex = 0; blockIndex < header.numBlocks; blockIndex++){
+		ExMeshBlockEntry block;
+		FMemory::Memcpy(&block, entries + blockIndex * sizeof(ExMeshBlockEntry), sizeof(block));
+		outKeys.Add(getBlockKey((BlockType)block.type, block.index));
+	}
+	return true;
+}
+
+bool JsonBinaryMesh::load(JsonMesh &outMesh, const uint8 *data, int64 dataSize, const FString &filename){
+	ExMeshHeader header;
+	if (!readHeader(header, data, dataSize, filename))
+		return false;
+
+	const auto *entries = data + sizeof(ExMeshHeader);
+	for(uint32 blockIndex = 0; blockIndex < header.numBlocks; blockIndex++){
+		ExMeshBlockEntry block;
+		FMemory::Memcpy(&block, entries + blockIndex * sizeof(ExMeshBlockEntry), sizeof(block));
+
+		if ((block.offset > (uint64)dataSize) || (block.size > (uint64)dataSize - block.offset)){
+			UE_LOG(JsonLog, Error, TEXT("Block %d in \"%s\" is out of file bounds"), blockIndex, *filename);
+			return false;
+		}
+
+		bool ok = true;
+		switch((BlockType)block.type){
+			case BlockType::Positions:
+				ok = copyBlock(outMesh.verts, data, block, filename);
+				break;
+			case BlockType::Normals:
+				ok = copyBlock(outMesh.normals, data, block, filename);
+				break;
+			case BlockType::Tangents:
+				ok = copyBlock(outMesh.tangents, data, block, filename);
+				break;
+			case BlockType::TexCoords:{
+				FloatArray* coords[maxTexCoords] = {
+					&outMesh.uv0, &outMesh.uv1, &outMesh.uv2, &outMesh.uv3, 
+					&outMesh.uv4, &outMesh.uv5, &outMesh.uv6, &outMesh.uv7
+				};
+				if (block.index >= maxTexCoords){
+					UE_LOG(JsonLog, Warning, TEXT("Invalid uv channel %d in \"%s\""), block.index, *filename);
+					break;
+				}
+				ok = copyBlock(*coords[block.index], data, block, filename);
+				break;
+			}
+			case BlockType::Colors:
+				ok = copyBlock(outMesh.colors, data, block, filename);
+				break;
+			case BlockType::BoneIndexes:
+				ok = copyBlock(outMesh.boneIndexes, data, block, filename);
+				break;
+			case BlockType::BoneWeights:
+				ok = copyBlock(outMesh.boneWeights, data, block, filename);
+				break;
+			case BlockType::BindPoses:
+				ok = copyMatrixBlock(outMesh.bindPoses, data, block, filename);
+				break;
+			case BlockType::InverseBindPoses:
+				ok = copyMatrixBlock(outMesh.inverseBindPoses, data, block, filename);
+				break;
+			case BlockType::SubMeshTriangles:{
+				if (block.index >= header.numBlocks){
+					UE_LOG(JsonLog, Warning, TEXT("Invalid submesh index %d in \"%s\""), block.index, *filename);
+					break;
+				}
+				if ((int32)block.index >= outMesh.subMeshes.Num())
+					outMesh.subMeshes.SetNum(block.index + 1);
+				ok = copyBlock(outMesh.subMeshes[block.index].triangles, data, block, filename);
+				break;
+			}
+			default:
+				UE_LOG(JsonLog, Warning, TEXT("Unknown block type %d in \"%s\", skipping"), block.type, *filename);
+				break;
+		}
+		if (!ok)
+			return false;
+	}
+
+	outMesh.vertexCount = outMesh.verts.Num() / 3;
+	return true;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "JsonTypes.h"
+
+class JsonMesh;
+
+/*
+Binary sidecar for mesh json (".exmesh"), stored next to the json file with the same base name.
+
+Layout (little-endian):
+	header: char magic[4] = "EXMS"; uint32 version; uint32 numBlocks; uint32 reserved;
+	table of contents: numBlocks entries of {uint32 type; uint32 index; uint64 offset; uint64 size;}
+	raw blocks, offsets are relative to the beginning of the file, sizes are in bytes.
+
+Json file still provides names, ids, materials and other small fields. Blocks present in the 
+sidecar replace corresponding json arrays.
+*/
+class JsonBinaryMesh{
+public:
+	enum class BlockType: uint32{
+		Positions = 1,//float3
+		Normals = 2,//float3
+		Tangents = 3,//float4
+		TexCoords = 4,//float2, index is uv channel
+		Colors = 5,//uint8 rgba
+		BoneIndexes = 6,//int32 x4
+		BoneWeights = 7,//float x4
+		BindPoses = 8,//float4x4, unity element order
+		InverseBindPoses = 9,//float4x4, unity element order
+		SubMeshTriangles = 10,//int32, index is submesh index
+	};
+
+	enum{
+		currentVersion = 1,
+		maxTexCoords = 8
+	};
+
+	static FString getSidecarPath(const FString &jsonFilename);
+	static bool load(JsonMesh &outMesh, const FString &filename);
+	static bool load(JsonMesh &outMesh, const uint8 *data, int64 dataSize, const FString &filename);
+
+	/*
+	Collects getBlockKey() of every block in the sidecar, so the json loader can skip arrays 
+	that are going to be replaced anyway.
+	*/
+	static uint64 getBlockKey(BlockType type, uint32 index);
+	static bool getBlockKeys(TSet<uint64> &outKeys, const uint8 *data, int64 dataSize, const FString &filename);
+};
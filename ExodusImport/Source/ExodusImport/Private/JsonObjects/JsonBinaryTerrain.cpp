@@ -1,6 +1,7 @@
 #include "JsonImportPrivatePCH.h"
 #include "JsonBinaryTerrain.h"
 #include "terrainTools.h"
+#include "ImportProfiler.h"
 
 void JsonBinaryTerrain::clear(){
 	heightMap.clear();
@@ -132,6 +133,7 @@ void convertFloat3DSplatToUintPlanes(TArray<DataPlane2D<uint8>> &outResult, cons
 }
 
 void JsonConvertedTerrain::assignFrom(const JsonBinaryTerrain& src){
+	IMPORT_PROFILE_SCOPE("JsonConvertedTerrain::assignFrom");
 	UE_LOG(JsonLogTerrain, Log, TEXT("Transposing height map"));
 	auto floatHMap = src.heightMap.getTransposed();
 
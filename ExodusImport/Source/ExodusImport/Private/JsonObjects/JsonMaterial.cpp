@@ -147,3 +147,16 @@ FString JsonMaterial::getUnrealMaterialName() const{
 	}
 	return result;
 }
+
+IntArray JsonMaterial::getTextureIds() const{
+	const JsonTextureId texIds[] = {
+		mainTexture, albedoTex, specularTex, metallicTex, normalMapTex, occlusionTex, 
+		parallaxTex, emissionTex, detailMaskTex, detailAlbedoTex, detailNormalMapTex
+	};
+	IntArray result;
+	for(auto curId: texIds){
+		if (curId >= 0)
+			result.AddUnique(curId);
+	}
+	return result;
+}
@@ -184,6 +184,9 @@ public:
 	bool isAlphaTestQueue() const;
 	bool isGeomQueue() const;
 
+	//Unique valid texture ids referenced by the material.
+	IntArray getTextureIds() const;
+
 	JsonMaterial() = default;
 	void load(JsonObjPtr data);
 	JsonMaterial(JsonObjPtr data);
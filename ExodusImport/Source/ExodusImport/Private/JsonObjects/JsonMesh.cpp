@@ -3,6 +3,13 @@
 #include "macros.h"
 #include "loggers.h"
 #include "UnrealUtilities.h"
+#include "streamGetters.h"
+#include "JsonBinaryMesh.h"
+#include "ImportProfiler.h"
+#include "Misc/SecureHash.h"
+#include "MeshSimplifier.h"
+#include "MeshRenderOptimizer.h"
+#include "LightmapUvGenerator.h"
 
 //#define JSON_ENABLE_VALUE_LOGGING
 
@@ -13,19 +20,16 @@ void JsonSubMesh::load(JsonObjPtr data){
 }
 
 void JsonMesh::load(JsonObjPtr data){
-	using namespace JsonObjects;
-
-	JSON_GET_VAR(data, id);
-	JSON_GET_VAR(data, name);
-	JSON_GET_VAR(data, uniqueName);
+	ImportProfileScope profileScope(TEXT("JsonMesh::load"));
+	loadBulkData(data);
+	loadHeader(data);
+	profileScope.setAsset(name);
+	profileScope.addElements(verts.Num() / 3);
+}
 
-	JSON_GET_VAR(data, convexCollider);
-	JSON_GET_VAR(data, triangleCollider);
+void JsonMesh::loadBulkData(JsonObjPtr data){
+	using namespace JsonObjects;
 
-	JSON_GET_VAR(data, path);
-	JSON_GET_VAR(data, materials);
-	JSON_GET_VAR(data, readable);
-	JSON_GET_VAR(data, vertexCount);
 	colors = getByteArray(data, "colors", true);
 	logValue(TEXT("colors: "), colors);
 	
@@ -59,6 +63,27 @@ void JsonMesh::load(JsonObjPtr data){
 	boneIndexes = getIntArray(data, "boneIndexes", true);
 	logValue(TEXT("boneIndexes: "), boneIndexes);
 
+	JSON_GET_VAR(data, blendShapeCount);
+	getJsonObjArray(data, blendShapes, "blendShapes", blendShapeCount == 0);
+
+	getJsonObjArray(data, subMeshes, "subMeshes");
+}
+
+void JsonMesh::loadHeader(JsonObjPtr data){
+	using namespace JsonObjects;
+
+	JSON_GET_VAR(data, id);
+	JSON_GET_VAR(data, name);
+	JSON_GET_VAR(data, uniqueName);
+
+	JSON_GET_VAR(data, convexCollider);
+	JSON_GET_VAR(data, triangleCollider);
+
+	JSON_GET_VAR(data, path);
+	JSON_GET_VAR(data, materials);
+	JSON_GET_VAR(data, readable);
+	JSON_GET_VAR(data, vertexCount);
+
 	JSON_GET_VAR(data, defaultSkeletonId);
 	defaultBoneNames = getStringArray(data, "defaultBoneNames", true);
 	logValue(TEXT("defaultBoneNames: "), boneIndexes);
@@ -68,14 +93,201 @@ void JsonMesh::load(JsonObjPtr data){
 	JSON_GET_VAR_NOLOG(data, defaultMeshNodeMatrix);
 
 	JSON_GET_VAR(data, blendShapeCount);
-	getJsonObjArray(data, blendShapes, "blendShapes", blendShapeCount == 0);
 
 	bool needsSkinWeights = (boneWeights.Num() != 0)||(boneIndexes.Num() != 0);
 	bindPoses = getMatrixArray(data, "bindPoses", !needsSkinWeights);
 	inverseBindPoses = getMatrixArray(data, "inverseBindPoses", !needsSkinWeights);
 
 	JSON_GET_VAR(data, subMeshCount);
-	getJsonObjArray(data, subMeshes, "subMeshes");
+}
+
+bool JsonMesh::loadFromStream(const JsonReaderRef &reader, const TSet<uint64> *sidecarBlocks){
+	using namespace JsonObjects;
+	using BlockType = JsonBinaryMesh::BlockType;
+
+	EJsonNotation notation;
+	if (!reader->ReadNext(notation) || (notation != EJsonNotation::ObjectStart)){
+		UE_LOG(JsonLog, Warning, TEXT("Mesh json stream does not start with an object"));
+		return false;
+	}
+
+	auto inSidecar = [&](BlockType type, uint32 index){
+		return sidecarBlocks && sidecarBlocks->Contains(JsonBinaryMesh::getBlockKey(type, index));
+	};
+
+	struct StreamFloatArray{
+		const TCHAR* name;
+		FloatArray *data;
+		int32 elementSize;
+		BlockType blockType;
+		uint32 blockIndex;
+	};
+	const StreamFloatArray floatArrays[] = {
+		{TEXT("verts"), &verts, 3, BlockType::Positions, 0}, 
+		{TEXT("normals"), &normals, 3, BlockType::Normals, 0}, 
+		{TEXT("tangents"), &tangents, 4, BlockType::Tangents, 0},
+		{TEXT("uv0"), &uv0, 2, BlockType::TexCoords, 0}, {TEXT("uv1"), &uv1, 2, BlockType::TexCoords, 1}, 
+		{TEXT("uv2"), &uv2, 2, BlockType::TexCoords, 2}, {TEXT("uv3"), &uv3, 2, BlockType::TexCoords, 3}, 
+		{TEXT("uv4"), &uv4, 2, BlockType::TexCoords, 4}, {TEXT("uv5"), &uv5, 2, BlockType::TexCoords, 5}, 
+		{TEXT("uv6"), &uv6, 2, BlockType::TexCoords, 6}, {TEXT("uv7"), &uv7, 2, BlockType::TexCoords, 7}, 
+		{TEXT("boneWeights"), &boneWeights, 4, BlockType::BoneWeights, 0}
+	};
+
+	//vertexCount is normally written before vertex data and is used to preallocate arrays.
+	int32 expectedVerts = 0;
+	int32 expectedSubMeshes = 0;
+	int32 expectedBlendShapes = 0;
+
+	JsonObjPtr header = MakeShareable(new FJsonObject());
+	bool result = readStreamObject(reader, header, 
+		[&](const FString &fieldName, EJsonNotation valNotation) -> StreamFieldResult{
+			if (valNotation == EJsonNotation::Number){
+				if (fieldName == TEXT("vertexCount"))
+					expectedVerts = (int32)reader->GetValueAsNumber();
+				else if (fieldName == TEXT("subMeshCount"))
+					expectedSubMeshes = (int32)reader->GetValueAsNumber();
+				else if (fieldName == TEXT("blendShapeCount"))
+					expectedBlendShapes = (int32)reader->GetValueAsNumber();
+				return StreamFieldResult::NotHandled;
+			}
+			if (valNotation != EJsonNotation::ArrayStart)
+				return StreamFieldResult::NotHandled;
+
+			//Sidecar data replaces these arrays, skipping avoids converting numbers we'd throw away
+			auto skipSidecarArray = [&](){
+				return skipStreamValue(reader, valNotation) ? StreamFieldResult::Handled: StreamFieldResult::Failed;
+			};
+
+			bool ok = true;
+			for(const auto &cur: floatArrays){
+				if (fieldName == cur.name){
+					if (inSidecar(cur.blockType, cur.blockIndex))
+						return skipSidecarArray();
+					ok = readStreamArray(reader, *cur.data, expectedVerts * cur.elementSize);
+					return ok ? StreamFieldResult::Handled: StreamFieldResult::Failed;
+				}
+			}
+
+			//Matrices are read by loadHeader, only intercepted when the sidecar has them
+			if ((fieldName == TEXT("bindPoses")) && inSidecar(BlockType::BindPoses, 0))
+				return skipSidecarArray();
+			if ((fieldName == TEXT("inverseBindPoses")) && inSidecar(BlockType::InverseBindPoses, 0))
+				return skipSidecarArray();
+
+			if (fieldName == TEXT("boneIndexes")){
+				if (inSidecar(BlockType::BoneIndexes, 0))
+					return skipSidecarArray();
+				ok = readStreamArray(reader, boneIndexes, expectedVerts * 4);
+			}
+			else if (fieldName == TEXT("colors")){
+				if (inSidecar(BlockType::Colors, 0))
+					return skipSidecarArray();
+				ok = readStreamArray(reader, colors, expectedVerts * 4);
+			}
+			else if (fieldName == TEXT("subMeshes")){
+				subMeshes.Empty(expectedSubMeshes);
+				ok = readStreamObjArray(reader, [&](int32 index){
+					subMeshes.AddDefaulted();
+					return subMeshes.Last().loadFromStream(reader, inSidecar(BlockType::SubMeshTriangles, index));
+				});
+			}
+			else if (fieldName == TEXT("blendShapes")){
+				blendShapes.Empty(expectedBlendShapes);
+				ok = readStreamObjArray(reader, [&](int32 index){
+					blendShapes.AddDefaulted();
+					return blendShapes.Last().loadFromStream(reader, expectedVerts);
+				});
+			}
+			else
+				return StreamFieldResult::NotHandled;
+
+			return ok ? StreamFieldResult::Handled: StreamFieldResult::Failed;
+		}
+	);
+
+	if (!result)
+		return false;
+
+	loadHeader(header);
+	//Tree loader warned about missing "verts" through getFloatArray
+	if ((verts.Num() == 0) && !inSidecar(BlockType::Positions, 0))
+		UE_LOG(JsonLog, Warning, TEXT("Mesh %s(%d) has no vertex positions"), *name, id.id);
+	return true;
+}
+
+bool JsonSubMesh::loadFromStream(const JsonReaderRef &reader, bool skipTriangles){
+	using namespace JsonObjects;
+
+	JsonObjPtr header = MakeShareable(new FJsonObject());
+	return readStreamObject(reader, header, 
+		[&](const FString &fieldName, EJsonNotation valNotation){
+			if ((valNotation != EJsonNotation::ArrayStart) || (fieldName != TEXT("triangles")))
+				return StreamFieldResult::NotHandled;
+			bool ok = skipTriangles ? skipStreamValue(reader, valNotation): readStreamArray(reader, triangles);
+			return ok ? StreamFieldResult::Handled: StreamFieldResult::Failed;
+		}
+	);
+}
+
+bool JsonBlendShapeFrame::loadFromStream(const JsonReaderRef &reader, int32 vertexCount){
+	using namespace JsonObjects;
+
+	JsonObjPtr header = MakeShareable(new FJsonObject());
+	bool result = readStreamObject(reader, header, 
+		[&](const FString &fieldName, EJsonNotation valNotation){
+			if (valNotation != EJsonNotation::ArrayStart)
+				return StreamFieldResult::NotHandled;
+
+			FloatArray *dst = nullptr;
+			if (fieldName == TEXT("deltaVerts"))
+				dst = &deltaVerts;
+			else if (fieldName == TEXT("deltaTangents"))
+				dst = &deltaTangents;
+			else if (fieldName == TEXT("deltaNormals"))
+				dst = &deltaNormals;
+			else
+				return StreamFieldResult::NotHandled;
+
+			return readStreamArray(reader, *dst, vertexCount * 3) ? StreamFieldResult::Handled: StreamFieldResult::Failed;
+		}
+	);
+	if (!result)
+		return false;
+
+	JSON_GET_VAR(header, index);
+	JSON_GET_VAR(header, weight);
+	return true;
+}
+
+bool JsonBlendShape::loadFromStream(const JsonReaderRef &reader, int32 vertexCount){
+	using namespace JsonObjects;
+
+	int32 expectedFrames = 0;
+	JsonObjPtr header = MakeShareable(new FJsonObject());
+	bool result = readStreamObject(reader, header, 
+		[&](const FString &fieldName, EJsonNotation valNotation){
+			if ((valNotation == EJsonNotation::Number) && (fieldName == TEXT("numFrames"))){
+				expectedFrames = (int32)reader->GetValueAsNumber();
+				return StreamFieldResult::NotHandled;
+			}
+			if ((valNotation != EJsonNotation::ArrayStart) || (fieldName != TEXT("frames")))
+				return StreamFieldResult::NotHandled;
+
+			frames.Empty(expectedFrames);
+			bool ok = readStreamObjArray(reader, [&](int32 frameIndex){
+				frames.AddDefaulted();
+				return frames.Last().loadFromStream(reader, vertexCount);
+			});
+			return ok ? StreamFieldResult::Handled: StreamFieldResult::Failed;
+		}
+	);
+	if (!result)
+		return false;
+
+	JSON_GET_VAR(header, name);
+	JSON_GET_VAR(header, index);
+	JSON_GET_VAR(header, numFrames);
+	return true;
 }
 
 void JsonBlendShapeFrame::load(JsonObjPtr data){
@@ -113,6 +325,40 @@ FString JsonMesh::makeUnrealMeshName() const{
 	return result;
 }
 
+template<typename T> static void updateHashArray(FSHA1 &sha, const TArray<T> &data){
+	//Size prefix keeps streams of different lengths from producing the same byte sequence.
+	const int32 num = data.Num();
+	sha.Update((const uint8*)&num, sizeof(num));
+	if (num > 0)
+		sha.Update((const uint8*)data.GetData(), sizeof(T) * num);
+}
+
+FString JsonMesh::computeGeometryHash() const{
+	IMPORT_PROFILE_SCOPE_ASSET("JsonMesh::computeGeometryHash", name);
+	FSHA1 sha;
+	const int32 flags = (convexCollider ? 1: 0) | (triangleCollider ? 2: 0);
+	sha.Update((const uint8*)&flags, sizeof(flags));
+	sha.Update((const uint8*)&vertexCount, sizeof(vertexCount));
+	updateHashArray(sha, materials);
+
+	const FloatArray* floatStreams[] = {
+		&verts, &normals, &tangents, &uv0, &uv1, &uv2, &uv3, &uv4, &uv5, &uv6, &uv7
+	};
+	for(auto stream: floatStreams)
+		updateHashArray(sha, *stream);
+	updateHashArray(sha, colors);
+
+	const int32 numSubMeshes = subMeshes.Num();
+	sha.Update((const uint8*)&numSubMeshes, sizeof(numSubMeshes));
+	for(const auto &subMesh: subMeshes)
+		updateHashArray(sha, subMesh.triangles);
+
+	sha.Final();
+	uint8 digest[FSHA1::DigestSize];
+	sha.GetHash(digest);
+	return BytesToHex(digest, sizeof(digest));
+}
+
 const FVector JsonMesh::getVertex(int index) const{
 	return UnrealUtilities::getIdxVector3(verts, index);
 }
@@ -134,3 +380,238 @@ FVector JsonBlendShapeFrame::getDeltaTangent(int vertIdx) const{
 FVector JsonBlendShapeFrame::getDeltaNormal(int vertIdx) const{
 	return UnrealUtilities::getIdxVector3(deltaNormals, vertIdx);
 }
+
+void JsonMesh::generateLods(const TArray<float> &triangleFractions, const TArray<float> &screenSizes, bool optimizeVertexCache, 
+		const IntArray *vertexGroups){
+	ImportProfileScope profileScope(TEXT("JsonMesh::generateLods"), name);
+	lods.Empty();
+	check(triangleFractions.Num() == screenSizes.Num());
+
+	MeshSimplifier::IndexRangeArray prevRanges;
+	int32 numTriangles = 0;
+	for(const auto &subMesh: subMeshes){
+		prevRanges.Add(subMesh.triangles);
+		numTriangles += subMesh.triangles.Num() / 3;
+	}
+	profileScope.addElements(numTriangles);
+
+	int32 prevTriangles = numTriangles;
+	for(int32 i = 0; i < triangleFractions.Num(); i++){
+		const int32 target = FMath::Max(FMath::FloorToInt(numTriangles * triangleFractions[i]), 1);
+		if (target >= prevTriangles)
+			break;
+
+		MeshSimplifier::IndexRangeArray lodRanges;
+		auto error = MeshSimplifier::simplify(verts, prevRanges, target, lodRanges, vertexGroups);
+		int32 lodTriangles = 0;
+		for(const auto &range: lodRanges)
+			lodTriangles += range.Num() / 3;
+
+		//Locked borders and seams can prevent further reduction, such lod only costs memory.
+		if (lodTriangles > (prevTriangles * 9) / 10){
+			UE_LOG(JsonLog, Log, TEXT("Mesh %s: lod %d stalled at %d triangles (target %d), no further lods generated"), 
+				*name, i + 1, lodTriangles, target);
+			break;
+		}
+		UE_LOG(JsonLog, Log, TEXT("Mesh %s: lod %d has %d triangles out of %d, error %f"), 
+			*name, i + 1, lodTriangles, numTriangles, error);
+
+		auto &lod = lods.AddDefaulted_GetRef();
+		lod.screenSize = screenSizes[i];
+		lod.subMeshTriangles = lodRanges;
+		if (optimizeVertexCache){
+			for(auto &range: lod.subMeshTriangles)
+				MeshRenderOptimizer::optimizeVertexCache(range, verts.Num() / 3);
+		}
+		prevRanges = MoveTemp(lodRanges);
+		prevTriangles = lodTriangles;
+	}
+}
+
+IntArray JsonMesh::getDominantBones() const{
+	IntArray result;
+	const int32 numVerts = verts.Num() / 3;
+	if ((numVerts == 0) || (boneIndexes.Num() == 0))
+		return result;
+	const int32 influencesPerVertex = boneIndexes.Num() / numVerts;
+	if ((influencesPerVertex <= 0) || (boneWeights.Num() < numVerts * influencesPerVertex))
+		return result;
+
+	result.SetNumUninitialized(numVerts);
+	for(int32 vertIndex = 0; vertIndex < numVerts; vertIndex++){
+		int32 bestBone = -1;
+		float bestWeight = 0.0f;
+		for(int32 i = vertIndex * influencesPerVertex; i < (vertIndex + 1) * influencesPerVertex; i++){
+			if (boneWeights[i] > bestWeight){
+				bestWeight = boneWeights[i];
+				bestBone = boneIndexes[i];
+			}
+		}
+		result[vertIndex] = bestBone;
+	}
+	return result;
+}
+
+const IntArray& JsonMesh::getSubMeshTriangles(int32 lod, int32 subMeshIndex) const{
+	if ((lod > 0) && (lod <= lods.Num()))
+		return lods[lod - 1].subMeshTriangles[subMeshIndex];
+	return subMeshes[subMeshIndex].triangles;
+}
+
+bool JsonMesh::hasValidStreamLayout(int32 numVerts){
+	bool result = true;
+	forEachVertexStream([&](const auto &arr){
+		if ((arr.Num() != 0) && ((numVerts <= 0) || ((arr.Num() % numVerts) != 0))){
+			UE_LOG(JsonLog, Warning, TEXT("Mesh %s: stream of %d elements does not match %d vertices"), *name, arr.Num(), numVerts);
+			result = false;
+		}
+	});
+	return result;
+}
+
+bool JsonMesh::optimizeForRendering(bool reorderForOverdraw){
+	ImportProfileScope profileScope(TEXT("JsonMesh::optimizeForRendering"), name);
+	const int32 numVerts = verts.Num() / 3;
+	if (numVerts <= 0)
+		return false;
+	profileScope.addElements(numVerts);
+
+	if (!hasValidStreamLayout(numVerts)){
+		UE_LOG(JsonLog, Warning, TEXT("Mesh %s will not be optimized"), *name);
+		return false;
+	}
+
+	TArray<MeshRenderOptimizer::VertexStream> streams;
+	forEachVertexStream([&](const auto &arr){
+		if (arr.Num() == 0)
+			return;
+		MeshRenderOptimizer::VertexStream stream;
+		stream.data = (const uint8*)arr.GetData();
+		stream.stride = arr.GetTypeSize() * (arr.Num() / numVerts);
+		streams.Add(stream);
+	});
+
+	auto remapMesh = [&](const TArray<int32> &remap, int32 srcNumVerts, int32 dstNumVerts){
+		forEachVertexStream([&](auto &arr){
+			MeshRenderOptimizer::remapVertexStream(arr, srcNumVerts, remap, dstNumVerts);
+		});
+		for(auto &subMesh: subMeshes)
+			MeshRenderOptimizer::remapIndices(subMesh.triangles, remap);
+		for(auto &lod: lods){
+			for(auto &range: lod.subMeshTriangles)
+				MeshRenderOptimizer::remapIndices(range, remap);
+		}
+		vertexCount = dstNumVerts;
+	};
+
+	TArray<int32> remap;
+	const int32 numUnique = MeshRenderOptimizer::buildWeldRemap(numVerts, streams, remap);
+	if (numUnique < numVerts)
+		remapMesh(remap, numVerts, numUnique);
+
+	float acmrBefore = 0.0f, acmrAfter = 0.0f;
+	TArray<int32> allTriangles;
+	for(auto &subMesh: subMeshes){
+		auto &triangles = subMesh.triangles;
+		triangles.SetNum(triangles.Num() - (triangles.Num() % 3));
+		acmrBefore += MeshRenderOptimizer::computeACMR(triangles, numUnique) * (triangles.Num() / 3);
+		MeshRenderOptimizer::optimizeVertexCache(triangles, numUnique);
+		if (reorderForOverdraw)
+			MeshRenderOptimizer::optimizeOverdraw(triangles, verts);
+		acmrAfter += MeshRenderOptimizer::computeACMR(triangles, numUnique) * (triangles.Num() / 3);
+		allTriangles.Append(triangles);
+	}
+
+	MeshRenderOptimizer::buildFetchRemap(allTriangles, numUnique, remap);
+	remapMesh(remap, numUnique, numUnique);
+
+	const int32 numTriangles = FMath::Max(allTriangles.Num() / 3, 1);
+	UE_LOG(JsonLog, Log, TEXT("Mesh %s optimized: %d verts welded to %d, ACMR %f -> %f"), 
+		*name, numVerts, numUnique, acmrBefore / numTriangles, acmrAfter / numTriangles);
+	return true;
+}
+
+double JsonMesh::computeSurfaceArea() const{
+	double result = 0.0;
+	for(const auto &subMesh: subMeshes)
+		result += LightmapUvGenerator::computeSurfaceArea(verts, subMesh.triangles);
+	return result;
+}
+
+bool JsonMesh::generateLightmapUvs(int32 resolution){
+	ImportProfileScope profileScope(TEXT("JsonMesh::generateLightmapUvs"), name);
+	const int32 numVerts = verts.Num() / 3;
+	if (numVerts <= 0)
+		return false;
+	if (lods.Num() > 0){
+		UE_LOG(JsonLog, Warning, TEXT("Mesh %s: lightmap uvs can't be generated after lods"), *name);
+		return false;
+	}
+	if (!hasValidStreamLayout(numVerts)){
+		UE_LOG(JsonLog, Warning, TEXT("Mesh %s: lightmap uvs will not be generated"), *name);
+		return false;
+	}
+
+	TArray<int32> allTriangles;
+	for(auto &subMesh: subMeshes){
+		auto &triangles = subMesh.triangles;
+		triangles.SetNum(triangles.Num() - (triangles.Num() % 3));
+		allTriangles.Append(triangles);
+	}
+	profileScope.addElements(allTriangles.Num() / 3);
+
+	TArray<float> cornerUvs;
+	const int32 numCharts = LightmapUvGenerator::generate(verts, allTriangles, resolution, cornerUvs);
+	if (numCharts <= 0)
+		return false;
+
+	//Each corner is (source vertex, lightmap uv). Corners that agree on both become one vertex, the rest are split along chart seams.
+	struct CornerVertex{
+		int32 vert;
+		float u;
+		float v;
+	};
+	const int32 numCorners = allTriangles.Num();
+	TArray<CornerVertex> corners;
+	corners.SetNumUninitialized(numCorners);
+	for(int32 i = 0; i < numCorners; i++){
+		corners[i].vert = allTriangles[i];
+		corners[i].u = cornerUvs[i * 2];
+		corners[i].v = cornerUvs[i * 2 + 1];
+	}
+	TArray<MeshRenderOptimizer::VertexStream> streams;
+	MeshRenderOptimizer::VertexStream stream;
+	stream.data = (const uint8*)corners.GetData();
+	stream.stride = sizeof(CornerVertex);
+	streams.Add(stream);
+	TArray<int32> cornerRemap;
+	const int32 newNumVerts = MeshRenderOptimizer::buildWeldRemap(numCorners, streams, cornerRemap);
+
+	TArray<int32> newToOld;
+	newToOld.SetNumUninitialized(newNumVerts);
+	for(int32 i = 0; i < numCorners; i++)
+		newToOld[cornerRemap[i]] = corners[i].vert;
+
+	uv1.Empty();
+	forEachVertexStream([&](auto &arr){
+		MeshRenderOptimizer::gatherVertexStream(arr, numVerts, newToOld);
+	});
+	//Stored in unity convention, flipped back by unityUvToUnreal
+	uv1.SetNumUninitialized(newNumVerts * 2);
+	for(int32 i = 0; i < numCorners; i++){
+		const int32 dst = cornerRemap[i];
+		uv1[dst * 2] = corners[i].u;
+		uv1[dst * 2 + 1] = 1.0f - corners[i].v;
+	}
+
+	int32 cornerOffset = 0;
+	for(auto &subMesh: subMeshes){
+		for(auto &index: subMesh.triangles)
+			index = cornerRemap[cornerOffset++];
+	}
+	vertexCount = newNumVerts;
+
+	UE_LOG(JsonLog, Log, TEXT("Mesh %s: lightmap uvs generated, %d charts, %d verts split to %d"),
+		*name, numCharts, numVerts, newNumVerts);
+	return true;
+}
@@ -15,6 +15,7 @@ public:
 	FVector getDeltaNormal(int index) const;
 
 	void load(JsonObjPtr data);
+	bool loadFromStream(const JsonReaderRef &reader, int32 vertexCount = 0);
 	JsonBlendShapeFrame(JsonObjPtr data){
 		load(data);
 	}
@@ -29,6 +30,7 @@ public:
 	TArray<JsonBlendShapeFrame> frames;
 
 	void load(JsonObjPtr data);
+	bool loadFromStream(const JsonReaderRef &reader, int32 vertexCount = 0);
 	JsonBlendShape(JsonObjPtr data){
 		load(data);
 	}
@@ -40,11 +42,36 @@ public:
 	IntArray triangles;
 	JsonSubMesh() = default;
 	void load(JsonObjPtr data);
+	//skipTriangles is set when the binary sidecar provides the index data
+	bool loadFromStream(const JsonReaderRef &reader, bool skipTriangles = false);
 	JsonSubMesh(JsonObjPtr data){
 		load(data);
 	}
 };
 
+/*
+Simple collision generated for a static mesh.
+*/
+enum class MeshSimpleCollision{
+	//18-DOP hull, falling back to a box. Used when no collision policy is applied.
+	KDop18,
+	None,
+	//No simple shapes, complex geometry is used as simple collision
+	Complex,
+	Box,
+	Sphere,
+	ConvexHulls
+};
+
+/*
+Generated level of detail. Triangles index the vertex streams of the owning mesh.
+*/
+class JsonMeshLod{
+public:
+	float screenSize = 1.0f;
+	TArray<IntArray> subMeshTriangles;
+};
+
 class JsonMesh{
 public:
 	ResId id;
@@ -121,6 +148,56 @@ public:
 
 	FString makeUnrealMeshName() const;
 
+	/*
+	Hash of everything that ends up in the static mesh asset: vertex streams, triangles, material list and collision flags.
+	Meshes with equal geometry hashes can share one UStaticMesh. geometryHash is filled on the preparation thread
+	when the mesh is scheduled, and may be empty for meshes loaded in other ways.
+	*/
+	FString geometryHash;
+	FString computeGeometryHash() const;
+	FString getGeometryHash() const{
+		return geometryHash.IsEmpty() ? computeGeometryHash(): geometryHash;
+	}
+
+	/*
+	LOD1 and further, generated at import time. Empty unless generateLods was called.
+	*/
+	TArray<JsonMeshLod> lods;
+	/*
+	Each lod is simplified from the previous one. Generation stops early once simplification stalls.
+	vertexGroups restrict collapses to vertices of the same group (see MeshSimplifier::simplify).
+	*/
+	void generateLods(const TArray<float> &triangleFractions, const TArray<float> &screenSizes, bool optimizeVertexCache = false, 
+		const IntArray *vertexGroups = nullptr);
+	//Strongest bone of every vertex, -1 for vertices without positive weights. Empty for meshes without bone weights.
+	IntArray getDominantBones() const;
+	/*
+	Welds identical vertices, reorders submesh triangles for vertex cache and, optionally, overdraw, then reorders 
+	vertex streams by first use (see MeshRenderOptimizer). Returns false if stream layout is not recognized, mesh is not changed then.
+	*/
+	bool optimizeForRendering(bool reorderForOverdraw);
+	//lod 0 returns original submesh triangles
+	const IntArray& getSubMeshTriangles(int32 lod, int32 subMeshIndex) const;
+
+	/*
+	Lightmap resolution chosen at import time, 0 means default. 
+	*/
+	int32 lightmapResolution = 0;
+	//Area of all submesh triangles, in unity units.
+	double computeSurfaceArea() const;
+	/*
+	Unwraps the mesh into uv1 (see LightmapUvGenerator), splitting vertices along chart seams.
+	Must be called before generateLods. Returns false if stream layout is not recognized, mesh is not changed then.
+	*/
+	bool generateLightmapUvs(int32 resolution);
+
+	/*
+	Collision chosen at import time (see JsonImporter::prepareMeshCollision). convexHulls are point clouds 
+	in unity space, used with MeshSimpleCollision::ConvexHulls.
+	*/
+	MeshSimpleCollision simpleCollision = MeshSimpleCollision::KDop18;
+	TArray<FloatArray> convexHulls;
+
 	bool hasBoneWeights() const{
 		return (boneWeights.Num() > 0) || (boneIndexes.Num() > 0);
 	}
@@ -131,6 +208,37 @@ public:
 
 	JsonMesh() = default;
 	void load(JsonObjPtr data);
+	/*
+	Reads mesh directly from json stream, without building json object tree for vertex data. 
+	Bulk arrays are written into typed arrays, remaining fields are processed via loadHeader.
+	Arrays whose JsonBinaryMesh::getBlockKey() is in sidecarBlocks are skipped, the caller loads them from the sidecar.
+	*/
+	bool loadFromStream(const JsonReaderRef &reader, const TSet<uint64> *sidecarBlocks = nullptr);
+protected:
+	void loadHeader(JsonObjPtr data);
+	void loadBulkData(JsonObjPtr data);
+
+	//Every per-vertex array has to be listed here, otherwise welding and vertex splitting would corrupt the mesh
+	template<typename Callback> void forEachVertexStream(Callback callback){
+		callback(verts);
+		callback(normals);
+		callback(tangents);
+		callback(colors);
+		callback(uv0); callback(uv1); callback(uv2); callback(uv3);
+		callback(uv4); callback(uv5); callback(uv6); callback(uv7);
+		callback(boneWeights);
+		callback(boneIndexes);
+		for(auto &blendShape: blendShapes){
+			for(auto &frame: blendShape.frames){
+				callback(frame.deltaVerts);
+				callback(frame.deltaNormals);
+				callback(frame.deltaTangents);
+			}
+		}
+	}
+	//Checks that every stream holds the same number of elements per vertex
+	bool hasValidStreamLayout(int32 numVerts);
+public:
 	JsonMesh(JsonObjPtr data){
 		load(data);
 	}
@@ -1,6 +1,7 @@
 #include "JsonImportPrivatePCH.h"
 #include "JsonSkeleton.h"
 #include "macros.h"
+#include "UnrealUtilities.h"
 
 using namespace JsonObjects;
 
@@ -10,12 +11,81 @@ void JsonSkeleton::load(JsonObjPtr data){
 	//JSON_GET_VAR(data, defaultBoneNames);
 
 	getJsonObjArray(data, bones, "bones");
+	buildIndex();
 }
 
 int JsonSkeleton::findBoneIndex(const FString &boneName) const{
-	for(int i = 0; i < bones.Num(); i++){
-		if (bones[i].name == boneName)
-			return i;
+	auto found = boneIndexMap.Find(boneName);
+	return found ? *found: -1;
+}
+
+int JsonSkeleton::findRefBoneIndex(const FString &boneName) const{
+	auto boneIndex = findBoneIndex(boneName);
+	return (boneIndex >= 0) ? refBoneIndices[boneIndex]: -1;
+}
+
+void JsonSkeleton::buildIndex(){
+	const int32 numBones = bones.Num();
+	boneIndexMap.Empty(numBones);
+	for(int32 boneIndex = 0; boneIndex < numBones; boneIndex++){
+		//First bone wins on duplicate names, same as the linear search did
+		if (!boneIndexMap.Contains(bones[boneIndex].name))
+			boneIndexMap.Add(bones[boneIndex].name, boneIndex);
+	}
+
+	/*
+	Parents are placed before children by walking up from every bone that is not placed yet.
+	A parent link that points out of range or closes a cycle is dropped, the bone becomes a root.
+	*/
+	IntArray parents;
+	parents.SetNumUninitialized(numBones);
+	for(int32 boneIndex = 0; boneIndex < numBones; boneIndex++){
+		const auto parentId = bones[boneIndex].parentId;
+		parents[boneIndex] = ((parentId >= 0) && (parentId < numBones)) ? parentId: INDEX_NONE;
+	}
+
+	enum class Visit: uint8{
+		None, InProgress, Done
+	};
+	TArray<Visit> visits;
+	visits.Init(Visit::None, numBones);
+	refBoneOrder.Reset(numBones);
+	refBoneIndices.Init(INDEX_NONE, numBones);
+	IntArray chain;
+	for(int32 boneIndex = 0; boneIndex < numBones; boneIndex++){
+		chain.Reset();
+		for(int32 cur = boneIndex; (cur != INDEX_NONE) && (visits[cur] != Visit::Done); cur = parents[cur]){
+			if (visits[cur] == Visit::InProgress){
+				//The last bone of the chain closes the cycle
+				const int32 last = chain.Last();
+				UE_LOG(JsonLog, Warning, TEXT("Skeleton %s(%d): parent of bone \"%s\" forms a cycle, it will be a root bone"),
+					*name, id, *bones[last].name);
+				parents[last] = INDEX_NONE;
+				break;
+			}
+			visits[cur] = Visit::InProgress;
+			chain.Add(cur);
+		}
+		for(int32 i = chain.Num() - 1; i >= 0; i--){
+			const int32 cur = chain[i];
+			visits[cur] = Visit::Done;
+			refBoneIndices[cur] = refBoneOrder.Add(cur);
+		}
+	}
+
+	refParentIndices.SetNumUninitialized(numBones);
+	unrealWorldBindMatrices.SetNumUninitialized(numBones);
+	unrealInvWorldBindMatrices.SetNumUninitialized(numBones);
+	unrealLocalBindMatrices.SetNumUninitialized(numBones);
+	for(int32 refIndex = 0; refIndex < numBones; refIndex++){
+		const int32 boneIndex = refBoneOrder[refIndex];
+		const int32 parentIndex = parents[boneIndex];
+		refParentIndices[refIndex] = (parentIndex != INDEX_NONE) ? refBoneIndices[parentIndex]: INDEX_NONE;
+
+		const auto unrealWorld = UnrealUtilities::unityWorldToUe(bones[boneIndex].world);
+		unrealWorldBindMatrices[boneIndex] = unrealWorld;
+		unrealInvWorldBindMatrices[boneIndex] = unrealWorld.Inverse();
+		unrealLocalBindMatrices[boneIndex] = (parentIndex != INDEX_NONE) ? 
+			unrealWorld * unrealInvWorldBindMatrices[parentIndex]: unrealWorld;
 	}
-	return -1;
 }
@@ -10,10 +10,28 @@ public:
 
 	TArray<JsonSkeletonBone> bones;
 	int findBoneIndex(const FString &name) const;
+	//Index of the bone in the reference skeleton, -1 if not found
+	int findRefBoneIndex(const FString &name) const;
+
+	/*
+	Lookup data built once when the skeleton is loaded, shared by all meshes and animations that use the skeleton.
+
+	Reference skeleton lists parents before children. refBoneOrder maps reference skeleton index to bone index, 
+	refBoneIndices maps it back, refParentIndices holds parent reference index of every reference bone (INDEX_NONE for roots).
+	Bind matrices are indexed by bone and hold bone world matrices converted to unreal space, local ones are relative to the parent.
+	*/
+	TMap<FString, int32> boneIndexMap;
+	IntArray refBoneOrder;
+	IntArray refBoneIndices;
+	IntArray refParentIndices;
+	MatrixArray unrealWorldBindMatrices;
+	MatrixArray unrealInvWorldBindMatrices;
+	MatrixArray unrealLocalBindMatrices;
+	void buildIndex();
 
 	void load(JsonObjPtr data);
 	JsonSkeleton() = default;
 	JsonSkeleton(JsonObjPtr data){
 		load(data);
 	}
-};
\ No newline at end of file
+};
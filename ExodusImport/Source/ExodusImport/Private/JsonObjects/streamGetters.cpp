@@ -0,0 +1,162 @@
+#include "JsonImportPrivatePCH.h"
+#include "streamGetters.h"
+#include "Serialization/JsonReader.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+
+using namespace JsonObjects;
+
+static void logStreamError(const JsonReaderRef &reader, const TCHAR *context){
+	UE_LOG(JsonLog, Warning, TEXT("Json stream error while reading %s: %s (line %d, char %d)"),
+		context, *reader->GetErrorMessage(), reader->GetLineNumber(), reader->GetCharacterNumber());
+}
+
+JsonValPtr JsonObjects::readStreamValue(const JsonReaderRef &reader, EJsonNotation notation){
+	switch(notation){
+		case EJsonNotation::String:
+			return MakeShareable(new FJsonValueString(reader->GetValueAsString()));
+		case EJsonNotation::Number:
+			return MakeShareable(new FJsonValueNumber(reader->GetValueAsNumber()));
+		case EJsonNotation::Boolean:
+			return MakeShareable(new FJsonValueBoolean(reader->GetValueAsBoolean()));
+		case EJsonNotation::Null:
+			return MakeShareable(new FJsonValueNull());
+		case EJsonNotation::ObjectStart:{
+			JsonObjPtr obj = MakeShareable(new FJsonObject());
+			if (!readStreamObject(reader, obj, nullptr))
+				return nullptr;
+			return MakeShareable(new FJsonValueObject(obj));
+		}
+		case EJsonNotation::ArrayStart:{
+			JsonValPtrs values;
+			EJsonNotation curNotation;
+			while(reader->ReadNext(curNotation)){
+				if (curNotation == EJsonNotation::ArrayEnd)
+					return MakeShareable(new FJsonValueArray(values));
+				auto curVal = readStreamValue(reader, curNotation);
+				if (!curVal.IsValid())
+					return nullptr;
+				values.Add(curVal);
+			}
+			logStreamError(reader, TEXT("array"));
+			return nullptr;
+		}
+		default:
+			logStreamError(reader, TEXT("value"));
+			return nullptr;
+	}
+}
+
+bool JsonObjects::skipStreamValue(const JsonReaderRef &reader, EJsonNotation notation){
+	if ((notation != EJsonNotation::ObjectStart) && (notation != EJsonNotation::ArrayStart))
+		return notation != EJsonNotation::Error;
+
+	int32 depth = 1;
+	EJsonNotation curNotation;
+	while((depth > 0) && reader->ReadNext(curNotation)){
+		switch(curNotation){
+			case EJsonNotation::ObjectStart:
+			case EJsonNotation::ArrayStart:
+				depth++;
+				break;
+			case EJsonNotation::ObjectEnd:
+			case EJsonNotation::ArrayEnd:
+				depth--;
+				break;
+			case EJsonNotation::Error:
+				logStreamError(reader, TEXT("skipped value"));
+				return false;
+			default:
+				break;
+		}
+	}
+	return depth == 0;
+}
+
+bool JsonObjects::readStreamObject(const JsonReaderRef &reader, JsonObjPtr outObj, StreamFieldHandler handler){
+	EJsonNotation notation;
+	while(reader->ReadNext(notation)){
+		if (notation == EJsonNotation::ObjectEnd)
+			return true;
+		if (notation == EJsonNotation::Error)
+			break;
+
+		//Identifier must be copied before reading nested values
+		const FString fieldName = reader->GetIdentifier();
+		if (handler){
+			auto handled = handler(fieldName, notation);
+			if (handled == StreamFieldResult::Failed){
+				UE_LOG(JsonLog, Warning, TEXT("Could not read field \"%s\" from json stream"), *fieldName);
+				return false;
+			}
+			if (handled == StreamFieldResult::Handled)
+				continue;
+		}
+
+		if (!outObj.IsValid()){
+			if (!skipStreamValue(reader, notation))
+				return false;
+			continue;
+		}
+
+		auto val = readStreamValue(reader, notation);
+		if (!val.IsValid())
+			return false;
+		outObj->SetField(fieldName, val);
+	}
+	logStreamError(reader, TEXT("object"));
+	return false;
+}
+
+template<typename T> static bool readStreamNumberArray(const JsonReaderRef &reader, TArray<T> &outData, int32 reserveHint){
+	outData.Empty(reserveHint > 0 ? reserveHint: 0);
+	EJsonNotation notation;
+	while(reader->ReadNext(notation)){
+		switch(notation){
+			case EJsonNotation::ArrayEnd:
+				return true;
+			case EJsonNotation::Number:
+				outData.Add((T)reader->GetValueAsNumber());
+				break;
+			case EJsonNotation::Null:
+				//matches toFloatArray/toByteArray behavior for non-numeric values
+				outData.Add(T(0));
+				break;
+			default:
+				logStreamError(reader, TEXT("number array"));
+				return false;
+		}
+	}
+	logStreamError(reader, TEXT("number array"));
+	return false;
+}
+
+bool JsonObjects::readStreamArray(const JsonReaderRef &reader, FloatArray &outData, int32 reserveHint){
+	return readStreamNumberArray(reader, outData, reserveHint);
+}
+
+bool JsonObjects::readStreamArray(const JsonReaderRef &reader, IntArray &outData, int32 reserveHint){
+	return readStreamNumberArray(reader, outData, reserveHint);
+}
+
+bool JsonObjects::readStreamArray(const JsonReaderRef &reader, ByteArray &outData, int32 reserveHint){
+	return readStreamNumberArray(reader, outData, reserveHint);
+}
+
+bool JsonObjects::readStreamObjArray(const JsonReaderRef &reader, std::function<bool(int32 index)> objReader){
+	EJsonNotation notation;
+	int32 index = 0;
+	while(reader->ReadNext(notation)){
+		if (notation == EJsonNotation::ArrayEnd)
+			return true;
+		if (notation != EJsonNotation::ObjectStart){
+			logStreamError(reader, TEXT("object array"));
+			return false;
+		}
+		if (!objReader(index))
+			return false;
+		index++;
+	}
+	logStreamError(reader, TEXT("object array"));
+	return false;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "JsonTypes.h"
+#include <functional>
+
+/*
+Pull-style (TJsonReader::ReadNext) helpers. These are used for large resources (meshes)
+where building full FJsonObject tree means one heap allocated FJsonValue per float.
+
+Numeric arrays are written directly into typed arrays, everything else can be collected
+into a small "header" object and then processed with regular getters.
+*/
+namespace JsonObjects{
+	enum class StreamFieldResult{
+		NotHandled = 0,
+		Handled,
+		Failed
+	};
+
+	/*
+	Called for every field of an object. "notation" is the notation of field value
+	(ArrayStart/ObjectStart/String/Number, etc). If the handler consumes the value, it should read
+	it completely (up to matching ArrayEnd/ObjectEnd) and return Handled.
+	*/
+	using StreamFieldHandler = std::function<StreamFieldResult(const FString &fieldName, EJsonNotation notation)>;
+
+	/*
+	Expects ObjectStart to be already consumed. Reads fields till the matching ObjectEnd.
+	Fields not handled by the handler are stored in outObj (if it is valid) or skipped.
+	*/
+	bool readStreamObject(const JsonReaderRef &reader, JsonObjPtr outObj, StreamFieldHandler handler);
+
+	/*
+	Reads value that starts with "notation". For ObjectStart/ArrayStart reads whole subtree.
+	*/
+	JsonValPtr readStreamValue(const JsonReaderRef &reader, EJsonNotation notation);
+	bool skipStreamValue(const JsonReaderRef &reader, EJsonNotation notation);
+
+	/*
+	Expect ArrayStart to be already consumed. reserveHint is used to preallocate the array.
+	*/
+	bool readStreamArray(const JsonReaderRef &reader, FloatArray &outData, int32 reserveHint = 0);
+	bool readStreamArray(const JsonReaderRef &reader, IntArray &outData, int32 reserveHint = 0);
+	bool readStreamArray(const JsonReaderRef &reader, ByteArray &outData, int32 reserveHint = 0);
+
+	/*
+	Expects ArrayStart to be already consumed. Calls objReader for every ObjectStart in the array.
+	*/
+	bool readStreamObjArray(const JsonReaderRef &reader, std::function<bool(int32 index)> objReader);
+
+	template<typename T> bool readStreamObjArray(const JsonReaderRef &reader, TArray<T> &outData, int32 reserveHint = 0){
+		outData.Empty(reserveHint);
+		return readStreamObjArray(reader, [&](int32 index){
+			outData.AddDefaulted();
+			return outData.Last().loadFromStream(reader);
+		});
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "CoreMinimal.h"
+
+/*
+Automatic lightmap uv unwrapping.
+
+Triangles are grouped into charts: connected (by position, so existing uv seams do not matter) triangles whose normals
+are within maxChartAngle degrees of the running average normal of the chart. Each chart is projected onto the plane of 
+its average normal, triangles that flip or overlap the chart in that projection are moved to new charts.
+All charts share one scale, so texel density is uniform over the mesh, and are shelf-packed into the unit square.
+*/
+class LightmapUvGenerator{
+public:
+	/*
+	positions are xyz triplets, indices is a triangle list. outCornerUvs receives an u, v pair for every index.
+	Charts are separated by at least padTexels texels at the given lightmap resolution. Returns number of charts.
+	*/
+	static int32 generate(const TArray<float> &positions, const TArray<int32> &indices, int32 resolution,
+		TArray<float> &outCornerUvs, float maxChartAngle = 60.0f, float padTexels = 2.0f);
+
+	static double computeSurfaceArea(const TArray<float> &positions, const TArray<int32> &indices);
+	/*
+	Power of two lightmap resolution that gives texelsPerUnit texels per unit of length on a surface of the given area,
+	allowing for unused atlas space. Clamped to minResolution..maxResolution.
+	*/
+	static int32 computeResolution(double surfaceArea, float texelsPerUnit, int32 minResolution, int32 maxResolution);
+};
@@ -0,0 +1,42 @@
+#include "JsonImportPrivatePCH.h"
+#include "MappedFileData.h"
+#include "JsonLog.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+
+bool MappedFileData::open(const FString &filename){
+	close();
+
+	fileHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*filename));
+	if (fileHandle.IsValid() && (fileHandle->GetFileSize() > 0)){
+		fileRegion.Reset(fileHandle->MapRegion(0, fileHandle->GetFileSize()));
+		if (fileRegion.IsValid()){
+			data = fileRegion->GetMappedPtr();
+			size = fileRegion->GetMappedSize();
+			return true;
+		}
+	}
+	fileHandle.Reset();
+
+	if (!FFileHelper::LoadFileToArray(fallbackData, *filename)){
+		UE_LOG(JsonLog, Warning, TEXT("Could not open file \"%s\""), *filename);
+		return false;
+	}
+	data = fallbackData.GetData();
+	size = fallbackData.Num();
+	return true;
+}
+
+void MappedFileData::close(){
+	//region must be released before the file handle
+	fileRegion.Reset();
+	fileHandle.Reset();
+	fallbackData.Empty();
+	data = nullptr;
+	size = 0;
+}
+
+MappedFileData::~MappedFileData(){
+	close();
+}
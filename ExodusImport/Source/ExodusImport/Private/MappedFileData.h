@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/*
+Read-only view of the whole file. Uses memory mapping when the platform supports it,
+otherwise falls back to reading the file into memory.
+*/
+class MappedFileData{
+protected:
+	TUniquePtr<IMappedFileHandle> fileHandle;
+	TUniquePtr<IMappedFileRegion> fileRegion;
+	TArray<uint8> fallbackData;
+	const uint8* data = nullptr;
+	int64 size = 0;
+public:
+	bool open(const FString &filename);
+	void close();
+
+	const uint8* getData() const{
+		return data;
+	}
+	int64 getSize() const{
+		return size;
+	}
+	bool isOpen() const{
+		return data != nullptr;
+	}
+	bool isMapped() const{
+		return fileRegion.IsValid();
+	}
+
+	MappedFileData() = default;
+	MappedFileData(const MappedFileData&) = delete;
+	MappedFileData& operator=(const MappedFileData&) = delete;
+	~MappedFileData();
+};
@@ -0,0 +1,117 @@
+#include "JsonImportPrivatePCH.h"
+#include "MappedUtf8Archive.h"
+#include "JsonLog.h"
+
+MappedUtf8Archive::MappedUtf8Archive(){
+	SetIsLoading(true);
+	SetIsPersistent(false);
+}
+
+MappedUtf8Archive::~MappedUtf8Archive(){
+	close();
+}
+
+bool MappedUtf8Archive::hasWideBom(const uint8 *data, int64 size){
+	if (size < 2)
+		return false;
+	return ((data[0] == 0xFF) && (data[1] == 0xFE)) || ((data[0] == 0xFE) && (data[1] == 0xFF));
+}
+
+bool MappedUtf8Archive::open(const FString &filename){
+	close();
+	if (!fileData.open(filename))
+		return false;
+
+	cur = fileData.getData();
+	end = cur + fileData.getSize();
+	if (hasWideBom(cur, fileData.getSize())){
+		UE_LOG(JsonLog, Log, TEXT("File \"%s\" is not UTF-8"), *filename);
+		close();
+		return false;
+	}
+
+	//UTF-8 BOM
+	if ((end - cur >= 3) && (cur[0] == 0xEF) && (cur[1] == 0xBB) && (cur[2] == 0xBF))
+		cur += 3;
+	return true;
+}
+
+void MappedUtf8Archive::close(){
+	fileData.close();
+	cur = end = nullptr;
+	pendingChar = 0;
+	ClearError();
+}
+
+TCHAR MappedUtf8Archive::decodeNext(){
+	if (pendingChar){
+		auto result = pendingChar;
+		pendingChar = 0;
+		return result;
+	}
+
+	const uint8 lead = *cur++;
+	if (lead < 0x80)
+		return (TCHAR)lead;
+
+	int32 numTrail = 0;
+	uint32 codePoint = 0;
+	if ((lead & 0xE0) == 0xC0){
+		numTrail = 1;
+		codePoint = lead & 0x1F;
+	}
+	else if ((lead & 0xF0) == 0xE0){
+		numTrail = 2;
+		codePoint = lead & 0x0F;
+	}
+	else if ((lead & 0xF8) == 0xF0){
+		numTrail = 3;
+		codePoint = lead & 0x07;
+	}
+	else
+		return TEXT('?');
+
+	for(int32 i = 0; i < numTrail; i++){
+		if ((cur >= end) || ((*cur & 0xC0) != 0x80))
+			return TEXT('?');
+		codePoint = (codePoint << 6) | (*cur++ & 0x3F);
+	}
+
+	if ((codePoint > 0x10FFFF) || ((codePoint >= 0xD800) && (codePoint <= 0xDFFF)))
+		return TEXT('?');
+
+	if ((sizeof(TCHAR) == 2) && (codePoint > 0xFFFF)){
+		codePoint -= 0x10000;
+		pendingChar = (TCHAR)(0xDC00 + (codePoint & 0x3FF));
+		return (TCHAR)(0xD800 + (codePoint >> 10));
+	}
+	return (TCHAR)codePoint;
+}
+
+void MappedUtf8Archive::Serialize(void *data, int64 num){
+	check((num % sizeof(TCHAR)) == 0);
+	TCHAR *outChars = (TCHAR*)data;
+	const int64 numChars = num / sizeof(TCHAR);
+	for(int64 i = 0; i < numChars; i++){
+		if (AtEnd()){
+			SetError();
+			FMemory::Memzero(outChars + i, (numChars - i) * sizeof(TCHAR));
+			return;
+		}
+		outChars[i] = decodeNext();
+	}
+}
+
+int64 MappedUtf8Archive::Tell(){
+	if (!fileData.isOpen())
+		return 0;
+	return cur - fileData.getData();
+}
+
+int64 MappedUtf8Archive::TotalSize(){
+	return fileData.getSize();
+}
+
+bool MappedUtf8Archive::AtEnd(){
+	return !pendingChar && (cur >= end);
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Serialization/Archive.h"
+#include "MappedFileData.h"
+
+/*
+Loading archive that exposes a memory-mapped UTF-8 file as a stream of TCHAR.
+
+Characters are decoded only as the reader requests them, so feeding it to TJsonReader<TCHAR>
+avoids widening the whole file into an FString first. Tell()/TotalSize() are in source bytes.
+Malformed sequences are replaced with '?'.
+*/
+class MappedUtf8Archive: public FArchive{
+protected:
+	MappedFileData fileData;
+	const uint8 *cur = nullptr;
+	const uint8 *end = nullptr;
+	//second half of a surrogate pair on platforms with 16-bit TCHAR
+	TCHAR pendingChar = 0;
+
+	TCHAR decodeNext();
+public:
+	bool open(const FString &filename);
+	void close();
+	bool isOpen() const{
+		return fileData.isOpen();
+	}
+
+	/*
+	Returns true if the file starts with a UTF-16/UTF-32 byte order mark, those have to be loaded with FFileHelper.
+	*/
+	static bool hasWideBom(const uint8 *data, int64 size);
+
+	virtual void Serialize(void *data, int64 num) override;
+	virtual int64 Tell() override;
+	virtual int64 TotalSize() override;
+	virtual bool AtEnd() override;
+	virtual FString GetArchiveName() const override{
+		return TEXT("MappedUtf8Archive");
+	}
+
+	MappedUtf8Archive();
+	~MappedUtf8Archive();
+};
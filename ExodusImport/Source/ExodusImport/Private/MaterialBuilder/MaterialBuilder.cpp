@@ -2,6 +2,7 @@
 #include "MaterialBuilder.h"
 
 #include "JsonImporter.h"
+#include "ImportProfiler.h"
 
 #include "TerrainBuilder.h"
 
@@ -373,9 +374,12 @@ void MaterialBuilder::setupMaterialInstance(UMaterialInstanceConstant *matInst,
 	setScalarParam(matInst, "glossMapScale", jsonMat.smoothnessScale);*/
 
 
-	matInst->UpdateStaticPermutation(outParams);
-	//matInst->InitStaticPermutation();
-	matInst->PostEditChange();
+	{
+		IMPORT_PROFILE_SCOPE_ASSET("UMaterialInstance::PostEditChange", jsonMat.name);
+		matInst->UpdateStaticPermutation(outParams);
+		//matInst->InitStaticPermutation();
+		matInst->PostEditChange();
+	}
 
 	/*
 	if (jsonMat.isTransparentQueue()){
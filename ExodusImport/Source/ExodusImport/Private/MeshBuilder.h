@@ -9,12 +9,57 @@ class USkeletalMesh;
 class UMaterial;
 class UMaterialInterface;
 class JsonImporter;
+struct FRawMesh;
+
+namespace MeshBuilderUtils{
+	class ConvertedVertexStreams;
+}
+
+/*
+Static mesh with filled source models that still has to be built. Keeps the json mesh data needed after the build,
+as json meshes are released by then.
+*/
+class PendingStaticMeshBuild{
+public:
+	UStaticMesh *mesh = nullptr;
+	ResId id;
+	FString name;
+	bool convexCollider = false;
+	bool triangleCollider = false;
+	MeshSimpleCollision simpleCollision = MeshSimpleCollision::KDop18;
+	TArray<FloatArray> convexHulls;
+
+	PendingStaticMeshBuild() = default;
+	PendingStaticMeshBuild(UStaticMesh *mesh_, const JsonMesh &jsonMesh);
+};
 
 class MeshBuilder{
 public:
-	void setupStaticMesh(UStaticMesh *mesh, const JsonMesh &jsonMesh, std::function<void(TArray<FStaticMaterial> &meshMaterials)> materialSetup);
+	/*
+	When deferredBuilds is given, the mesh is only filled and added to it, and has to be built later with buildStaticMeshes.
+	*/
+	void setupStaticMesh(UStaticMesh *mesh, const JsonMesh &jsonMesh, std::function<void(TArray<FStaticMaterial> &meshMaterials)> materialSetup,
+		TArray<PendingStaticMeshBuild> *deferredBuilds = nullptr);
+	/*
+	Builds meshes and sets up their collision. Several meshes are built in parallel: with UStaticMesh::BatchBuild
+	on engines that have it, otherwise derived data is cached on worker threads before building on the game thread.
+	*/
+	static void buildStaticMeshes(const TArray<PendingStaticMeshBuild> &builds);
 	void generateBillboardMesh(UStaticMesh *staticMesh, UMaterialInterface *billboardMaterial);
+	/*
+	Appends srcMesh transformed by transform to dstMesh. materialRemap maps source material indices to destination ones.
+	Wedge channels present in only one of the meshes are padded with defaults.
+	*/
+	void appendRawMesh(FRawMesh &dstMesh, const FRawMesh &srcMesh, const FMatrix &transform, const IntArray &materialRemap);
 	MeshBuilder() = default;
 protected:
+	/*
+	Writes geometry of the given lod of jsonMesh into newRawMesh, lod 0 is the source geometry.
+	streams must be converted from the same jsonMesh.
+	*/
+	void fillStaticRawMesh(FRawMesh &newRawMesh, const JsonMesh &jsonMesh, const MeshBuilderUtils::ConvertedVertexStreams &streams, int32 lod);
+	static void setupStaticMeshCollision(const PendingStaticMeshBuild &build, const TArray<FText> &buildErrors);
+	//Returns false if no hull could be added
+	static bool addConvexHulls(UStaticMesh *mesh, const TArray<FloatArray> &hulls);
 };
 
@@ -0,0 +1,417 @@
+#include "JsonImportPrivatePCH.h"
+#include "LightmapUvGenerator.h"
+#include "MeshRenderOptimizer.h"
+
+namespace{
+	struct Vec3{
+		double x = 0.0, y = 0.0, z = 0.0;
+
+		Vec3() = default;
+		Vec3(double x_, double y_, double z_)
+		:x(x_), y(y_), z(z_){
+		}
+		Vec3 operator-(const Vec3 &other) const{
+			return Vec3(x - other.x, y - other.y, z - other.z);
+		}
+		Vec3 operator+(const Vec3 &other) const{
+			return Vec3(x + other.x, y + other.y, z + other.z);
+		}
+		Vec3 operator*(double scale) const{
+			return Vec3(x * scale, y * scale, z * scale);
+		}
+		double dot(const Vec3 &other) const{
+			return x * other.x + y * other.y + z * other.z;
+		}
+		Vec3 cross(const Vec3 &other) const{
+			return Vec3(y * other.z - z * other.y, z * other.x - x * other.z, x * other.y - y * other.x);
+		}
+		double length() const{
+			return FMath::Sqrt(dot(*this));
+		}
+		Vec3 normalized() const{
+			const double len = length();
+			return (len > 0.0) ? (*this * (1.0 / len)): Vec3();
+		}
+	};
+
+	Vec3 getPosition(const float *positions, int32 vert){
+		return Vec3(positions[vert * 3], positions[vert * 3 + 1], positions[vert * 3 + 2]);
+	}
+
+	struct Edge{
+		uint64 key;
+		//triangle * 3 + corner the edge starts from
+		int32 corner;
+	};
+
+	struct Chart{
+		int32 firstTriangle = 0;
+		int32 numTriangles = 0;
+		double minU = 1e30, minV = 1e30;
+		double maxU = -1e30, maxV = -1e30;
+		double offsetU = 0.0, offsetV = 0.0;
+
+		double getWidth() const{
+			return FMath::Max(maxU - minU, 0.0);
+		}
+		double getHeight() const{
+			return FMath::Max(maxV - minV, 0.0);
+		}
+	};
+
+	//Twice the signed area of a projected triangle, uvs are u, v pairs of its corners
+	double getSignedArea2(const double *uvs){
+		return (uvs[2] - uvs[0]) * (uvs[5] - uvs[1]) - (uvs[4] - uvs[0]) * (uvs[3] - uvs[1]);
+	}
+
+	/*
+	Separating axis test for two counter-clockwise projected triangles. Triangles that only touch along an edge
+	or at a corner (within epsilon) don't overlap.
+	*/
+	bool trianglesOverlap(const double *a, const double *b, double epsilon){
+		const double *tris[2] = {a, b};
+		for(int32 owner = 0; owner < 2; owner++){
+			const double *t = tris[owner];
+			for(int32 edge = 0; edge < 3; edge++){
+				const int32 next = (edge + 1) % 3;
+				const double axisU = t[next * 2 + 1] - t[edge * 2 + 1];
+				const double axisV = t[edge * 2] - t[next * 2];
+				const double len = FMath::Sqrt(axisU * axisU + axisV * axisV);
+				if (len <= 0.0)
+					continue;
+				double minA = 1e300, maxA = -1e300, minB = 1e300, maxB = -1e300;
+				for(int32 corner = 0; corner < 3; corner++){
+					const double projA = (a[corner * 2] * axisU + a[corner * 2 + 1] * axisV) / len;
+					const double projB = (b[corner * 2] * axisU + b[corner * 2 + 1] * axisV) / len;
+					minA = FMath::Min(minA, projA);
+					maxA = FMath::Max(maxA, projA);
+					minB = FMath::Min(minB, projB);
+					maxB = FMath::Max(maxB, projB);
+				}
+				if ((maxA <= minB + epsilon) || (maxB <= minA + epsilon))
+					return false;
+			}
+		}
+		return true;
+	}
+
+	/*
+	Places charts in rows of at most rowWidth, tallest first. Every chart is surrounded by pad on all sides.
+	Returns side of the square that holds all rows.
+	*/
+	double packCharts(TArray<Chart> &charts, const TArray<int32> &order, double pad, double rowWidth){
+		double x = 0.0, y = 0.0, rowHeight = 0.0, usedWidth = 0.0;
+		for(auto chartIndex: order){
+			auto &chart = charts[chartIndex];
+			const double width = chart.getWidth() + pad * 2.0;
+			const double height = chart.getHeight() + pad * 2.0;
+			if ((x > 0.0) && ((x + width) > rowWidth)){
+				y += rowHeight;
+				x = 0.0;
+				rowHeight = 0.0;
+			}
+			chart.offsetU = x + pad;
+			chart.offsetV = y + pad;
+			x += width;
+			rowHeight = FMath::Max(rowHeight, height);
+			usedWidth = FMath::Max(usedWidth, x);
+		}
+		return FMath::Max(usedWidth, y + rowHeight);
+	}
+}
+
+double LightmapUvGenerator::computeSurfaceArea(const TArray<float> &positions, const TArray<int32> &indices){
+	const int32 numVerts = positions.Num() / 3;
+	const float *posData = positions.GetData();
+	double result = 0.0;
+	for(int32 i = 0; (i + 2) < indices.Num(); i += 3){
+		const int32 a = indices[i], b = indices[i + 1], c = indices[i + 2];
+		if (((uint32)a >= (uint32)numVerts) || ((uint32)b >= (uint32)numVerts) || ((uint32)c >= (uint32)numVerts))
+			continue;
+		const Vec3 pa = getPosition(posData, a);
+		result += (getPosition(posData, b) - pa).cross(getPosition(posData, c) - pa).length() * 0.5;
+	}
+	return result;
+}
+
+int32 LightmapUvGenerator::computeResolution(double surfaceArea, float texelsPerUnit, int32 minResolution, int32 maxResolution){
+	//Charts rarely cover more than this fraction of the atlas
+	const double atlasCoverage = 0.6;
+	const double side = FMath::Sqrt(FMath::Max(surfaceArea, 0.0) / atlasCoverage) * texelsPerUnit;
+	int32 result = 4;
+	while((result < maxResolution) && ((double)result * 1.41421356 < side))
+		result *= 2;
+	return FMath::Clamp(result, minResolution, maxResolution);
+}
+
+int32 LightmapUvGenerator::generate(const TArray<float> &positions, const TArray<int32> &indices, int32 resolution,
+		TArray<float> &outCornerUvs, float maxChartAngle, float padTexels){
+	const int32 numVerts = positions.Num() / 3;
+	const int32 numTris = indices.Num() / 3;
+	outCornerUvs.SetNumZeroed(numTris * 6);
+	if ((numTris <= 0) || (resolution <= 0))
+		return 0;
+	for(int32 i = 0; i < numTris * 3; i++){
+		if ((indices[i] < 0) || (indices[i] >= numVerts)){
+			UE_LOG(JsonLog, Warning, TEXT("Lightmap uv generation: vertex index %d out of range"), indices[i]);
+			return 0;
+		}
+	}
+	const float *posData = positions.GetData();
+	const int32 *idxData = indices.GetData();
+
+	//Adjacency goes by position, so uv and normal seams of the source mesh don't split charts
+	TArray<int32> posIds;
+	{
+		TArray<MeshRenderOptimizer::VertexStream> streams;
+		MeshRenderOptimizer::VertexStream stream;
+		stream.data = (const uint8*)posData;
+		stream.stride = sizeof(float) * 3;
+		streams.Add(stream);
+		MeshRenderOptimizer::buildWeldRemap(numVerts, streams, posIds);
+	}
+
+	TArray<Vec3> triNormals;
+	TArray<double> triAreas;
+	triNormals.SetNumUninitialized(numTris);
+	triAreas.SetNumUninitialized(numTris);
+	for(int32 tri = 0; tri < numTris; tri++){
+		const Vec3 pa = getPosition(posData, idxData[tri * 3]);
+		const Vec3 n = (getPosition(posData, idxData[tri * 3 + 1]) - pa).cross(getPosition(posData, idxData[tri * 3 + 2]) - pa);
+		triAreas[tri] = n.length() * 0.5;
+		triNormals[tri] = n.normalized();
+	}
+
+	//Only edges shared by exactly two triangles connect them, non-manifold edges become chart borders
+	TArray<int32> neighbors;
+	neighbors.Init(-1, numTris * 3);
+	{
+		TArray<Edge> edges;
+		edges.SetNumUninitialized(numTris * 3);
+		for(int32 corner = 0; corner < numTris * 3; corner++){
+			const int32 next = (corner % 3 == 2) ? corner - 2: corner + 1;
+			const uint32 a = (uint32)posIds[idxData[corner]];
+			const uint32 b = (uint32)posIds[idxData[next]];
+			edges[corner].key = (a < b) ? (((uint64)a << 32) | b): (((uint64)b << 32) | a);
+			edges[corner].corner = corner;
+		}
+		edges.Sort([](const Edge &a, const Edge &b){
+			return (a.key < b.key) || ((a.key == b.key) && (a.corner < b.corner));
+		});
+		for(int32 first = 0; first < edges.Num();){
+			int32 last = first + 1;
+			while((last < edges.Num()) && (edges[last].key == edges[first].key))
+				last++;
+			const int32 cornerA = edges[first].corner, cornerB = edges[first + 1 < last ? first + 1: first].corner;
+			if (((last - first) == 2) && ((cornerA / 3) != (cornerB / 3))){
+				neighbors[cornerA] = cornerB / 3;
+				neighbors[cornerB] = cornerA / 3;
+			}
+			first = last;
+		}
+	}
+
+	//Largest triangles seed charts first, so big flat areas are not cut by small neighbours
+	TArray<int32> seedOrder;
+	seedOrder.SetNumUninitialized(numTris);
+	for(int32 i = 0; i < numTris; i++)
+		seedOrder[i] = i;
+	seedOrder.Sort([&](int32 a, int32 b){
+		return (triAreas[a] > triAreas[b]) || ((triAreas[a] == triAreas[b]) && (a < b));
+	});
+
+	const double minDot = FMath::Cos(FMath::DegreesToRadians(FMath::Clamp(maxChartAngle, 0.0f, 89.0f)));
+	TArray<int32> triChart, chartTriangles;
+	triChart.Init(-1, numTris);
+	chartTriangles.Reserve(numTris);
+	TArray<Chart> charts;
+	TArray<double> cornerUvs;
+	cornerUvs.SetNumUninitialized(numTris * 6);
+	TArray<int32> keptTriangles;
+	TArray<TArray<int32>> gridCells;
+	//Triangles evicted from a chart are appended to seedOrder and start charts of their own
+	for(int32 seedIndex = 0; seedIndex < seedOrder.Num(); seedIndex++){
+		const int32 seed = seedOrder[seedIndex];
+		if (triChart[seed] >= 0)
+			continue;
+		const int32 chartIndex = charts.Num();
+		auto &chart = charts.AddDefaulted_GetRef();
+		chart.firstTriangle = chartTriangles.Num();
+		const Vec3 seedNormal = triNormals[seed];
+
+		//Candidates are compared against the running area weighted normal, so curved surfaces don't drift too far from it
+		Vec3 normalSum = triNormals[seed] * triAreas[seed];
+		triChart[seed] = chartIndex;
+		chartTriangles.Add(seed);
+		for(int32 queued = chart.firstTriangle; queued < chartTriangles.Num(); queued++){
+			const int32 tri = chartTriangles[queued];
+			for(int32 edge = 0; edge < 3; edge++){
+				const int32 next = neighbors[tri * 3 + edge];
+				if ((next < 0) || (triChart[next] >= 0))
+					continue;
+				//Degenerate triangles join whatever chart reaches them first
+				if (triAreas[next] > 0.0){
+					const Vec3 chartNormal = normalSum.normalized();
+					if (triNormals[next].dot((chartNormal.length() > 0.0) ? chartNormal: seedNormal) < minDot)
+						continue;
+				}
+				triChart[next] = chartIndex;
+				chartTriangles.Add(next);
+				normalSum = normalSum + triNormals[next] * triAreas[next];
+			}
+		}
+
+		//Seed has to survive the projection, otherwise the chart could end up empty
+		Vec3 normal = normalSum.normalized();
+		if ((normal.length() <= 0.0) || (normal.dot(seedNormal) < minDot))
+			normal = (seedNormal.length() > 0.0) ? seedNormal: Vec3(0.0, 0.0, 1.0);
+
+		//Planar projection. u axis follows the longest edge of the seed triangle, which keeps rectangular charts axis aligned.
+		Vec3 axisU;
+		double longest = -1.0;
+		for(int32 edge = 0; edge < 3; edge++){
+			const Vec3 dir = getPosition(posData, idxData[seed * 3 + (edge + 1) % 3]) - getPosition(posData, idxData[seed * 3 + edge]);
+			const Vec3 planar = dir - normal * dir.dot(normal);
+			const double len = planar.length();
+			if (len > longest){
+				longest = len;
+				axisU = planar;
+			}
+		}
+		axisU = axisU.normalized();
+		if (axisU.length() <= 0.0){
+			const Vec3 helper = (FMath::Abs(normal.x) < 0.9) ? Vec3(1.0, 0.0, 0.0): Vec3(0.0, 1.0, 0.0);
+			axisU = helper.cross(normal).normalized();
+		}
+		const Vec3 axisV = normal.cross(axisU);
+
+		double minU = 1e30, minV = 1e30, maxU = -1e30, maxV = -1e30;
+		for(int32 i = chart.firstTriangle; i < chartTriangles.Num(); i++){
+			const int32 tri = chartTriangles[i];
+			for(int32 corner = 0; corner < 3; corner++){
+				const Vec3 p = getPosition(posData, idxData[tri * 3 + corner]);
+				const double u = p.dot(axisU), v = p.dot(axisV);
+				cornerUvs[(tri * 3 + corner) * 2] = u;
+				cornerUvs[(tri * 3 + corner) * 2 + 1] = v;
+				minU = FMath::Min(minU, u);
+				minV = FMath::Min(minV, v);
+				maxU = FMath::Max(maxU, u);
+				maxV = FMath::Max(maxV, v);
+			}
+		}
+
+		/*
+		Running normal still drifts on curved surfaces, and charts that wrap around (cones, spirals) project onto themselves.
+		Triangles that flip in the final projection, or overlap triangles accepted before them, are evicted in growth order.
+		Overlap candidates come from a uniform grid over the chart bounds.
+		*/
+		const double extent = FMath::Max(FMath::Max(maxU - minU, maxV - minV), 1e-30);
+		const double epsilon = extent * 1e-9;
+		const int32 numChartTris = chartTriangles.Num() - chart.firstTriangle;
+		const int32 gridSize = FMath::Clamp((int32)FMath::Sqrt((float)numChartTris), 1, 1024);
+		const double cellScale = gridSize / extent;
+		auto getCell = [&](double value, double minValue){
+			return FMath::Clamp((int32)((value - minValue) * cellScale), 0, gridSize - 1);
+		};
+		const bool checkOverlaps = numChartTris > 1;
+		if (checkOverlaps){
+			gridCells.SetNum(gridSize * gridSize);
+			for(auto &cell: gridCells)
+				cell.Empty();
+		}
+
+		keptTriangles.Empty(numChartTris);
+		for(int32 i = chart.firstTriangle; i < chartTriangles.Num(); i++){
+			const int32 tri = chartTriangles[i];
+			const double *uvs = cornerUvs.GetData() + tri * 6;
+			const double area2 = getSignedArea2(uvs);
+			bool keep = (i == chart.firstTriangle) || (triAreas[tri] <= 0.0) || (area2 > epsilon * epsilon);
+			if (keep && checkOverlaps && (triAreas[tri] > 0.0)){
+				const int32 cellMinU = getCell(FMath::Min3(uvs[0], uvs[2], uvs[4]), minU);
+				const int32 cellMaxU = getCell(FMath::Max3(uvs[0], uvs[2], uvs[4]), minU);
+				const int32 cellMinV = getCell(FMath::Min3(uvs[1], uvs[3], uvs[5]), minV);
+				const int32 cellMaxV = getCell(FMath::Max3(uvs[1], uvs[3], uvs[5]), minV);
+				for(int32 cellV = cellMinV; keep && (cellV <= cellMaxV); cellV++){
+					for(int32 cellU = cellMinU; keep && (cellU <= cellMaxU); cellU++){
+						for(auto other: gridCells[cellV * gridSize + cellU]){
+							if (trianglesOverlap(uvs, cornerUvs.GetData() + other * 6, epsilon)){
+								keep = false;
+								break;
+							}
+						}
+					}
+				}
+				if (keep){
+					for(int32 cellV = cellMinV; cellV <= cellMaxV; cellV++){
+						for(int32 cellU = cellMinU; cellU <= cellMaxU; cellU++)
+							gridCells[cellV * gridSize + cellU].Add(tri);
+					}
+				}
+			}
+			if (keep)
+				keptTriangles.Add(tri);
+			else{
+				triChart[tri] = -1;
+				seedOrder.Add(tri);
+			}
+		}
+
+		chartTriangles.SetNum(chart.firstTriangle);
+		for(auto tri: keptTriangles){
+			chartTriangles.Add(tri);
+			for(int32 corner = 0; corner < 3; corner++){
+				const double u = cornerUvs[(tri * 3 + corner) * 2], v = cornerUvs[(tri * 3 + corner) * 2 + 1];
+				chart.minU = FMath::Min(chart.minU, u);
+				chart.minV = FMath::Min(chart.minV, v);
+				chart.maxU = FMath::Max(chart.maxU, u);
+				chart.maxV = FMath::Max(chart.maxV, v);
+			}
+		}
+		chart.numTriangles = chartTriangles.Num() - chart.firstTriangle;
+	}
+
+	TArray<int32> packOrder;
+	packOrder.SetNumUninitialized(charts.Num());
+	double chartArea = 0.0, maxChartWidth = 0.0;
+	for(int32 i = 0; i < charts.Num(); i++){
+		packOrder[i] = i;
+		chartArea += charts[i].getWidth() * charts[i].getHeight();
+		maxChartWidth = FMath::Max(maxChartWidth, charts[i].getWidth());
+	}
+	packOrder.Sort([&](int32 a, int32 b){
+		const double heightA = charts[a].getHeight(), heightB = charts[b].getHeight();
+		return (heightA > heightB) || ((heightA == heightB) && (a < b));
+	});
+
+	/*
+	Padding is given in texels, so it depends on the atlas size, which depends on padding.
+	Padding only grows between rounds, and a few rounds are enough for the atlas size to settle.
+	*/
+	double side = FMath::Max((double)FMath::Sqrt(chartArea), maxChartWidth);
+	if (side <= 0.0)
+		side = 1.0;
+	double pad = 0.0;
+	for(int32 round = 0; round < 4; round++){
+		pad = FMath::Max(pad, padTexels * side / resolution);
+		double paddedArea = 0.0;
+		for(const auto &chart: charts)
+			paddedArea += (chart.getWidth() + pad * 2.0) * (chart.getHeight() + pad * 2.0);
+		const double rowWidth = FMath::Max((double)FMath::Sqrt(paddedArea), maxChartWidth + pad * 2.0);
+		const double newSide = packCharts(charts, packOrder, pad, rowWidth);
+		const bool settled = newSide <= side;
+		side = FMath::Max(newSide, (double)1e-20);
+		if (settled && (pad >= padTexels * side / resolution))
+			break;
+	}
+
+	const double invSide = 1.0 / side;
+	for(int32 tri = 0; tri < numTris; tri++){
+		const auto &chart = charts[triChart[tri]];
+		for(int32 corner = 0; corner < 3; corner++){
+			const int32 uvIndex = (tri * 3 + corner) * 2;
+			outCornerUvs[uvIndex] = (float)((cornerUvs[uvIndex] - chart.minU + chart.offsetU) * invSide);
+			outCornerUvs[uvIndex + 1] = (float)((cornerUvs[uvIndex + 1] - chart.minV + chart.offsetV) * invSide);
+		}
+	}
+	return charts.Num();
+}
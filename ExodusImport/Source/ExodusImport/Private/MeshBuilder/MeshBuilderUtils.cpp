@@ -1,37 +1,160 @@
 #include "JsonImportPrivatePCH.h"
 #include "MeshBuilderUtils.h"
 #include "UnrealUtilities.h"
+#include "ImportProfiler.h"
+#include "JsonObjects/JsonMesh.h"
+#include "Async/ParallelFor.h"
 
 using namespace UnrealUtilities;
 
-void MeshBuilderUtils::processTangent(int originalIndex, const FloatArray &normFloats, const FloatArray &tangentFloats, bool hasNormals, bool hasTangents,
-		std::function<void(const FVector&)> normCallback, std::function<void(const FVector&, const FVector&)> tanCallback){
-	if (!hasNormals)
+void MeshBuilderUtils::parallelRange(int32 num, TFunctionRef<void(int32 first, int32 last)> body){
+	//Big enough for task overhead to be negligible, small enough to split typical meshes.
+	const int32 chunkSize = 16384;
+	if (num <= 0)
 		return;
-	auto unityNorm = getIdxVector3(normFloats, originalIndex);
-	auto normUnreal = unityVecToUe(unityNorm);
-	if (normCallback)
-		normCallback(normUnreal);
-	//newRawMesh.WedgeTangentZ.Add(normUnreal);
-	if (!hasTangents)
+	const int32 numChunks = (num + chunkSize - 1) / chunkSize;
+	if (numChunks == 1){
+		body(0, num);
 		return;
+	}
+	ParallelFor(numChunks, [&](int32 chunk){
+		const int32 first = chunk * chunkSize;
+		body(first, FMath::Min(first + chunkSize, num));
+	});
+}
+
+/*
+Source streams shorter than the vertex count are padded with zeroes, same as getIdxVector* does.
+*/
+static void convertVec3Stream(FVector *dst, int32 numVerts, const FloatArray &src, float scale){
+	const int32 numSrc = FMath::Min(src.Num() / 3, numVerts);
+	const float *srcData = src.GetData();
+	MeshBuilderUtils::parallelRange(numSrc, [&](int32 first, int32 last){
+		for(int32 i = first; i < last; i++){
+			const float *v = srcData + i * 3;
+			//unityVecToUe
+			dst[i] = FVector(v[2] * scale, v[0] * scale, v[1] * scale);
+		}
+	});
+	for(int32 i = numSrc; i < numVerts; i++)
+		dst[i] = FVector::ZeroVector;
+}
+
+static void convertUvStream(FVector2D *dst, int32 numVerts, const FloatArray &src){
+	const int32 numSrc = FMath::Min(src.Num() / 2, numVerts);
+	const float *srcData = src.GetData();
+	MeshBuilderUtils::parallelRange(numSrc, [&](int32 first, int32 last){
+		for(int32 i = first; i < last; i++){
+			//unityUvToUnreal
+			dst[i] = FVector2D(srcData[i * 2], 1.0f - srcData[i * 2 + 1]);
+		}
+	});
+	for(int32 i = numSrc; i < numVerts; i++)
+		dst[i] = FVector2D(0.0f, 1.0f);
+}
+
+void MeshBuilderUtils::convertVertexStreams(const JsonMesh &jsonMesh, ConvertedVertexStreams &outStreams, bool placeholderUv0){
+	ImportProfileScope profileScope(TEXT("MeshBuilderUtils::convertVertexStreams"), jsonMesh.name);
+	const int32 numVerts = jsonMesh.verts.Num() / 3;
+	profileScope.addElements(numVerts);
 
-	auto unityTangent = getIdxVector4(tangentFloats, originalIndex);
-	auto uTanUnity = FVector(unityTangent.X, unityTangent.Y, unityTangent.Z);
+	outStreams.numVerts = numVerts;
+	const bool hasNormals = jsonMesh.normals.Num() != 0;
+	const bool hasTangents = hasNormals && (jsonMesh.tangents.Num() != 0);
+	const bool hasColors = jsonMesh.colors.Num() != 0;
 
-	auto uTanUnreal = unityVecToUe(uTanUnity);
-	//auto vTanUnreal = FVector::CrossProduct(uTanUnreal, normUnreal) * unityTangent.W;
-	auto vTanUnreal = FVector::CrossProduct(normUnreal, uTanUnreal) * unityTangent.W;
-	/* 
-		I suspect unity gets normals wrong on at least SOME geometry, but can't really prove it.
-	*/
-	uTanUnreal.Normalize();
-	vTanUnreal.Normalize();
+	outStreams.positions.SetNumUninitialized(numVerts);
+	outStreams.normals.SetNumUninitialized(hasNormals ? numVerts: 0);
+	outStreams.tangentsX.SetNumUninitialized(hasTangents ? numVerts: 0);
+	outStreams.tangentsY.SetNumUninitialized(hasTangents ? numVerts: 0);
+	outStreams.colors.SetNumUninitialized(hasColors ? numVerts: 0);
 
-	if (tanCallback)
-		tanCallback(uTanUnreal, vTanUnreal);
+	convertVec3Stream(outStreams.positions.GetData(), numVerts, jsonMesh.verts, 100.0f);
+	if (hasNormals)
+		convertVec3Stream(outStreams.normals.GetData(), numVerts, jsonMesh.normals, 1.0f);
 
-	//newRawMesh.WedgeTangentX.Add(uTanUnreal);
-	//newRawMesh.WedgeTangentY.Add(vTanUnreal);
+	if (hasTangents){
+		const int32 numSrc = FMath::Min(jsonMesh.tangents.Num() / 4, numVerts);
+		const float *srcData = jsonMesh.tangents.GetData();
+		const FVector *normals = outStreams.normals.GetData();
+		FVector *dstX = outStreams.tangentsX.GetData();
+		FVector *dstY = outStreams.tangentsY.GetData();
+		parallelRange(numSrc, [&](int32 first, int32 last){
+			for(int32 i = first; i < last; i++){
+				const float *t = srcData + i * 4;
+				const FVector uTan(t[2], t[0], t[1]);
+				/*
+					I suspect unity gets normals wrong on at least SOME geometry, but can't really prove it.
+				*/
+				dstX[i] = uTan.GetSafeNormal();
+				dstY[i] = (FVector::CrossProduct(normals[i], uTan) * t[3]).GetSafeNormal();
+			}
+		});
+		for(int32 i = numSrc; i < numVerts; i++){
+			dstX[i] = FVector::ZeroVector;
+			dstY[i] = FVector::ZeroVector;
+		}
+	}
+
+	if (hasColors){
+		const int32 numSrc = FMath::Min(jsonMesh.colors.Num() / 4, numVerts);
+		const uint8 *srcData = jsonMesh.colors.GetData();
+		FColor *dst = outStreams.colors.GetData();
+		for(int32 i = 0; i < numSrc; i++)
+			dst[i] = FColor(srcData[i * 4], srcData[i * 4 + 1], srcData[i * 4 + 2], srcData[i * 4 + 3]);
+		for(int32 i = numSrc; i < numVerts; i++)
+			dst[i] = FColor::White;
+	}
+
+	const FloatArray* uvFloats[maxVertexUvs] = {
+		&jsonMesh.uv0, &jsonMesh.uv1, &jsonMesh.uv2, &jsonMesh.uv3,
+		&jsonMesh.uv4, &jsonMesh.uv5, &jsonMesh.uv6, &jsonMesh.uv7
+	};
+	for(int32 uvIndex = 0; uvIndex < maxVertexUvs; uvIndex++){
+		auto &dstUvs = outStreams.uvs[uvIndex];
+		const auto &srcUvs = *uvFloats[uvIndex];
+		if (srcUvs.Num() != 0){
+			dstUvs.SetNumUninitialized(numVerts);
+			convertUvStream(dstUvs.GetData(), numVerts, srcUvs);
+			continue;
+		}
+		if ((uvIndex != 0) || !placeholderUv0){
+			dstUvs.Reset();
+			continue;
+		}
+		dstUvs.SetNumUninitialized(numVerts);
+		for(int32 i = 0; i < numVerts; i++)
+			dstUvs[i] = FVector2D(jsonMesh.verts[i * 3], jsonMesh.verts[i * 3 + 1]);
+	}
 }
 
+void MeshBuilderUtils::buildWedgeVertices(const JsonMesh &jsonMesh, int32 lod, IntArray &outWedgeVerts, IntArray &outFaceMaterials){
+	const int32 numVerts = jsonMesh.verts.Num() / 3;
+	int32 numFaces = 0;
+	for(int32 subMeshIndex = 0; subMeshIndex < jsonMesh.subMeshes.Num(); subMeshIndex++)
+		numFaces += jsonMesh.getSubMeshTriangles(lod, subMeshIndex).Num() / 3;
+
+	outWedgeVerts.Reset(numFaces * 3);
+	outFaceMaterials.Reset(numFaces);
+
+	int32 numInvalid = 0;
+	for(int32 subMeshIndex = 0; subMeshIndex < jsonMesh.subMeshes.Num(); subMeshIndex++){
+		const auto &trigs = jsonMesh.getSubMeshTriangles(lod, subMeshIndex);
+		for(int32 i = 0; (i + 2) < trigs.Num(); i += 3){
+			const int32 a = trigs[i], b = trigs[i + 1], c = trigs[i + 2];
+			if (((uint32)a >= (uint32)numVerts) || ((uint32)b >= (uint32)numVerts) || ((uint32)c >= (uint32)numVerts)){
+				numInvalid++;
+				continue;
+			}
+			outWedgeVerts.Add(a);
+			outWedgeVerts.Add(c);
+			outWedgeVerts.Add(b);
+			outFaceMaterials.Add(subMeshIndex);
+		}
+	}
+
+	if (numInvalid > 0){
+		UE_LOG(JsonLog, Warning, TEXT("Mesh %s(%d): skipped %d triangles with out of range vertex indices"),
+			*jsonMesh.name, jsonMesh.id.id, numInvalid);
+	}
+}
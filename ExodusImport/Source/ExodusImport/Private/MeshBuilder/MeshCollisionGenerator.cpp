@@ -0,0 +1,350 @@
+#include "JsonImportPrivatePCH.h"
+#include "MeshCollisionGenerator.h"
+
+namespace{
+	const int32 numHullDirections = 13;
+	const float hullDirections[numHullDirections][3] = {
+		{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f},
+		{1.0f, 1.0f, 0.0f}, {1.0f, -1.0f, 0.0f}, {1.0f, 0.0f, 1.0f},
+		{1.0f, 0.0f, -1.0f}, {0.0f, 1.0f, 1.0f}, {0.0f, 1.0f, -1.0f},
+		{1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, -1.0f}, {1.0f, -1.0f, 1.0f}, {-1.0f, 1.0f, 1.0f}
+	};
+	//1 / length of hullDirections
+	const float hullDirectionScales[numHullDirections] = {
+		1.0f, 1.0f, 1.0f,
+		0.70710678f, 0.70710678f, 0.70710678f,
+		0.70710678f, 0.70710678f, 0.70710678f,
+		0.57735027f, 0.57735027f, 0.57735027f, 0.57735027f
+	};
+
+	float dotDirection(const float *p, int32 dir){
+		const float *d = hullDirections[dir];
+		return p[0] * d[0] + p[1] * d[1] + p[2] * d[2];
+	}
+
+	//Extents of a point set along hullDirections, the intersection of the slabs is its 26-DOP
+	struct HullSlabs{
+		float minDots[numHullDirections];
+		float maxDots[numHullDirections];
+
+		void reset(){
+			for(int32 dir = 0; dir < numHullDirections; dir++){
+				minDots[dir] = 1e30f;
+				maxDots[dir] = -1e30f;
+			}
+		}
+		void addPoint(const float *p){
+			for(int32 dir = 0; dir < numHullDirections; dir++){
+				const float dot = dotDirection(p, dir);
+				minDots[dir] = FMath::Min(minDots[dir], dot);
+				maxDots[dir] = FMath::Max(maxDots[dir], dot);
+			}
+		}
+		//Distance from the point to the nearest slab plane, the point is assumed to be inside
+		float getDepth(const float *p) const{
+			float result = 1e30f;
+			for(int32 dir = 0; dir < numHullDirections; dir++){
+				const float dot = dotDirection(p, dir);
+				result = FMath::Min(result, FMath::Min(maxDots[dir] - dot, dot - minDots[dir]) * hullDirectionScales[dir]);
+			}
+			return FMath::Max(result, 0.0f);
+		}
+	};
+
+	struct Cluster{
+		//Triangle indices, not vertex indices
+		TArray<int32> triangles;
+		float boundsMin[3];
+		float boundsMax[3];
+		//Largest distance from a cluster vertex to the surface of the cluster hull
+		float concavity = 0.0f;
+	};
+
+	struct SortedTriangle{
+		float centroid;
+		int32 triangle;
+	};
+
+	void computeClusterSlabs(const Cluster &cluster, const float *positions, const int32 *indices, HullSlabs &outSlabs){
+		outSlabs.reset();
+		for(auto tri: cluster.triangles){
+			for(int32 corner = 0; corner < 3; corner++)
+				outSlabs.addPoint(positions + indices[tri * 3 + corner] * 3);
+		}
+	}
+
+	void updateCluster(Cluster &cluster, const float *positions, const int32 *indices){
+		for(int32 axis = 0; axis < 3; axis++){
+			cluster.boundsMin[axis] = 1e30f;
+			cluster.boundsMax[axis] = -1e30f;
+		}
+		for(auto tri: cluster.triangles){
+			for(int32 corner = 0; corner < 3; corner++){
+				const float *p = positions + indices[tri * 3 + corner] * 3;
+				for(int32 axis = 0; axis < 3; axis++){
+					cluster.boundsMin[axis] = FMath::Min(cluster.boundsMin[axis], p[axis]);
+					cluster.boundsMax[axis] = FMath::Max(cluster.boundsMax[axis], p[axis]);
+				}
+			}
+		}
+
+		/*
+		A convex piece of surface lies on its hull, so vertex depth below the hull measures how much empty space 
+		the hull adds. For a closed cluster it drops to zero only when hull and enclosed volume match.
+		*/
+		HullSlabs slabs;
+		computeClusterSlabs(cluster, positions, indices, slabs);
+		cluster.concavity = 0.0f;
+		for(auto tri: cluster.triangles){
+			for(int32 corner = 0; corner < 3; corner++)
+				cluster.concavity = FMath::Max(cluster.concavity, slabs.getDepth(positions + indices[tri * 3 + corner] * 3));
+		}
+	}
+
+	float getTriangleCentroid(int32 tri, int32 axis, const float *positions, const int32 *indices){
+		return positions[indices[tri * 3] * 3 + axis]
+			+ positions[indices[tri * 3 + 1] * 3 + axis]
+			+ positions[indices[tri * 3 + 2] * 3 + axis];
+	}
+
+	/*
+	Corners of the 26-DOP: intersections of every three slab planes that lie inside all slabs.
+	Direction components are integers, so planes of a triple are either independent (|det| >= 1) or not.
+	*/
+	void buildClusterHull(const Cluster &cluster, const float *positions, const int32 *indices,
+			MeshCollisionGenerator::PointArray &outPoints){
+		HullSlabs slabs;
+		computeClusterSlabs(cluster, positions, indices, slabs);
+
+		const int32 numPlanes = numHullDirections * 2;
+		double normals[numPlanes][3], offsets[numPlanes];
+		for(int32 dir = 0; dir < numHullDirections; dir++){
+			for(int32 axis = 0; axis < 3; axis++){
+				normals[dir * 2][axis] = hullDirections[dir][axis];
+				normals[dir * 2 + 1][axis] = -hullDirections[dir][axis];
+			}
+			offsets[dir * 2] = slabs.maxDots[dir];
+			offsets[dir * 2 + 1] = -slabs.minDots[dir];
+		}
+
+		const float extent = FMath::Max3(cluster.boundsMax[0] - cluster.boundsMin[0], 
+			cluster.boundsMax[1] - cluster.boundsMin[1], cluster.boundsMax[2] - cluster.boundsMin[2]);
+		const double epsilon = FMath::Max(extent * 1e-4f, 1e-6f);
+
+		auto cross = [](const double *a, const double *b, double *outResult){
+			outResult[0] = a[1] * b[2] - a[2] * b[1];
+			outResult[1] = a[2] * b[0] - a[0] * b[2];
+			outResult[2] = a[0] * b[1] - a[1] * b[0];
+		};
+
+		TArray<double> corners;
+		for(int32 i = 0; i < numPlanes; i++){
+			for(int32 j = i + 1; j < numPlanes; j++){
+				double crossIJ[3];
+				cross(normals[i], normals[j], crossIJ);
+				for(int32 k = j + 1; k < numPlanes; k++){
+					const double det = normals[k][0] * crossIJ[0] + normals[k][1] * crossIJ[1] + normals[k][2] * crossIJ[2];
+					if (FMath::Abs(det) < 0.5)
+						continue;
+					double crossJK[3], crossKI[3];
+					cross(normals[j], normals[k], crossJK);
+					cross(normals[k], normals[i], crossKI);
+					double corner[3];
+					for(int32 axis = 0; axis < 3; axis++)
+						corner[axis] = (offsets[i] * crossJK[axis] + offsets[j] * crossKI[axis] + offsets[k] * crossIJ[axis]) / det;
+
+					bool inside = true;
+					for(int32 plane = 0; inside && (plane < numPlanes); plane++){
+						const double dot = normals[plane][0] * corner[0] + normals[plane][1] * corner[1] + normals[plane][2] * corner[2];
+						inside = dot <= offsets[plane] + epsilon;
+					}
+					for(int32 existing = 0; inside && (existing < corners.Num()); existing += 3){
+						const double dx = corners[existing] - corner[0];
+						const double dy = corners[existing + 1] - corner[1];
+						const double dz = corners[existing + 2] - corner[2];
+						inside = (dx * dx + dy * dy + dz * dz) > epsilon * epsilon;
+					}
+					if (inside){
+						corners.Add(corner[0]);
+						corners.Add(corner[1]);
+						corners.Add(corner[2]);
+					}
+				}
+			}
+		}
+
+		outPoints.Empty(corners.Num());
+		for(auto cur: corners)
+			outPoints.Add((float)cur);
+	}
+}
+
+void MeshCollisionGenerator::decomposeConvex(const TArray<float> &positions, const TArray<int32> &indices,
+		int32 maxHulls, int32 minHullTriangles, float maxConcavity, HullArray &outHulls, TArray<int32> *outTriangleHulls){
+	outHulls.Empty();
+	if (outTriangleHulls)
+		outTriangleHulls->Empty();
+	const int32 numVerts = positions.Num() / 3;
+	const int32 numTris = indices.Num() / 3;
+	if ((numTris <= 0) || (maxHulls <= 0))
+		return;
+	for(int32 i = 0; i < numTris * 3; i++){
+		if ((indices[i] < 0) || (indices[i] >= numVerts)){
+			UE_LOG(JsonLog, Warning, TEXT("Convex decomposition: vertex index %d out of range"), indices[i]);
+			return;
+		}
+	}
+
+	const float *posData = positions.GetData();
+	const int32 *idxData = indices.GetData();
+	const int32 minSplitTriangles = FMath::Max(minHullTriangles, 1) * 2;
+
+	TArray<Cluster> clusters;
+	{
+		auto &root = clusters.AddDefaulted_GetRef();
+		root.triangles.SetNumUninitialized(numTris);
+		for(int32 i = 0; i < numTris; i++)
+			root.triangles[i] = i;
+		updateCluster(root, posData, idxData);
+	}
+	const float rootSize[3] = {
+		clusters[0].boundsMax[0] - clusters[0].boundsMin[0], 
+		clusters[0].boundsMax[1] - clusters[0].boundsMin[1], 
+		clusters[0].boundsMax[2] - clusters[0].boundsMin[2]
+	};
+	const float diagonal = FMath::Sqrt(rootSize[0] * rootSize[0] + rootSize[1] * rootSize[1] + rootSize[2] * rootSize[2]);
+	const float concavityThreshold = FMath::Max(maxConcavity, 0.0f) * diagonal;
+
+	while(clusters.Num() < maxHulls){
+		int32 splitIndex = -1;
+		float splitConcavity = concavityThreshold;
+		for(int32 i = 0; i < clusters.Num(); i++){
+			if (clusters[i].triangles.Num() < minSplitTriangles)
+				continue;
+			if (clusters[i].concavity > splitConcavity){
+				splitConcavity = clusters[i].concavity;
+				splitIndex = i;
+			}
+		}
+		if (splitIndex < 0)
+			break;
+
+		auto &src = clusters[splitIndex];
+		int32 axis = 0;
+		for(int32 i = 1; i < 3; i++){
+			if ((src.boundsMax[i] - src.boundsMin[i]) > (src.boundsMax[axis] - src.boundsMin[axis]))
+				axis = i;
+		}
+		TArray<SortedTriangle> sorted;
+		sorted.SetNumUninitialized(src.triangles.Num());
+		for(int32 i = 0; i < src.triangles.Num(); i++){
+			sorted[i].centroid = getTriangleCentroid(src.triangles[i], axis, posData, idxData);
+			sorted[i].triangle = src.triangles[i];
+		}
+		sorted.Sort([](const SortedTriangle &a, const SortedTriangle &b){
+			return (a.centroid < b.centroid) || ((a.centroid == b.centroid) && (a.triangle < b.triangle));
+		});
+		for(int32 i = 0; i < sorted.Num(); i++)
+			src.triangles[i] = sorted[i].triangle;
+
+		Cluster upper;
+		const int32 half = src.triangles.Num() / 2;
+		upper.triangles.Reserve(src.triangles.Num() - half);
+		for(int32 i = half; i < src.triangles.Num(); i++)
+			upper.triangles.Add(src.triangles[i]);
+		src.triangles.SetNum(half);
+
+		updateCluster(src, posData, idxData);
+		updateCluster(upper, posData, idxData);
+		clusters.Add(MoveTemp(upper));
+	}
+
+	for(const auto &cluster: clusters){
+		auto &hull = outHulls.AddDefaulted_GetRef();
+		buildClusterHull(cluster, posData, idxData, hull);
+	}
+	if (outTriangleHulls){
+		outTriangleHulls->SetNumUninitialized(numTris);
+		for(int32 hull = 0; hull < clusters.Num(); hull++){
+			for(auto tri: clusters[hull].triangles)
+				(*outTriangleHulls)[tri] = hull;
+		}
+	}
+}
+
+float MeshCollisionGenerator::getBoundsFillRatio(const TArray<float> &positions, const TArray<int32> &indices){
+	const int32 numVerts = positions.Num() / 3;
+	const int32 numTris = indices.Num() / 3;
+	if ((numVerts == 0) || (numTris == 0))
+		return 0.0f;
+
+	float boundsMin[3] = {1e30f, 1e30f, 1e30f};
+	float boundsMax[3] = {-1e30f, -1e30f, -1e30f};
+	for(int32 i = 0; i < numVerts; i++){
+		for(int32 axis = 0; axis < 3; axis++){
+			boundsMin[axis] = FMath::Min(boundsMin[axis], positions[i * 3 + axis]);
+			boundsMax[axis] = FMath::Max(boundsMax[axis], positions[i * 3 + axis]);
+		}
+	}
+	const float sizeX = boundsMax[0] - boundsMin[0];
+	const float sizeY = boundsMax[1] - boundsMin[1];
+	const float sizeZ = boundsMax[2] - boundsMin[2];
+	const float minSize = FMath::Min3(sizeX, sizeY, sizeZ);
+	const float maxSize = FMath::Max3(sizeX, sizeY, sizeZ);
+	const float midSize = sizeX + sizeY + sizeZ - minSize - maxSize;
+	if (midSize <= 0.0f)
+		return 0.0f;
+
+	//Signed volume (divergence theorem) for closed meshes, area against the largest bounds face for flat ones
+	const bool flat = minSize <= 0.01f * maxSize;
+	double volume = 0.0, area = 0.0;
+	for(int32 tri = 0; tri < numTris; tri++){
+		for(int32 corner = 0; corner < 3; corner++){
+			if ((indices[tri * 3 + corner] < 0) || (indices[tri * 3 + corner] >= numVerts))
+				return 0.0f;
+		}
+		const float *a = positions.GetData() + indices[tri * 3] * 3;
+		const float *b = positions.GetData() + indices[tri * 3 + 1] * 3;
+		const float *c = positions.GetData() + indices[tri * 3 + 2] * 3;
+		const double ab[3] = {(double)b[0] - a[0], (double)b[1] - a[1], (double)b[2] - a[2]};
+		const double ac[3] = {(double)c[0] - a[0], (double)c[1] - a[1], (double)c[2] - a[2]};
+		const double n[3] = {ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0]};
+		area += 0.5 * FMath::Sqrt((float)(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]));
+		//relative to bounds min, keeps the sum well conditioned far from the origin
+		volume += ((a[0] - boundsMin[0]) * n[0] + (a[1] - boundsMin[1]) * n[1] + (a[2] - boundsMin[2]) * n[2]) / 6.0;
+	}
+
+	const double ratio = flat ? area / ((double)midSize * maxSize): FMath::Abs(volume) / ((double)minSize * midSize * maxSize);
+	return (float)FMath::Min(ratio, 1.0);
+}
+
+float MeshCollisionGenerator::getRadiusDeviation(const TArray<float> &positions){
+	const int32 numVerts = positions.Num() / 3;
+	if (numVerts == 0)
+		return 1.0f;
+
+	float boundsMin[3] = {1e30f, 1e30f, 1e30f};
+	float boundsMax[3] = {-1e30f, -1e30f, -1e30f};
+	for(int32 i = 0; i < numVerts; i++){
+		for(int32 axis = 0; axis < 3; axis++){
+			boundsMin[axis] = FMath::Min(boundsMin[axis], positions[i * 3 + axis]);
+			boundsMax[axis] = FMath::Max(boundsMax[axis], positions[i * 3 + axis]);
+		}
+	}
+	const float center[3] = {
+		(boundsMin[0] + boundsMax[0]) * 0.5f, (boundsMin[1] + boundsMax[1]) * 0.5f, (boundsMin[2] + boundsMax[2]) * 0.5f
+	};
+
+	float minDist = 1e30f, maxDist = 0.0f;
+	for(int32 i = 0; i < numVerts; i++){
+		const float dx = positions[i * 3] - center[0];
+		const float dy = positions[i * 3 + 1] - center[1];
+		const float dz = positions[i * 3 + 2] - center[2];
+		const float dist = FMath::Sqrt(dx * dx + dy * dy + dz * dz);
+		minDist = FMath::Min(minDist, dist);
+		maxDist = FMath::Max(maxDist, dist);
+	}
+	if (maxDist <= 0.0f)
+		return 1.0f;
+	return (maxDist - minDist) / maxDist;
+}
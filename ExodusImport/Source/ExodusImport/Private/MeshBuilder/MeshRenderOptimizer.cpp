@@ -0,0 +1,269 @@
+#include "JsonImportPrivatePCH.h"
+#include "MeshRenderOptimizer.h"
+
+int32 MeshRenderOptimizer::buildWeldRemap(int32 numVerts, const TArray<VertexStream> &streams, TArray<int32> &outRemap){
+	TArray<int32> sortedVerts;
+	sortedVerts.SetNumUninitialized(numVerts);
+	for(int32 i = 0; i < numVerts; i++)
+		sortedVerts[i] = i;
+
+	auto compareVerts = [&streams](int32 a, int32 b) -> int32{
+		for(const auto &stream: streams){
+			auto result = FMemory::Memcmp(stream.data + a * stream.stride, stream.data + b * stream.stride, stream.stride);
+			if (result != 0)
+				return result;
+		}
+		return 0;
+	};
+	sortedVerts.Sort([&compareVerts](int32 a, int32 b){
+		auto result = compareVerts(a, b);
+		return (result != 0) ? (result < 0): (a < b);
+	});
+
+	//Lowest index of each group comes first in the sorted order
+	TArray<int32> canonical;
+	canonical.SetNumUninitialized(numVerts);
+	for(int32 i = 0; i < numVerts; i++){
+		const auto cur = sortedVerts[i];
+		if ((i > 0) && (compareVerts(sortedVerts[i - 1], cur) == 0))
+			canonical[cur] = canonical[sortedVerts[i - 1]];
+		else
+			canonical[cur] = cur;
+	}
+
+	outRemap.SetNumUninitialized(numVerts);
+	int32 numUnique = 0;
+	for(int32 v = 0; v < numVerts; v++){
+		if (canonical[v] == v)
+			outRemap[v] = numUnique++;
+		else
+			outRemap[v] = outRemap[canonical[v]];
+	}
+	return numUnique;
+}
+
+int32 MeshRenderOptimizer::buildFetchRemap(const TArray<int32> &indices, int32 numVerts, TArray<int32> &outRemap){
+	outRemap.SetNumUninitialized(numVerts);
+	for(int32 v = 0; v < numVerts; v++)
+		outRemap[v] = -1;
+
+	int32 next = 0;
+	for(auto index: indices){
+		if (outRemap[index] < 0)
+			outRemap[index] = next++;
+	}
+	for(int32 v = 0; v < numVerts; v++){
+		if (outRemap[v] < 0)
+			outRemap[v] = next++;
+	}
+	return next;
+}
+
+void MeshRenderOptimizer::remapIndices(TArray<int32> &indices, const TArray<int32> &remap){
+	for(auto &index: indices)
+		index = remap[index];
+}
+
+static void buildTriangleAdjacency(const TArray<int32> &indices, int32 numVerts, TArray<int32> &outOffsets, TArray<int32> &outTriangles){
+	outOffsets.SetNumZeroed(numVerts + 1);
+	for(auto v: indices)
+		outOffsets[v + 1]++;
+	for(int32 v = 0; v < numVerts; v++)
+		outOffsets[v + 1] += outOffsets[v];
+
+	outTriangles.SetNumUninitialized(indices.Num());
+	TArray<int32> fill;
+	fill.SetNumZeroed(numVerts);
+	for(int32 i = 0; i < indices.Num(); i++){
+		const auto v = indices[i];
+		outTriangles[outOffsets[v] + fill[v]++] = i / 3;
+	}
+}
+
+void MeshRenderOptimizer::optimizeVertexCache(TArray<int32> &indices, int32 numVerts, int32 cacheSize){
+	const int32 numTris = indices.Num() / 3;
+	if (numTris < 2)
+		return;
+
+	TArray<int32> adjOffsets, adjTriangles;
+	buildTriangleAdjacency(indices, numVerts, adjOffsets, adjTriangles);
+
+	TArray<int32> liveTriangles, cacheTime;
+	liveTriangles.SetNumUninitialized(numVerts);
+	cacheTime.SetNumZeroed(numVerts);
+	for(int32 v = 0; v < numVerts; v++)
+		liveTriangles[v] = adjOffsets[v + 1] - adjOffsets[v];
+
+	TArray<uint8> emitted;
+	emitted.SetNumZeroed(numTris);
+	TArray<int32> deadEnd, candidates, result;
+	result.Reserve(numTris * 3);
+
+	int32 timestamp = cacheSize + 1;
+	int32 cursor = 0;
+
+	auto skipDeadEnd = [&]() -> int32{
+		while(deadEnd.Num() > 0){
+			auto v = deadEnd.Last();
+			deadEnd.SetNum(deadEnd.Num() - 1);
+			if (liveTriangles[v] > 0)
+				return v;
+		}
+		for(; cursor < numVerts; cursor++){
+			if (liveTriangles[cursor] > 0)
+				return cursor;
+		}
+		return -1;
+	};
+
+	int32 fanning = skipDeadEnd();
+	while(fanning >= 0){
+		candidates.Empty(candidates.Num());
+		for(int32 adj = adjOffsets[fanning]; adj < adjOffsets[fanning + 1]; adj++){
+			const auto tri = adjTriangles[adj];
+			if (emitted[tri])
+				continue;
+			for(int32 corner = 0; corner < 3; corner++){
+				const auto v = indices[tri * 3 + corner];
+				result.Add(v);
+				deadEnd.Add(v);
+				candidates.Add(v);
+				liveTriangles[v]--;
+				if ((timestamp - cacheTime[v]) > cacheSize)
+					cacheTime[v] = timestamp++;
+			}
+			emitted[tri] = 1;
+		}
+
+		//Prefer vertices that stay in cache while their remaining triangles are emitted
+		int32 best = -1, bestPriority = -1;
+		for(auto v: candidates){
+			if (liveTriangles[v] <= 0)
+				continue;
+			int32 priority = 0;
+			if ((timestamp - cacheTime[v] + 2 * liveTriangles[v]) <= cacheSize)
+				priority = timestamp - cacheTime[v];
+			if (priority > bestPriority){
+				bestPriority = priority;
+				best = v;
+			}
+		}
+		fanning = (best >= 0) ? best: skipDeadEnd();
+	}
+
+	check(result.Num() == numTris * 3);
+	indices = MoveTemp(result);
+}
+
+void MeshRenderOptimizer::optimizeOverdraw(TArray<int32> &indices, const TArray<float> &positions, int32 cacheSize){
+	const int32 numTris = indices.Num() / 3;
+	if (numTris < 2)
+		return;
+	const int32 numVerts = positions.Num() / 3;
+	const float *pos = positions.GetData();
+
+	//Clusters start where a triangle misses the cache with all of its vertices
+	TArray<int32> clusterStarts;
+	{
+		TArray<int32> cacheTime;
+		cacheTime.SetNumZeroed(numVerts);
+		int32 timestamp = cacheSize + 1;
+		for(int32 tri = 0; tri < numTris; tri++){
+			int32 misses = 0;
+			for(int32 corner = 0; corner < 3; corner++){
+				const auto v = indices[tri * 3 + corner];
+				if ((timestamp - cacheTime[v]) > cacheSize){
+					cacheTime[v] = timestamp++;
+					misses++;
+				}
+			}
+			if ((misses == 3) || (tri == 0))
+				clusterStarts.Add(tri);
+		}
+	}
+	const int32 numClusters = clusterStarts.Num();
+	if (numClusters < 2)
+		return;
+
+	struct ClusterInfo{
+		int32 index = 0;
+		double centroid[3] = {0.0, 0.0, 0.0};
+		double normal[3] = {0.0, 0.0, 0.0};
+		double area = 0.0;
+		double sortKey = 0.0;
+	};
+	TArray<ClusterInfo> clusters;
+	clusters.SetNum(numClusters);
+
+	double meshCentroid[3] = {0.0, 0.0, 0.0};
+	double meshArea = 0.0;
+	for(int32 cluster = 0; cluster < numClusters; cluster++){
+		auto &info = clusters[cluster];
+		info.index = cluster;
+		const int32 end = (cluster + 1 < numClusters) ? clusterStarts[cluster + 1]: numTris;
+		for(int32 tri = clusterStarts[cluster]; tri < end; tri++){
+			const float *p0 = pos + indices[tri * 3] * 3;
+			const float *p1 = pos + indices[tri * 3 + 1] * 3;
+			const float *p2 = pos + indices[tri * 3 + 2] * 3;
+			const double e1[3] = {(double)p1[0] - p0[0], (double)p1[1] - p0[1], (double)p1[2] - p0[2]};
+			const double e2[3] = {(double)p2[0] - p0[0], (double)p2[1] - p0[1], (double)p2[2] - p0[2]};
+			const double n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+			const double area = FMath::Sqrt((float)(n[0] * n[0] + n[1] * n[1] + n[2] * n[2])) * 0.5;
+			for(int32 axis = 0; axis < 3; axis++){
+				const double center = ((double)p0[axis] + p1[axis] + p2[axis]) / 3.0;
+				info.centroid[axis] += center * area;
+				info.normal[axis] += n[axis];
+				meshCentroid[axis] += center * area;
+			}
+			info.area += area;
+			meshArea += area;
+		}
+	}
+	if (meshArea <= 0.0)
+		return;
+	for(int32 axis = 0; axis < 3; axis++)
+		meshCentroid[axis] /= meshArea;
+
+	for(auto &info: clusters){
+		if (info.area <= 0.0)
+			continue;
+		const double normalLen = FMath::Sqrt((float)(info.normal[0] * info.normal[0] + info.normal[1] * info.normal[1] + info.normal[2] * info.normal[2]));
+		if (normalLen <= 0.0)
+			continue;
+		for(int32 axis = 0; axis < 3; axis++)
+			info.sortKey += (info.centroid[axis] / info.area - meshCentroid[axis]) * info.normal[axis] / normalLen;
+	}
+
+	//Outward facing clusters are likely to occlude the rest
+	clusters.Sort([](const ClusterInfo &a, const ClusterInfo &b){
+		if (a.sortKey != b.sortKey)
+			return a.sortKey > b.sortKey;
+		return a.index < b.index;
+	});
+
+	TArray<int32> result;
+	result.Reserve(indices.Num());
+	for(const auto &info: clusters){
+		const int32 end = (info.index + 1 < numClusters) ? clusterStarts[info.index + 1]: numTris;
+		for(int32 i = clusterStarts[info.index] * 3; i < end * 3; i++)
+			result.Add(indices[i]);
+	}
+	indices = MoveTemp(result);
+}
+
+float MeshRenderOptimizer::computeACMR(const TArray<int32> &indices, int32 numVerts, int32 cacheSize){
+	const int32 numTris = indices.Num() / 3;
+	if (!numTris)
+		return 0.0f;
+	TArray<int32> cacheTime;
+	cacheTime.SetNumZeroed(numVerts);
+	int32 timestamp = cacheSize + 1;
+	int32 misses = 0;
+	for(auto v: indices){
+		if ((timestamp - cacheTime[v]) > cacheSize){
+			cacheTime[v] = timestamp++;
+			misses++;
+		}
+	}
+	return (float)misses / numTris;
+}
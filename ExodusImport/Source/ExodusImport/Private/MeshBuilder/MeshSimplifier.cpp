@@ -0,0 +1,317 @@
+#include "JsonImportPrivatePCH.h"
+#include "MeshSimplifier.h"
+
+namespace{
+	/*
+	Symmetric 4x4 error quadric of a set of planes.
+	*/
+	struct Quadric{
+		double a00 = 0.0, a01 = 0.0, a02 = 0.0, a03 = 0.0;
+		double a11 = 0.0, a12 = 0.0, a13 = 0.0;
+		double a22 = 0.0, a23 = 0.0;
+		double a33 = 0.0;
+
+		void addPlane(double a, double b, double c, double d, double weight){
+			a00 += weight * a * a; a01 += weight * a * b; a02 += weight * a * c; a03 += weight * a * d;
+			a11 += weight * b * b; a12 += weight * b * c; a13 += weight * b * d;
+			a22 += weight * c * c; a23 += weight * c * d;
+			a33 += weight * d * d;
+		}
+
+		void add(const Quadric &other){
+			a00 += other.a00; a01 += other.a01; a02 += other.a02; a03 += other.a03;
+			a11 += other.a11; a12 += other.a12; a13 += other.a13;
+			a22 += other.a22; a23 += other.a23;
+			a33 += other.a33;
+		}
+
+		double eval(const float *p) const{
+			const double x = p[0], y = p[1], z = p[2];
+			double result = a00 * x * x + 2.0 * a01 * x * y + 2.0 * a02 * x * z + 2.0 * a03 * x
+				+ a11 * y * y + 2.0 * a12 * y * z + 2.0 * a13 * y
+				+ a22 * z * z + 2.0 * a23 * z
+				+ a33;
+			return (result > 0.0) ? result: 0.0;
+		}
+	};
+
+	struct Collapse{
+		int32 from = 0;
+		int32 to = 0;
+		double cost = 0.0;
+	};
+
+	void triangleNormal(const float *p0, const float *p1, const float *p2, double *outNormal){
+		const double e1[3] = {(double)p1[0] - p0[0], (double)p1[1] - p0[1], (double)p1[2] - p0[2]};
+		const double e2[3] = {(double)p2[0] - p0[0], (double)p2[1] - p0[1], (double)p2[2] - p0[2]};
+		outNormal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+		outNormal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+		outNormal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+	}
+
+	bool isDegenerate(const int32 *tri){
+		return (tri[0] == tri[1]) || (tri[1] == tri[2]) || (tri[0] == tri[2]);
+	}
+}
+
+float MeshSimplifier::simplify(const TArray<float> &positions, const IndexRangeArray &ranges, int32 targetTriangles, IndexRangeArray &outRanges, 
+		const TArray<int32> *vertexGroups){
+	const int32 numVerts = positions.Num() / 3;
+	const float *pos = positions.GetData();
+	const int32 *groups = (vertexGroups && (vertexGroups->Num() == numVerts)) ? vertexGroups->GetData(): nullptr;
+
+	TArray<int32> indices;
+	TArray<int32> triRanges;
+	for(int32 rangeIndex = 0; rangeIndex < ranges.Num(); rangeIndex++){
+		const auto &range = ranges[rangeIndex];
+		for(int32 i = 0; (i + 2) < range.Num(); i += 3){
+			const int32 tri[3] = {range[i], range[i + 1], range[i + 2]};
+			if ((tri[0] < 0) || (tri[1] < 0) || (tri[2] < 0) || (tri[0] >= numVerts) || (tri[1] >= numVerts) || (tri[2] >= numVerts))
+				continue;
+			if (isDegenerate(tri))
+				continue;
+			indices.Add(tri[0]);
+			indices.Add(tri[1]);
+			indices.Add(tri[2]);
+			triRanges.Add(rangeIndex);
+		}
+	}
+
+	//Vertices sharing a position are welded for topology and quadrics
+	TArray<int32> sortedVerts;
+	sortedVerts.SetNumUninitialized(numVerts);
+	for(int32 i = 0; i < numVerts; i++)
+		sortedVerts[i] = i;
+	auto lessPos = [pos](int32 a, int32 b){
+		const float *pa = pos + a * 3, *pb = pos + b * 3;
+		if (pa[0] != pb[0])
+			return pa[0] < pb[0];
+		if (pa[1] != pb[1])
+			return pa[1] < pb[1];
+		if (pa[2] != pb[2])
+			return pa[2] < pb[2];
+		return a < b;
+	};
+	sortedVerts.Sort(lessPos);
+
+	TArray<int32> posGroup;
+	TArray<int32> groupSize;
+	posGroup.SetNumUninitialized(numVerts);
+	groupSize.SetNumZeroed(numVerts);
+	for(int32 i = 0; i < numVerts; i++){
+		const auto cur = sortedVerts[i];
+		int32 group = cur;
+		if (i > 0){
+			const auto prev = sortedVerts[i - 1];
+			const float *pa = pos + prev * 3, *pb = pos + cur * 3;
+			if ((pa[0] == pb[0]) && (pa[1] == pb[1]) && (pa[2] == pb[2]))
+				group = posGroup[prev];
+		}
+		posGroup[cur] = group;
+		groupSize[group]++;
+	}
+
+	TArray<uint8> locked;
+	TArray<int32> vertRange;
+	locked.SetNumZeroed(numVerts);
+	vertRange.SetNumUninitialized(numVerts);
+	for(int32 i = 0; i < numVerts; i++)
+		vertRange[i] = -1;
+
+	const int32 numTris = indices.Num() / 3;
+	for(int32 tri = 0; tri < numTris; tri++){
+		for(int32 corner = 0; corner < 3; corner++){
+			const auto v = indices[tri * 3 + corner];
+			if (groupSize[posGroup[v]] > 1)
+				locked[v] = 1;
+			if ((vertRange[v] >= 0) && (vertRange[v] != triRanges[tri]))
+				locked[v] = 1;
+			vertRange[v] = triRanges[tri];
+		}
+	}
+
+	//Open border edges are used by a single triangle
+	TArray<uint64> edges;
+	edges.Reserve(indices.Num());
+	for(int32 tri = 0; tri < numTris; tri++){
+		for(int32 corner = 0; corner < 3; corner++){
+			auto a = (uint64)posGroup[indices[tri * 3 + corner]];
+			auto b = (uint64)posGroup[indices[tri * 3 + (corner + 1) % 3]];
+			edges.Add((a < b) ? ((a << 32) | b): ((b << 32) | a));
+		}
+	}
+	edges.Sort([](uint64 a, uint64 b){return a < b;});
+
+	TArray<uint8> lockedGroups;
+	lockedGroups.SetNumZeroed(numVerts);
+	for(int32 i = 0; i < edges.Num();){
+		int32 next = i + 1;
+		while((next < edges.Num()) && (edges[next] == edges[i]))
+			next++;
+		if ((next - i) == 1){
+			lockedGroups[(int32)(edges[i] >> 32)] = 1;
+			lockedGroups[(int32)(edges[i] & 0xFFFFFFFFu)] = 1;
+		}
+		i = next;
+	}
+	for(int32 i = 0; i < numVerts; i++){
+		if (lockedGroups[posGroup[i]])
+			locked[i] = 1;
+	}
+
+	TArray<Quadric> quadrics;
+	quadrics.SetNum(numVerts);
+	for(int32 tri = 0; tri < numTris; tri++){
+		const float *p[3] = {pos + indices[tri * 3] * 3, pos + indices[tri * 3 + 1] * 3, pos + indices[tri * 3 + 2] * 3};
+		double normal[3];
+		triangleNormal(p[0], p[1], p[2], normal);
+		const double len = FMath::Sqrt((float)(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]));
+		if (len <= 0.0)
+			continue;
+		const double a = normal[0] / len, b = normal[1] / len, c = normal[2] / len;
+		const double d = -(a * p[0][0] + b * p[0][1] + c * p[0][2]);
+		//Weighted by area so small sliver triangles do not dominate
+		const double weight = len * 0.5;
+		for(int32 corner = 0; corner < 3; corner++)
+			quadrics[posGroup[indices[tri * 3 + corner]]].addPlane(a, b, c, d, weight);
+	}
+
+	TArray<int32> remap;
+	remap.SetNumUninitialized(numVerts);
+	for(int32 i = 0; i < numVerts; i++)
+		remap[i] = i;
+
+	TArray<int32> adjOffsets, adjTriangles;
+	TArray<uint8> touched;
+	TArray<Collapse> collapses;
+	double maxError = 0.0;
+	int32 curTris = numTris;
+	const int32 maxPasses = 64;
+
+	for(int32 pass = 0; (pass < maxPasses) && (curTris > targetTriangles); pass++){
+		//Vertex to triangle adjacency of the current index buffer
+		adjOffsets.SetNumZeroed(numVerts + 1);
+		for(auto v: indices)
+			adjOffsets[v + 1]++;
+		for(int32 i = 0; i < numVerts; i++)
+			adjOffsets[i + 1] += adjOffsets[i];
+		adjTriangles.SetNumUninitialized(indices.Num());
+		{
+			TArray<int32> fill;
+			fill.SetNumZeroed(numVerts);
+			for(int32 i = 0; i < indices.Num(); i++){
+				const auto v = indices[i];
+				adjTriangles[adjOffsets[v] + fill[v]++] = i / 3;
+			}
+		}
+
+		collapses.Empty(indices.Num());
+		for(int32 tri = 0; tri < curTris; tri++){
+			for(int32 corner = 0; corner < 3; corner++){
+				const auto from = indices[tri * 3 + corner];
+				if (locked[from])
+					continue;
+				for(int32 other = 1; other < 3; other++){
+					const auto to = indices[tri * 3 + (corner + other) % 3];
+					if (groups && (groups[from] != groups[to]))
+						continue;
+					Collapse collapse;
+					collapse.from = from;
+					collapse.to = to;
+					Quadric q = quadrics[posGroup[from]];
+					q.add(quadrics[posGroup[to]]);
+					collapse.cost = q.eval(pos + to * 3);
+					collapses.Add(collapse);
+				}
+			}
+		}
+		if (collapses.Num() == 0)
+			break;
+		collapses.Sort([](const Collapse &a, const Collapse &b){
+			if (a.cost != b.cost)
+				return a.cost < b.cost;
+			if (a.from != b.from)
+				return a.from < b.from;
+			return a.to < b.to;
+		});
+
+		touched.SetNumZeroed(numVerts);
+		const int32 trianglesToRemove = curTris - targetTriangles;
+		int32 removed = 0;
+		int32 numCollapsed = 0;
+		for(const auto &collapse: collapses){
+			if (removed >= trianglesToRemove)
+				break;
+			if (touched[collapse.from] || touched[collapse.to])
+				continue;
+
+			//Reject collapses that flip neighbouring triangles
+			bool flips = false;
+			int32 numDegenerate = 0;
+			for(int32 adj = adjOffsets[collapse.from]; adj < adjOffsets[collapse.from + 1]; adj++){
+				const int32 *tri = &indices[adjTriangles[adj] * 3];
+				if ((tri[0] == collapse.to) || (tri[1] == collapse.to) || (tri[2] == collapse.to)){
+					numDegenerate++;
+					continue;
+				}
+				const float *p[3], *moved[3];
+				for(int32 corner = 0; corner < 3; corner++){
+					p[corner] = pos + tri[corner] * 3;
+					moved[corner] = (tri[corner] == collapse.from) ? pos + collapse.to * 3: p[corner];
+				}
+				double before[3], after[3];
+				triangleNormal(p[0], p[1], p[2], before);
+				triangleNormal(moved[0], moved[1], moved[2], after);
+				if ((before[0] * after[0] + before[1] * after[1] + before[2] * after[2]) <= 0.0){
+					flips = true;
+					break;
+				}
+			}
+			if (flips || !numDegenerate)
+				continue;
+
+			//Adjacency of the whole one-ring is stale after the collapse
+			for(int32 adj = adjOffsets[collapse.from]; adj < adjOffsets[collapse.from + 1]; adj++){
+				const int32 *tri = &indices[adjTriangles[adj] * 3];
+				touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = 1;
+			}
+			touched[collapse.to] = 1;
+
+			remap[collapse.from] = collapse.to;
+			quadrics[posGroup[collapse.to]].add(quadrics[posGroup[collapse.from]]);
+			maxError = FMath::Max(maxError, collapse.cost);
+			removed += numDegenerate;
+			numCollapsed++;
+		}
+		if (!numCollapsed)
+			break;
+
+		int32 writeTri = 0;
+		for(int32 tri = 0; tri < curTris; tri++){
+			int32 newTri[3] = {remap[indices[tri * 3]], remap[indices[tri * 3 + 1]], remap[indices[tri * 3 + 2]]};
+			if (isDegenerate(newTri))
+				continue;
+			indices[writeTri * 3] = newTri[0];
+			indices[writeTri * 3 + 1] = newTri[1];
+			indices[writeTri * 3 + 2] = newTri[2];
+			triRanges[writeTri] = triRanges[tri];
+			writeTri++;
+		}
+		curTris = writeTri;
+		indices.SetNum(curTris * 3);
+		triRanges.SetNum(curTris);
+		for(int32 i = 0; i < numVerts; i++)
+			remap[i] = i;
+	}
+
+	outRanges.Empty(ranges.Num());
+	outRanges.AddDefaulted(ranges.Num());
+	for(int32 tri = 0; tri < curTris; tri++){
+		auto &range = outRanges[triRanges[tri]];
+		range.Add(indices[tri * 3]);
+		range.Add(indices[tri * 3 + 1]);
+		range.Add(indices[tri * 3 + 2]);
+	}
+
+	return (float)maxError;
+}
@@ -0,0 +1,93 @@
+#include "JsonImportPrivatePCH.h"
+#include "MeshBuilder.h"
+#include "RawMesh.h"
+
+template<typename T> static void appendWedgeChannel(TArray<T> &dst, const TArray<T> &src, const TArray<int32> &wedgeOrder, 
+		int32 dstNumWedges, const T &defaultValue, std::function<T(const T&)> transformFunc = nullptr){
+	const bool srcHasChannel = src.Num() == wedgeOrder.Num();
+	const bool dstHasChannel = dst.Num() > 0;
+	if (!srcHasChannel && !dstHasChannel)
+		return;
+
+	//Meshes appended earlier did not have this channel
+	if (dst.Num() < dstNumWedges){
+		dst.Reserve(dstNumWedges + wedgeOrder.Num());
+		while(dst.Num() < dstNumWedges)
+			dst.Add(defaultValue);
+	}
+
+	if (!srcHasChannel){
+		dst.AddUninitialized(wedgeOrder.Num());
+		for(int32 i = 0; i < wedgeOrder.Num(); i++)
+			dst[dstNumWedges + i] = defaultValue;
+		return;
+	}
+
+	dst.Reserve(dstNumWedges + wedgeOrder.Num());
+	for(auto srcWedge: wedgeOrder){
+		if (transformFunc)
+			dst.Add(transformFunc(src[srcWedge]));
+		else
+			dst.Add(src[srcWedge]);
+	}
+}
+
+void MeshBuilder::appendRawMesh(FRawMesh &dstMesh, const FRawMesh &srcMesh, const FMatrix &transform, const IntArray &materialRemap){
+	const int32 numSrcWedges = srcMesh.WedgeIndices.Num();
+	const int32 numSrcFaces = numSrcWedges / 3;
+	if (!numSrcFaces)
+		return;
+
+	const int32 dstNumWedges = dstMesh.WedgeIndices.Num();
+	const int32 dstNumFaces = dstNumWedges / 3;
+	const int32 baseVertex = dstMesh.VertexPositions.Num();
+
+	//Mirroring transforms flip the winding
+	const float determinant = transform.Determinant();
+	const bool flipWinding = determinant < 0.0f;
+	FMatrix normalMatrix = transform.RemoveTranslation().TransposeAdjoint();
+	if (flipWinding)
+		normalMatrix = normalMatrix * -1.0f;
+
+	TArray<int32> wedgeOrder;
+	wedgeOrder.SetNumUninitialized(numSrcFaces * 3);
+	for(int32 face = 0; face < numSrcFaces; face++){
+		const int32 base = face * 3;
+		wedgeOrder[base] = base;
+		wedgeOrder[base + 1] = flipWinding ? base + 2: base + 1;
+		wedgeOrder[base + 2] = flipWinding ? base + 1: base + 2;
+	}
+
+	dstMesh.VertexPositions.Reserve(baseVertex + srcMesh.VertexPositions.Num());
+	for(const auto &pos: srcMesh.VertexPositions)
+		dstMesh.VertexPositions.Add(transform.TransformPosition(pos));
+
+	dstMesh.WedgeIndices.Reserve(dstNumWedges + wedgeOrder.Num());
+	for(auto srcWedge: wedgeOrder)
+		dstMesh.WedgeIndices.Add(srcMesh.WedgeIndices[srcWedge] + baseVertex);
+
+	auto transformTangent = [&](const FVector &arg) -> FVector{
+		return transform.TransformVector(arg).GetSafeNormal();
+	};
+	auto transformNormal = [&](const FVector &arg) -> FVector{
+		return normalMatrix.TransformVector(arg).GetSafeNormal();
+	};
+	appendWedgeChannel<FVector>(dstMesh.WedgeTangentX, srcMesh.WedgeTangentX, wedgeOrder, dstNumWedges, FVector::ZeroVector, transformTangent);
+	appendWedgeChannel<FVector>(dstMesh.WedgeTangentY, srcMesh.WedgeTangentY, wedgeOrder, dstNumWedges, FVector::ZeroVector, transformTangent);
+	appendWedgeChannel<FVector>(dstMesh.WedgeTangentZ, srcMesh.WedgeTangentZ, wedgeOrder, dstNumWedges, FVector::ZeroVector, transformNormal);
+	appendWedgeChannel<FColor>(dstMesh.WedgeColors, srcMesh.WedgeColors, wedgeOrder, dstNumWedges, FColor::White);
+	for(int32 uvIndex = 0; uvIndex < MAX_MESH_TEXTURE_COORDS; uvIndex++){
+		appendWedgeChannel<FVector2D>(dstMesh.WedgeTexCoords[uvIndex], srcMesh.WedgeTexCoords[uvIndex], wedgeOrder, 
+			dstNumWedges, FVector2D::ZeroVector);
+	}
+
+	dstMesh.FaceMaterialIndices.Reserve(dstNumFaces + numSrcFaces);
+	dstMesh.FaceSmoothingMasks.Reserve(dstNumFaces + numSrcFaces);
+	for(int32 face = 0; face < numSrcFaces; face++){
+		int32 matIndex = srcMesh.FaceMaterialIndices.IsValidIndex(face) ? srcMesh.FaceMaterialIndices[face]: 0;
+		if (materialRemap.Num() > 0)
+			matIndex = materialRemap[FMath::Clamp(matIndex, 0, materialRemap.Num() - 1)];
+		dstMesh.FaceMaterialIndices.Add(matIndex);
+		dstMesh.FaceSmoothingMasks.Add(srcMesh.FaceSmoothingMasks.IsValidIndex(face) ? srcMesh.FaceSmoothingMasks[face]: 0);
+	}
+}
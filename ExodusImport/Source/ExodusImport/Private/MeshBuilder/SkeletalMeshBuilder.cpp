@@ -1,13 +1,16 @@
 #include "JsonImportPrivatePCH.h"
 #include "SkeletalMeshBuilder.h"
+#include "SkeletalMeshInfluence.h"
 #include "MeshBuilder.h"
 #include "MeshBuilderUtils.h"
 #include "UnrealUtilities.h"
 #include "Runtime/Engine/Public/Rendering/SkeletalMeshModel.h"
 #include "Developer/MeshUtilities/Public/MeshUtilities.h"
 #include "JsonImporter.h"
+#include "ImportProfiler.h"
 #include "JsonObjects/loggers.h"
 #include "AssetRegistryModule.h"
+#include "Async/ParallelFor.h"
 
 #include "Runtime/Engine/Classes/Animation/MorphTarget.h"
 #include "Runtime/Engine/Classes/Animation/Skeleton.h"
@@ -18,136 +21,119 @@ using namespace JsonObjects;
 using namespace MeshBuilderUtils;
 
 void SkeletalMeshBuilder::setupReferenceSkeleton(FReferenceSkeleton &refSkeleton, const JsonSkeleton &jsonSkel, const JsonMesh *jsonMesh, const USkeleton *unrealSkeleton) const{
+	IMPORT_PROFILE_SCOPE_ASSET("SkeletalMeshBuilder::setupReferenceSkeleton", jsonSkel.name);
 	refSkeleton.Empty();
 	FReferenceSkeletonModifier refSkelModifier(refSkeleton, unrealSkeleton);//nullptr);
 
-	MatrixArray unityBoneWorldTransforms;
-	MatrixArray unrealBoneWorldTransforms;
-
-	unityBoneWorldTransforms.SetNum(jsonSkel.bones.Num());
-	unrealBoneWorldTransforms.SetNum(jsonSkel.bones.Num());
-
+	const int32 numBones = jsonSkel.bones.Num();
 	UE_LOG(JsonLog, Log, TEXT("Reconstructing skeleton: %s"), *jsonSkel.name);
 
-	for(int boneIndex = 0; boneIndex < jsonSkel.bones.Num(); boneIndex++){
-		//UE_LOG(JsonLog, Log, TEXT("Processing bone %d out of %d"), boneIndex, jsonSkel->bones.Num());
-		auto &unityWorldMat = unityBoneWorldTransforms[boneIndex];
-		auto &unrealWorldMat = unrealBoneWorldTransforms[boneIndex];
-			
-		unityWorldMat = unrealWorldMat = FMatrix::Identity;
-
-		const auto &srcBone = jsonSkel.bones[boneIndex];
-
-		/*
-		logValue(TEXT("srcBone.id: "), srcBone.id);
-		logValue(TEXT("srcBone.bane: "), srcBone.name);
-		logValue(TEXT("srcBone.parentId: "), srcBone.parentId);
-		logValue(TEXT("localMatrix: "), srcBone.local);
-		logValue(TEXT("worldMatrix: "), srcBone.world);
-		*/
-
-		auto parentBoneIndex = srcBone.parentId >= 0 ? srcBone.parentId: INDEX_NONE;
-		auto boneInfo = FMeshBoneInfo(FName(*srcBone.name), srcBone.name, parentBoneIndex);
-
-		unityWorldMat = srcBone.world;
-
-		if (jsonMesh){
-			auto foundBoneIndex = jsonMesh->defaultBoneNames.IndexOfByKey(srcBone.name);
-			UE_LOG(JsonLog, Log, TEXT("Attempting to find foundBoneIndex for bone \"%s\" on mesh %d(\"%s\")"), 
-				*srcBone.name, jsonMesh->id.toIndex(), *jsonMesh->name);
-			if (foundBoneIndex != INDEX_NONE){
-				auto boneMatrix = jsonMesh->inverseBindPoses[foundBoneIndex];
-				UE_LOG(JsonLog, Log, TEXT("Bone index found: %d"), foundBoneIndex);
-				logValue(TEXT("Matrix: "), boneMatrix);
-				unityWorldMat = boneMatrix;
-			}
-			else{
-				UE_LOG(JsonLog, Warning, TEXT("Bone \"%s\" not found"), *srcBone.name);
+	/*
+	Bind poses of the mesh override skeleton ones for the bones the mesh uses. 
+	Everything else comes from matrices cached in the skeleton (see JsonSkeleton::buildIndex).
+	*/
+	IntArray meshBoneIndices;
+	meshBoneIndices.Init(INDEX_NONE, numBones);
+	MatrixArray meshWorldMatrices, meshInvWorldMatrices;
+	if (jsonMesh){
+		for(int32 meshBoneIndex = 0; meshBoneIndex < jsonMesh->defaultBoneNames.Num(); meshBoneIndex++){
+			const auto boneIndex = jsonSkel.findBoneIndex(jsonMesh->defaultBoneNames[meshBoneIndex]);
+			if ((boneIndex >= 0) && (meshBoneIndices[boneIndex] == INDEX_NONE) && (meshBoneIndex < jsonMesh->inverseBindPoses.Num()))
+				meshBoneIndices[boneIndex] = meshBoneIndex;
+		}
+		meshWorldMatrices.SetNumUninitialized(numBones);
+		meshInvWorldMatrices.SetNumUninitialized(numBones);
+		int32 numMissing = 0;
+		for(int32 boneIndex = 0; boneIndex < numBones; boneIndex++){
+			const auto meshBoneIndex = meshBoneIndices[boneIndex];
+			if (meshBoneIndex == INDEX_NONE){
+				meshWorldMatrices[boneIndex] = jsonSkel.unrealWorldBindMatrices[boneIndex];
+				meshInvWorldMatrices[boneIndex] = jsonSkel.unrealInvWorldBindMatrices[boneIndex];
+				numMissing++;
+				continue;
 			}
+			meshWorldMatrices[boneIndex] = unityWorldToUe(jsonMesh->inverseBindPoses[meshBoneIndex]);
+			meshInvWorldMatrices[boneIndex] = meshWorldMatrices[boneIndex].Inverse();
 		}
+		if (numMissing > 0){
+			UE_LOG(JsonLog, Log, TEXT("%d of %d bones of skeleton %s are not bound by mesh %d(\"%s\"), skeleton bind pose is used for them"), 
+				numMissing, numBones, *jsonSkel.name, jsonMesh->id.toIndex(), *jsonMesh->name);
+		}
+	}
 
-		unrealWorldMat = unityWorldToUe(unityWorldMat);
-
-		//logValue(TEXT("unityWorldMat: "), unityWorldMat);
-		//logValue(TEXT("unrealWorldMat: "), unrealWorldMat);
-
-		auto unrealLocalMat = unrealWorldMat;
-
-		if (parentBoneIndex >= 0){
-			auto parentWorld = unrealBoneWorldTransforms[parentBoneIndex];
-			//logValue(TEXT("parent: "), parentWorld);
-			auto invParent = parentWorld.Inverse();
-			//logValue(TEXT("invParent: "), invParent);
-			unrealLocalMat = unrealLocalMat * invParent;
+	for(int32 refIndex = 0; refIndex < numBones; refIndex++){
+		const auto boneIndex = jsonSkel.refBoneOrder[refIndex];
+		const auto parentRefIndex = jsonSkel.refParentIndices[refIndex];
+		const auto parentBoneIndex = (parentRefIndex != INDEX_NONE) ? jsonSkel.refBoneOrder[parentRefIndex]: INDEX_NONE;
+		const auto &srcBone = jsonSkel.bones[boneIndex];
+		auto boneInfo = FMeshBoneInfo(FName(*srcBone.name), srcBone.name, parentRefIndex);
+
+		auto unrealLocalMat = jsonSkel.unrealLocalBindMatrices[boneIndex];
+		const bool meshBound = (meshBoneIndices[boneIndex] != INDEX_NONE) || 
+			((parentBoneIndex != INDEX_NONE) && (meshBoneIndices[parentBoneIndex] != INDEX_NONE));
+		if (meshBound){
+			unrealLocalMat = meshWorldMatrices[boneIndex];
+			if (parentBoneIndex != INDEX_NONE)
+				unrealLocalMat = unrealLocalMat * meshInvWorldMatrices[parentBoneIndex];
 		}
-		//logValue(TEXT("unrealLocalMat: "), unrealLocalMat);
 
 		FTransform boneTransform;
-		//auto boneTransform = unityWorldToUe(srcBone.pose);
 		boneTransform.SetFromMatrix(unrealLocalMat);
 
 		refSkelModifier.Add(boneInfo, boneTransform);
 	}
 }
 
-void SkeletalMeshBuildData::processWedgeData(const JsonMesh &jsonMesh){
-	const auto numTexCoords = jsonMesh.getNumTexCoords();
+void SkeletalMeshBuildData::processWedgeData(const JsonMesh &jsonMesh, int32 lod){
+	IMPORT_PROFILE_SCOPE_ASSET("SkeletalMeshBuildData::processWedgeData", jsonMesh.name);
+	const int32 numTexCoords = FMath::Min(jsonMesh.getNumTexCoords(), (int32)MAX_TEXCOORDS);
 
 	check(hasNormals == (jsonMesh.normals.Num() != 0));
 	check(hasTangents == (jsonMesh.tangents.Num() != 0));
 	check(hasColors == (jsonMesh.colors.Num() != 0));
-	/*
-	auto hasNormals = jsonMesh.normals.Num() != 0;
-	auto hasTangents = jsonMesh.tangents.Num() != 0;
-	auto hasColors = jsonMesh.colors.Num() != 0;
-	*/
 
-	for(int subMeshIndex = 0; subMeshIndex < jsonMesh.subMeshes.Num(); subMeshIndex++){
-		const auto &curSubMesh = jsonMesh.subMeshes[subMeshIndex];
-		for(int vertIndexOffset = 0; (vertIndexOffset + 2) < curSubMesh.triangles.Num(); vertIndexOffset += 3){
-			auto& dstFace = meshFaces.AddDefaulted_GetRef();
-			dstFace.MeshMaterialIndex = subMeshIndex;
+	ConvertedVertexStreams streams;
+	convertVertexStreams(jsonMesh, streams, false);
+
+	IntArray wedgeVerts, faceMaterials;
+	buildWedgeVertices(jsonMesh, lod, wedgeVerts, faceMaterials);
+
+	const int32 numFaces = faceMaterials.Num();
+	const int32 firstFace = meshFaces.Num();
+	const int32 firstWedge = meshWedges.Num();
+	meshFaces.AddDefaulted(numFaces);
+	meshWedges.AddDefaulted(numFaces * 3);
+
+	const bool useNormals = streams.hasNormals();
+	const bool useTangents = streams.hasTangents();
+	const bool useColors = streams.hasColors();
+	parallelRange(numFaces, [&](int32 first, int32 last){
+		for(int32 faceIndex = first; faceIndex < last; faceIndex++){
+			auto &dstFace = meshFaces[firstFace + faceIndex];
+			dstFace.MeshMaterialIndex = faceMaterials[faceIndex];
 			dstFace.SmoothingGroups = 0;
 
-			auto processFaceVertex = [&](int dstFaceIdx, int srcFaceIdx){
-				auto srcIdx = vertIndexOffset + srcFaceIdx;
+			for(int32 corner = 0; corner < 3; corner++){
+				const int32 wedgeIndex = faceIndex * 3 + corner;
+				const int32 srcVertIdx = wedgeVerts[wedgeIndex];
 
-				auto curWedgeIndex = meshWedges.Num();
-
-				auto& dstWedge = meshWedges.AddDefaulted_GetRef();
-				auto srcVertIdx = curSubMesh.triangles[srcIdx];
+				auto &dstWedge = meshWedges[firstWedge + wedgeIndex];
 				dstWedge.iVertex = srcVertIdx;
-
-				if (hasColors)
-					dstWedge.Color = getIdxColor(jsonMesh.colors, srcVertIdx);
-
-				if (numTexCoords >= 1)
-					dstWedge.UVs[0] = unityUvToUnreal(getIdxVector2(jsonMesh.uv0, srcVertIdx));
-				if (numTexCoords >= 2)
-					dstWedge.UVs[1] = unityUvToUnreal(getIdxVector2(jsonMesh.uv1, srcVertIdx));
-				if (numTexCoords >= 3)
-					dstWedge.UVs[2] = unityUvToUnreal(getIdxVector2(jsonMesh.uv2, srcVertIdx));
-				if (numTexCoords >= 4)
-					dstWedge.UVs[3] = unityUvToUnreal(getIdxVector2(jsonMesh.uv3, srcVertIdx));
-
-				processTangent(srcVertIdx, jsonMesh.normals, jsonMesh.tangents, hasNormals, hasTangents, 
-					[&](const auto &norm){
-						dstFace.TangentZ[dstFaceIdx] = norm;
-					},
-					[&](const auto &tanU, const auto &tanV){
-						dstFace.TangentX[dstFaceIdx] = tanU;
-						dstFace.TangentY[dstFaceIdx] = tanV;
-					}
-				);
-
-				dstFace.iWedge[dstFaceIdx] = curWedgeIndex;
-			};
-
-			processFaceVertex(0, 0);
-			processFaceVertex(1, 2);
-			processFaceVertex(2, 1);
+				if (useColors)
+					dstWedge.Color = streams.colors[srcVertIdx];
+				for(int32 uvIndex = 0; uvIndex < numTexCoords; uvIndex++)
+					dstWedge.UVs[uvIndex] = streams.uvs[uvIndex][srcVertIdx];
+
+				if (useNormals)
+					dstFace.TangentZ[corner] = streams.normals[srcVertIdx];
+				if (useTangents){
+					dstFace.TangentX[corner] = streams.tangentsX[srcVertIdx];
+					dstFace.TangentY[corner] = streams.tangentsY[srcVertIdx];
+				}
+				dstFace.iWedge[corner] = firstWedge + wedgeIndex;
+			}
 		}
-	}
+	});
 }
 
 void SkeletalMeshBuildData::startWithMesh(const JsonMesh &jsonMesh){
@@ -156,7 +142,10 @@ void SkeletalMeshBuildData::startWithMesh(const JsonMesh &jsonMesh){
 	hasColors = jsonMesh.colors.Num() != 0;
 }
 
-void SkeletalMeshBuildData::buildSkeletalMesh(FSkeletalMeshLODModel &lodModel, const FReferenceSkeleton &refSkeleton, const JsonMesh &jsonMesh){
+void SkeletalMeshBuildData::buildSkeletalMesh(FSkeletalMeshLODModel &lodModel, const FReferenceSkeleton &refSkeleton, const JsonMesh &jsonMesh, 
+		IMeshUtilities &meshUtils){
+	ImportProfileScope profileScope(TEXT("SkeletalMeshBuildData::buildSkeletalMesh"), jsonMesh.name);
+	profileScope.addElements(jsonMesh.verts.Num() / 3);
 	IMeshUtilities::MeshBuildOptions buildOptions;
 	buildOptions.bComputeNormals = !hasNormals;
 	buildOptions.bComputeTangents = !hasTangents;//true;
@@ -167,7 +156,6 @@ void SkeletalMeshBuildData::buildSkeletalMesh(FSkeletalMeshLODModel &lodModel, c
 	buildOptions.OverlappingThresholds.ThresholdUV = 0.0f;
 	*/
 
-	IMeshUtilities& meshUtils = FModuleManager::Get().LoadModuleChecked<IMeshUtilities>("MeshUtilities");
 	meshUtils.BuildSkeletalMesh(lodModel, 
 		refSkeleton, 
 		meshInfluences, meshWedges, meshFaces, meshPoints, 
@@ -205,256 +193,201 @@ void SkeletalMeshBuildData::computeBoundingBox(USkeletalMesh *skelMesh, const Js
 }
 
 
-struct SkeletalMeshInfluence{
-	int boneIndex = 0;
-	float weight = 0.0f;
-	int intWeight = 0;
-	void recomputeInt(){
-		intWeight = (int)(255.0f * weight);
-	}
-	void recomputeFloat(){
-		weight = ((float)intWeight)/255.0f;
-	}
-	SkeletalMeshInfluence() = default;
-	SkeletalMeshInfluence(int boneIndex_, float weight_)
-	:boneIndex(boneIndex_), weight(weight_){
-		intWeight = (int)(weight * 255.0f);//truncate
-	}
-};
-
-using SkeletalMeshInfluenceArray = TArray<SkeletalMeshInfluence>;
-using BoneInfluenceMap = TMap<int, SkeletalMeshInfluenceArray>;
-
-float getTotalWeight(const SkeletalMeshInfluenceArray &arr){
-	float result = 0.0f;
-	for(const auto &cur: arr){
-		result += cur.weight;
-	}
-	return result;
-}
-
-int getTotalIntWeight(const SkeletalMeshInfluenceArray &arr){
-	int result = 0;
-	for(const auto &cur: arr){
-		result += cur.intWeight;
-	}
-	return result;
-}
-
-void printBoneInfluenceMap(const BoneInfluenceMap &boneInfluences){
-	for(auto &cur: boneInfluences){
-		UE_LOG(JsonLog, Log, TEXT("Influence for vert %d: %f (%d)"), cur.Key, getTotalWeight(cur.Value), getTotalIntWeight(cur.Value));
-		for(int i = 0; i < cur.Value.Num(); i++){
-			UE_LOG(JsonLog, Log, TEXT("Influence %d/%d: %f (%d)"), i, cur.Value.Num(), cur.Value[i].weight, cur.Value[i].intWeight);
-		}
-	}
-}
-
-void normalizeInfluenceMap(BoneInfluenceMap &boneInfluences){
-	for(auto &cur: boneInfluences){
-		if (cur.Value.Num() == 0)
-			continue;
-
-		for(auto &infl: cur.Value){
-			infl.weight = FMath::Clamp(infl.weight, 0.0f, 1.0f);
-			infl.recomputeInt();
-		}
-
-		float totalFloat = getTotalWeight(cur.Value);
-		if ((totalFloat > 1.0f) && (totalFloat != 0.0f)){
-			float scale = 1.0f/totalFloat;
-			for(auto &infl: cur.Value){
-				infl.weight *= scale;
-				infl.recomputeInt();
-			}
-		}
-
-		int totalInt = getTotalIntWeight(cur.Value);
-		check((totalInt >= 0) && (totalInt <= 255));//This shouldn't fire at this point, but you never know.
-
-		auto extra = 255 - totalInt;
-		if (extra > 0){
-			auto& largest = cur.Value[0];
-			largest.intWeight += extra;
-			largest.recomputeFloat();
-		}
-
-		for(auto &infl: cur.Value){
-			infl.recomputeFloat();
-		}
-	}
-}
-
 void SkeletalMeshBuildData::processPositionsAndWeights(const JsonMesh &jsonMesh, const TMap<int, int> &meshToSkeletonBoneMap, StringArray &remapErrors){
-//void SkeletalMeshBuildData::processVerts(const JsonMesh &jsonMesh, StringArray &remapErrors){
-	const int jsonInfluencesPerVertex = 4;
+	ImportProfileScope profileScope(TEXT("SkeletalMeshBuildData::processPositionsAndWeights"), jsonMesh.name);
+	const int32 numVerts = jsonMesh.vertexCount;
+	profileScope.addElements(numVerts);
 
 	bool hasBones = jsonMesh.boneIndexes.Num() > 0;
 
-	/*
-	//TMap<int, float> summaryWeightMap;
-	//TMap<int, TArray<int>> influenceIndexes;
-
-	//TMap<int, int> summaryIntWeightMap;
-	*/
-
 	//vertices themselves
-	for(int vertIndex = 0; vertIndex < jsonMesh.vertexCount; vertIndex++){
+	meshPoints.SetNumUninitialized(numVerts);
+	pointToOriginalMap.SetNumUninitialized(numVerts);
+	for(int vertIndex = 0; vertIndex < numVerts; vertIndex++){
 		auto srcVert = getIdxVector3(jsonMesh.verts, vertIndex);
-		meshPoints.Add(unityPosToUe(srcVert));
-		pointToOriginalMap.Add(vertIndex);
+		meshPoints[vertIndex] = unityPosToUe(srcVert);
+		pointToOriginalMap[vertIndex] = vertIndex;
 	}
 
 	/*
-	the mapping to uint8 for bone weights is troublesome.
+	Mesh bone indices are remapped through a flat table, unmapped ones are reported once and kept as they are.
 	*/
-	TMap<int, SkeletalMeshInfluenceArray> boneInfluences;
-	if (hasBones){
-		for(int vertIndex = 0; vertIndex < jsonMesh.vertexCount; vertIndex++){
-			for(int inflIndex = 0; inflIndex < jsonInfluencesPerVertex; inflIndex++){
-				auto dataOffset = inflIndex + vertIndex * jsonInfluencesPerVertex;
-				auto meshBoneIdx = jsonMesh.boneIndexes[dataOffset]; 
-				auto boneWeight = jsonMesh.boneWeights[dataOffset];
-				//if (boneWeight < 0.0f)//There actually ARE negative weight somewhere, andd they cause mesh spikes.
-				if (boneWeight <= 0.0f)
-					continue;
-
-				//auto dstInfluenceIndex = meshInfluences.Num();
-				auto skelBoneIdx = meshBoneIdx;
-				auto foundIdx = meshToSkeletonBoneMap.Find(meshBoneIdx);
-				if (!foundIdx){
-					remapErrors.Add(
-						FString::Printf(TEXT("Could not remap mesh bone index %d in vertex influence, errors are possible"),
-							meshBoneIdx));
-				}
-				else{
-					skelBoneIdx = *foundIdx;
-				}
+	TArray<int32> boneRemap;
+	auto remapBone = [&](int32 meshBoneIdx) -> int32{
+		if ((meshBoneIdx >= 0) && (meshBoneIdx < boneRemap.Num()) && (boneRemap[meshBoneIdx] >= 0))
+			return boneRemap[meshBoneIdx];
+		return meshBoneIdx;
+	};
+	{
+		int32 maxBoneIdx = 0;
+		for(const auto &cur: meshToSkeletonBoneMap)
+			maxBoneIdx = FMath::Max(maxBoneIdx, cur.Key);
+		boneRemap.Init(-1, maxBoneIdx + 1);
+		for(const auto &cur: meshToSkeletonBoneMap){
+			if (cur.Key >= 0)
+				boneRemap[cur.Key] = cur.Value;
+		}
+	}
+	auto reportUnmappedBone = [&](int32 meshBoneIdx){
+		if ((meshBoneIdx >= 0) && (meshBoneIdx < boneRemap.Num()) && (boneRemap[meshBoneIdx] >= 0))
+			return;
+		remapErrors.AddUnique(
+			FString::Printf(TEXT("Could not remap mesh bone index %d in vertex influence, errors are possible"),
+				meshBoneIdx));
+	};
 
-				SkeletalMeshInfluence tmpInfluence(skelBoneIdx, boneWeight);
-				boneInfluences.FindOrAdd(vertIndex).Add(tmpInfluence);
+	/*
+	the mapping to uint8 for bone weights is troublesome (see SkeletalMeshInfluenceSlots::normalize).
+	*/
+	SkeletalMeshInfluenceSlots influences;
+	if (hasBones){
+		const int32 jsonInfluencesPerVertex = (numVerts > 0) ? (jsonMesh.boneIndexes.Num() / numVerts): 0;
+		if ((jsonInfluencesPerVertex <= 0) || (jsonMesh.boneWeights.Num() < numVerts * jsonInfluencesPerVertex)){
+			UE_LOG(JsonLog, Warning, TEXT("Mesh %s(%d): %d bone indexes and %d bone weights do not match %d vertices"), 
+				*jsonMesh.name, jsonMesh.id.id, jsonMesh.boneIndexes.Num(), jsonMesh.boneWeights.Num(), numVerts);
+			return;
+		}
+		influences.init(numVerts, jsonInfluencesPerVertex);
+		for(int32 slot = 0; slot < jsonInfluencesPerVertex; slot++){
+			int32 *dstBones = influences.boneIndices.GetData() + slot * numVerts;
+			float *dstWeights = influences.weights.GetData() + slot * numVerts;
+			for(int32 vertIndex = 0; vertIndex < numVerts; vertIndex++){
+				const auto dataOffset = slot + vertIndex * jsonInfluencesPerVertex;
+				//There actually ARE negative weights somewhere, and they cause mesh spikes. Those are dropped by normalize.
+				dstWeights[vertIndex] = jsonMesh.boneWeights[dataOffset];
+				dstBones[vertIndex] = jsonMesh.boneIndexes[dataOffset];
 			}
 		}
+		//Reported once per distinct bone, not per influence
+		int32 maxMeshBoneIdx = 0;
+		for(auto meshBoneIdx: jsonMesh.boneIndexes)
+			maxMeshBoneIdx = FMath::Max(maxMeshBoneIdx, meshBoneIdx);
+		TArray<bool> usedBones;
+		usedBones.Init(false, maxMeshBoneIdx + 1);
+		for(int32 i = 0; i < numVerts * jsonInfluencesPerVertex; i++){
+			if (jsonMesh.boneWeights[i] <= 0.0f)
+				continue;
+			if (jsonMesh.boneIndexes[i] >= 0)
+				usedBones[jsonMesh.boneIndexes[i]] = true;
+			else
+				reportUnmappedBone(jsonMesh.boneIndexes[i]);
+		}
+		for(int32 meshBoneIdx = 0; meshBoneIdx < usedBones.Num(); meshBoneIdx++){
+			if (usedBones[meshBoneIdx])
+				reportUnmappedBone(meshBoneIdx);
+		}
+		parallelRange(influences.boneIndices.Num(), [&](int32 first, int32 last){
+			int32 *bones = influences.boneIndices.GetData();
+			for(int32 i = first; i < last; i++)
+				bones[i] = remapBone(bones[i]);
+		});
 	}
 	else{
 		UE_LOG(JsonLog, Log, TEXT("The mesh \"%s\"(%d) has no bones. Remapping it to the original parent \"%s\""),
 			*jsonMesh.name, (int)jsonMesh.id, *jsonMesh.defaultMeshNodeName);
 		//well. We're remapping it to the single bone the skeleton has. 
 		int origIndex = 0;//yep. Always a bone 0.
-		auto foundIdx = meshToSkeletonBoneMap.Find(origIndex);
-		auto remappedIndex = origIndex;
-		if (!foundIdx){
-			remapErrors.Add(
-				FString::Printf(TEXT("Could not remap mesh bone index %d in vertex influence, errors are possible"),
-					origIndex));
-		}
-		else{
-			remappedIndex = *foundIdx;
+		reportUnmappedBone(origIndex);
+		const int32 remappedIndex = remapBone(origIndex);
+		influences.init(numVerts, 1);
+		for(int vertIndex = 0; vertIndex < numVerts; vertIndex++){
+			influences.boneIndices[vertIndex] = remappedIndex;
+			influences.weights[vertIndex] = 1.0f;
 		}
-		for(int vertIndex = 0; vertIndex < jsonMesh.vertexCount; vertIndex++){
-			SkeletalMeshInfluence tmpInfluence(remappedIndex, 1.0f);
-			boneInfluences.FindOrAdd(vertIndex).Add(tmpInfluence);
-		}
-	}
-
-	/*
-	UE_LOG(JsonLog, Log, TEXT("Pre-sort bone influences on %s(%d)"), *jsonMesh.name, jsonMesh.id);
-	printBoneInfluenceMap(boneInfluences);
-	*/
-
-	//Sorting the influences from strongest to weakest
-	for(auto &cur: boneInfluences){
-		Algo::SortBy(cur.Value, [](const SkeletalMeshInfluence &arg){return -arg.weight;});
-		//cur.Value.Sort(
 	}
 
-	/*
-	UE_LOG(JsonLog, Log, TEXT("Post-sort bone influences on %s(%d)"), *jsonMesh.name, jsonMesh.id);
-	printBoneInfluenceMap(boneInfluences);
-	*/
-
-	normalizeInfluenceMap(boneInfluences);
+	parallelRange(numVerts, [&](int32 first, int32 last){
+		influences.normalize(MAX_TOTAL_INFLUENCES, first, last);
+	});
 
-	/*
-	UE_LOG(JsonLog, Log, TEXT("Post-normalization bone influences on %s(%d)"), *jsonMesh.name, jsonMesh.id);
-	printBoneInfluenceMap(boneInfluences);
-	*/
-
-	for(const auto &cur: boneInfluences){
-		float total = 0.0f;
-		for(const auto &infl: cur.Value){
+	int32 numInfluences = 0;
+	for(auto intWeight: influences.intWeights)
+		numInfluences += (intWeight > 0) ? 1: 0;
+	meshInfluences.Reset(numInfluences);
+	for(int32 vertIndex = 0; vertIndex < numVerts; vertIndex++){
+		for(int32 slot = 0; slot < influences.numSlots; slot++){
+			const int32 slotIndex = slot * numVerts + vertIndex;
+			if (influences.intWeights[slotIndex] == 0)
+				continue;
 			auto &dstInfl = meshInfluences.AddDefaulted_GetRef();
-			dstInfl.VertIndex = cur.Key;
-			dstInfl.BoneIndex = infl.boneIndex;//meshBoneIdx;
-			dstInfl.Weight = infl.weight;// * 2.0f;
-			total += infl.weight;
-
-			if (total >= 256.0f/255.0f){
-				UE_LOG(JsonLog, Log, TEXT("Total overflow: %f on vertex %d"), total, dstInfl.VertIndex);
-			}
-			//dstInfl.Weight = 1.0f;
-			//
-			//break;
+			dstInfl.VertIndex = vertIndex;
+			dstInfl.BoneIndex = influences.boneIndices[slotIndex];
+			dstInfl.Weight = influences.weights[slotIndex];
 		}
 	}
+}
 
-	/*
-	for(auto& cur: boneInfluences){
-		auto &influences = cur.Value;
-		
-		auto totalInt = getTotalIntWeight(influences);
-		auto totalFloat = getTotalWeight(influences);
-		if (totalFloat != 1.0f){
-			UE_LOG(JsonLog, Warning, TEXT("Invalid total bone on vertex %d, mesh %s (%d), value %f"),
-				cur.Key, *jsonMesh.name, jsonMesh.id, totalFloat);
-		}
-		if (totalInt != 255){
-			UE_LOG(JsonLog, Warning, TEXT("Invalid total int bone on vertex %d, mesh %s (%d), value %d"),
-				cur.Key, *jsonMesh.name, jsonMesh.id, totalInt);
-			if (totalInt > 255){
-				UE_LOG(JsonLog, Warning, TEXT("Value is too large and will result in wraparound!"));
-			}
-		}
-	}
-	*/
 
-	/*
-	for(const auto &cur: summaryIntWeightMap){
-		if ((cur.Value > 255) || (cur.Value < 0)){
-			UE_LOG(JsonLog, Warning, TEXT("Invalid total int weight %d on vertex %d, mesh %s (%d)"),
-				cur.Value, cur.Key, *jsonMesh.name, jsonMesh.id)
+/*
+Bounds of vertices skinned to every bone of the reference skeleton, in unity space. Invalid for bones that skin nothing.
+*/
+static void computeBoneRegionBounds(const JsonMesh &jsonMesh, const TMap<int, int> &meshToSkeletonBoneMap, int32 numBones, TArray<FBox> &outBounds){
+	outBounds.Init(FBox(ForceInit), numBones);
+	const int32 numVerts = jsonMesh.verts.Num() / 3;
+	const int32 influencesPerVertex = (numVerts > 0) ? (jsonMesh.boneIndexes.Num() / numVerts): 0;
+	if ((influencesPerVertex <= 0) || (jsonMesh.boneWeights.Num() < numVerts * influencesPerVertex))
+		return;
+	for(int32 vertIndex = 0; vertIndex < numVerts; vertIndex++){
+		const auto pos = getIdxVector3(jsonMesh.verts, vertIndex);
+		for(int32 i = vertIndex * influencesPerVertex; i < (vertIndex + 1) * influencesPerVertex; i++){
+			if (jsonMesh.boneWeights[i] <= 0.0f)
+				continue;
+			const auto found = meshToSkeletonBoneMap.Find(jsonMesh.boneIndexes[i]);
+			if (found && (*found >= 0) && (*found < numBones))
+				outBounds[*found] += pos;
 		}
 	}
+}
 
-	for(int vertIndex = 0; vertIndex < jsonMesh.vertexCount; vertIndex++){
-		if (!summaryWeightMap.Contains(vertIndex)){
-			UE_LOG(JsonLog, Warning, TEXT("Unbound skin vertex %d on mesh %s(%d)"), vertIndex, *jsonMesh.name, jsonMesh.id);
-		}
-	}
-	*/
+/*
+Bone every reference skeleton bone is skinned to at a lod: the bone itself or its nearest kept parent.
 
-	/*
-	for(const auto &cur: summaryWeightMap){
-		auto &curIndexes = cur.Value;
-		for(const auto influeneIndexes: curIndexes){
+Leaf bones whose skinned region, grown by regions of bones already removed below them, is smaller than maxRegionSize 
+are removed bottom up, so whole finger chains go while the hand stays. Bones that skin nothing do not keep their parents, 
+and are removed along with them. The root is always kept. Returns number of removed bones.
+*/
+static int32 computeLodBoneRemap(const FReferenceSkeleton &refSkeleton, const TArray<FBox> &boneBounds, float maxRegionSize, TArray<int32> &outRemap){
+	const int32 numBones = refSkeleton.GetNum();
+	TArray<FBox> regions = boneBounds;
+	TArray<int32> numKeptChildren;
+	TArray<bool> removed;
+	numKeptChildren.SetNumZeroed(numBones);
+	removed.Init(false, numBones);
+
+	//Parents come before children in reference skeleton, so every bone is decided after all of its children
+	for(int32 bone = numBones - 1; bone >= 0; bone--){
+		const auto parent = refSkeleton.GetParentIndex(bone);
+		if (parent < 0)
+			continue;
+		if (numKeptChildren[bone] > 0){
+			numKeptChildren[parent]++;
+			continue;
 		}
-	}
-	*/
-	/*
-	for(const auto &cur: summaryWeightMap){
-		if (cur.Value > 1.0f){
-			UE_LOG(JsonLog, Warning, TEXT("Bone weight value %f is too high on vertex %d, mesh %s (%d)"),
-				cur.Value, cur.Key, *jsonMesh.name, jsonMesh.id)
+		if (!regions[bone].IsValid)
+			continue;
+		if (regions[bone].GetSize().Size() < maxRegionSize){
+			removed[bone] = true;
+			regions[parent] += regions[bone];
 		}
-		if (cur.Value < 1.0f){
-			UE_LOG(JsonLog, Warning, TEXT("Bone weight value %f is too low on vertex %d, mesh %s (%d)"),
-				cur.Value, cur.Key, *jsonMesh.name, jsonMesh.id)
+		else
+			numKeptChildren[parent]++;
+	}
+
+	int32 numRemoved = 0;
+	outRemap.SetNumUninitialized(numBones);
+	for(int32 bone = 0; bone < numBones; bone++){
+		const auto parent = refSkeleton.GetParentIndex(bone);
+		if ((parent >= 0) && (removed[bone] || removed[parent])){
+			removed[bone] = true;
+			outRemap[bone] = outRemap[parent];
+			numRemoved++;
 		}
+		else
+			outRemap[bone] = bone;
 	}
-	*/
+	return numRemoved;
 }
 
-
 void SkeletalMeshBuilder::registerPreviewMesh(USkeleton *skel, USkeletalMesh *mesh, const JsonMesh &jsonMesh){
 	check(skel);
 	check(mesh);
@@ -520,14 +453,18 @@ void SkeletalMeshBuilder::setupSkeletalMesh(USkeletalMesh *skelMesh, const JsonM
 	check(importModel->LODModels.Num() == 0);
 	importModel->LODModels.Empty();
 
+	//Lods past the first one are generated at import time (see JsonImporter::prepareMeshGeometry)
+	const int32 numLods = 1 + jsonMesh.lods.Num();
+	for(int32 lod = 0; lod < numLods; lod++){
 #if (ENGINE_MAJOR_VERSION >= 4) && (ENGINE_MINOR_VERSION >= 22)
-	//It is not directly specified anywhere, but TIndirectArray will properly delete its elements.
-	importModel->LODModels.Add(new FSkeletalMeshLODModel());
+		//It is not directly specified anywhere, but TIndirectArray will properly delete its elements.
+		importModel->LODModels.Add(new FSkeletalMeshLODModel());
 #else
-	new(importModel->LODModels)FSkeletalMeshLODModel();//????
+		new(importModel->LODModels)FSkeletalMeshLODModel();//????
 #endif
-	//I suppose it does same thing as calling new and then Add()
-	auto &lodModel = importModel->LODModels[0];
+		//I suppose it does same thing as calling new and then Add()
+		importModel->LODModels[lod].NumTexCoords = jsonMesh.getNumTexCoords();
+	}
 
 	auto hasNormals = jsonMesh.normals.Num() != 0;
 	//auto hasColors = jsonMesh.colors.Num() != 0;
@@ -539,8 +476,6 @@ void SkeletalMeshBuilder::setupSkeletalMesh(USkeletalMesh *skelMesh, const JsonM
 	skelMesh->bUseFullPrecisionUVs = true;
 	skelMesh->bHasBeenSimplified = false;
 
-	lodModel.NumTexCoords = jsonMesh.getNumTexCoords();//numTexCoords;
-
 	if (materialSetup){
 		materialSetup(skelMesh->Materials);
 	}
@@ -561,7 +496,7 @@ void SkeletalMeshBuilder::setupSkeletalMesh(USkeletalMesh *skelMesh, const JsonM
 	if (jsonMesh.hasBones()){
 		for(int boneIndex = 0; boneIndex < jsonMesh.defaultBoneNames.Num(); boneIndex++){
 			const auto &curName = jsonMesh.defaultBoneNames[boneIndex];
-			const auto skeletonBoneIndex = jsonSkel->findBoneIndex(curName);
+			const auto skeletonBoneIndex = jsonSkel->findRefBoneIndex(curName);
 			if (skeletonBoneIndex < 0){
 				UE_LOG(JsonLog, Warning, TEXT("Bone \"%s\" not found while processing mesh \"%s\""), 
 					*curName, *jsonMesh.name);
@@ -574,7 +509,7 @@ void SkeletalMeshBuilder::setupSkeletalMesh(USkeletalMesh *skelMesh, const JsonM
 		//Falling back to "no bones" mesh...
 		const auto &defaultName = jsonMesh.defaultMeshNodeName;
 		const auto defaultBoneIndex = 0;
-		const auto skeletonBoneIndex = jsonSkel->findBoneIndex(defaultName);
+		const auto skeletonBoneIndex = jsonSkel->findRefBoneIndex(defaultName);
 		meshToSkeletonBoneMap.Add(defaultBoneIndex, skeletonBoneIndex);
 	}
 
@@ -583,13 +518,57 @@ void SkeletalMeshBuilder::setupSkeletalMesh(USkeletalMesh *skelMesh, const JsonM
 
 	TArray<UMorphTarget*> morphTargets;
 
-	SkeletalMeshBuildData buildData;
-
-	buildData.startWithMesh(jsonMesh);
+	//Lod 0 keeps all bones, the rest skin removed bones to their parents
+	TArray<TMap<int, int>> lodBoneMaps;
+	TArray<TArray<int32>> lodRemovedBones;
+	lodBoneMaps.Add(meshToSkeletonBoneMap);
+	lodRemovedBones.AddDefaulted();
+	if (numLods > 1){
+		const float boneSizeFraction = importer->getOptions().lodBoneSizeFraction;
+		TArray<FBox> boneBounds;
+		computeBoneRegionBounds(jsonMesh, meshToSkeletonBoneMap, refSkeleton.GetNum(), boneBounds);
+		FBox meshBounds(ForceInit);
+		for(const auto &cur: boneBounds)
+			meshBounds += cur;
+
+		for(int32 lod = 1; lod < numLods; lod++){
+			lodBoneMaps.Add(meshToSkeletonBoneMap);
+			lodRemovedBones.AddDefaulted();
+			if ((boneSizeFraction <= 0.0f) || !meshBounds.IsValid)
+				continue;
 
-	TArray<FString> remapErrors;
-	buildData.processPositionsAndWeights(jsonMesh, meshToSkeletonBoneMap, remapErrors);
+			TArray<int32> boneRemap;
+			auto numRemoved = computeLodBoneRemap(refSkeleton, boneBounds, meshBounds.GetSize().Size() * boneSizeFraction * lod, boneRemap);
+			for(int32 bone = 0; bone < boneRemap.Num(); bone++){
+				if (boneRemap[bone] != bone)
+					lodRemovedBones[lod].Add(bone);
+			}
+			for(auto &cur: lodBoneMaps[lod]){
+				if ((cur.Value >= 0) && (cur.Value < boneRemap.Num()))
+					cur.Value = boneRemap[cur.Value];
+			}
+			UE_LOG(JsonLog, Log, TEXT("Skeletal mesh %s(%d): lod %d drops %d bones out of %d"), 
+				*jsonMesh.name, jsonMesh.id.toIndex(), lod, numRemoved, refSkeleton.GetNum());
+		}
+	}
 
+	TArray<SkeletalMeshBuildData> lodBuildData;
+	TArray<StringArray> lodRemapErrors;
+	lodBuildData.SetNum(numLods);
+	lodRemapErrors.SetNum(numLods);
+	//Loaded here, on the game thread. Lods are then built on worker threads, one lod per task.
+	IMeshUtilities& meshUtils = FModuleManager::Get().LoadModuleChecked<IMeshUtilities>("MeshUtilities");
+	ParallelFor(numLods, [&](int32 lod){
+		auto &lodData = lodBuildData[lod];
+		lodData.startWithMesh(jsonMesh);
+		lodData.processPositionsAndWeights(jsonMesh, lodBoneMaps[lod], lodRemapErrors[lod]);
+		lodData.processWedgeData(jsonMesh, lod);
+		lodData.buildSkeletalMesh(importModel->LODModels[lod], refSkeleton, jsonMesh, meshUtils);
+	});
+	//Blend shapes and bounds come from lod 0
+	auto &buildData = lodBuildData[0];
+
+	const auto &remapErrors = lodRemapErrors[0];
 	if (remapErrors.Num()){
 		FString combinedMessage = FString::Printf(TEXT("Remap errors found while processing skeletal mesh %d(\"%s\")\n"), jsonMesh.id.toIndex(), *jsonMesh.name);
 		for(const auto& cur: remapErrors){
@@ -597,16 +576,37 @@ void SkeletalMeshBuilder::setupSkeletalMesh(USkeletalMesh *skelMesh, const JsonM
 		}
 	}
 
-	buildData.processWedgeData(jsonMesh);
-
-	buildData.buildSkeletalMesh(lodModel, refSkeleton, jsonMesh);
+	if (numLods > 1){
+		while(skelMesh->GetLODNum() < numLods)
+			skelMesh->AddLODInfo();
+		for(int32 lod = 1; lod < numLods; lod++){
+			auto lodInfo = skelMesh->GetLODInfo(lod);
+			check(lodInfo);
+#if (ENGINE_MAJOR_VERSION >= 4) && (ENGINE_MINOR_VERSION >= 22)
+			lodInfo->ScreenSize.Default = jsonMesh.lods[lod - 1].screenSize;
+#else
+			lodInfo->ScreenSize = jsonMesh.lods[lod - 1].screenSize;
+#endif
+			const auto &removedBones = lodRemovedBones[lod];
+			lodInfo->BonesToRemove.Empty();
+			for(auto bone: removedBones)
+				lodInfo->BonesToRemove.Add(FBoneReference(refSkeleton.GetBoneName(bone)));
+			importModel->LODModels[lod].RequiredBones.RemoveAll([&](FBoneIndexType bone){
+				return removedBones.Contains(bone);
+			});
+		}
+	}
 
 	auto newSkelName = FString::Printf(TEXT("%s_%d"), *jsonSkel->name, jsonSkel->id);
 
 	auto foundSkeleton = importer->getSkeletonObject(jsonSkel->id);
 	if (!foundSkeleton){
 		auto desiredDir = FPaths::GetPath(jsonMesh.path);
-		auto skelName = FString::Printf(TEXT("%s_%s_%d"), *jsonSkel->name, TEXT("skel"), jsonSkel->id);
+		//Merged skeletons are named after the skeleton they were merged into.
+		auto assetSkel = importer->getSkeleton(importer->getMergedSkeletonId(jsonSkel->id));
+		if (!assetSkel)
+			assetSkel = jsonSkel;
+		auto skelName = FString::Printf(TEXT("%s_%s_%d"), *assetSkel->name, TEXT("skel"), assetSkel->id);
 		auto skeleton = createAssetObject<USkeleton>(
 			skelName, &desiredDir, importer, 
 			[&](auto arg){
@@ -618,6 +618,11 @@ void SkeletalMeshBuilder::setupSkeletalMesh(USkeletalMesh *skelMesh, const JsonM
 		skelMesh->Skeleton = skeleton;
 	}
 	else{
+		//Subset skeletons already fit, bones are only added when the mesh brings new ones
+		if (importer->getOptions().mergeSkeletons && !foundSkeleton->MergeAllBonesToBoneTree(skelMesh)){
+			UE_LOG(JsonLog, Warning, TEXT("Could not merge bones of mesh %s(%d) into skeleton %s"),
+				*jsonMesh.name, jsonMesh.id.toIndex(), *foundSkeleton->GetName());
+		}
 		skelMesh->Skeleton = foundSkeleton;
 	}
 
@@ -638,60 +643,96 @@ void SkeletalMeshBuilder::setupSkeletalMesh(USkeletalMesh *skelMesh, const JsonM
 	registerPreviewMesh(skelMesh->Skeleton, skelMesh, jsonMesh);
 
 
-	skelMesh->PostEditChange();
+	{
+		IMPORT_PROFILE_SCOPE_ASSET("USkeletalMesh::PostEditChange", jsonMesh.name);
+		skelMesh->PostEditChange();
+	}
 	skelMesh->MarkPackageDirty();
 	skelMesh->PostLoad();
 }
 
+/*
+Deltas of vertices whose position or normal actually moves in the frame. 
+Morph deltas reference built mesh vertices, not the original ones, hence meshToImportVertexMap.
+*/
+static void extractMorphDeltas(const JsonBlendShapeFrame &blendFrame, const TArray<int32> &meshToImportVertexMap, TArray<FMorphTargetDelta> &outDeltas){
+	const float positionThreshold = THRESH_POINTS_ARE_NEAR;
+	const float normalThreshold = 0.001f;
+	outDeltas.Reset();
+	for(int meshVertIdx = 0; meshVertIdx < meshToImportVertexMap.Num(); meshVertIdx++){
+		auto origVertIdx = meshToImportVertexMap[meshVertIdx];
+		auto posDelta = unityPosToUe(getIdxVector3(blendFrame.deltaVerts, origVertIdx));
+		auto normDelta = unityVecToUe(getIdxVector3(blendFrame.deltaNormals, origVertIdx));
+		if ((posDelta.GetAbsMax() <= positionThreshold) && (normDelta.GetAbsMax() <= normalThreshold))
+			continue;
+
+		auto& dstDelta = outDeltas.AddDefaulted_GetRef();
+		dstDelta.SourceIdx = meshVertIdx;
+		dstDelta.PositionDelta = posDelta;
+		dstDelta.TangentZDelta = normDelta;
+	}
+}
+
 void SkeletalMeshBuildData::processBlendShapes(USkeletalMesh *skelMesh, const JsonMesh &jsonMesh){
+	ImportProfileScope profileScope(TEXT("SkeletalMeshBuildData::processBlendShapes"), jsonMesh.name);
 	bool needMorphInvalidate = false;
 
+	struct FrameRef{
+		int32 blendShapeIndex;
+		int32 frameIndex;
+	};
+	TArray<FrameRef> frames;
 	for(int blendShapeIndex = 0; blendShapeIndex < jsonMesh.blendShapes.Num(); blendShapeIndex++){
-		UE_LOG(JsonLog, Log, TEXT("Processing blend shape %d out of %d"), blendShapeIndex, jsonMesh.blendShapes.Num());
-		const auto &curBlendShape = jsonMesh.blendShapes[blendShapeIndex];
-		for(int blendFrameIndex = 0; blendFrameIndex < curBlendShape.frames.Num(); blendFrameIndex++){
-			auto morphName = FString::Printf(TEXT("%s_%s_s%d_f%d"), 
-				*jsonMesh.name, *curBlendShape.name, blendShapeIndex, blendFrameIndex);
-
-			const auto &blendFrame = curBlendShape.frames[blendFrameIndex];
-
-			auto morphTarget = NewObject<UMorphTarget>(skelMesh->GetOuter(), *morphName);
-			FAssetRegistryModule::AssetCreated(morphTarget);
-			morphTargets.Add(morphTarget);
-
-			TArray<FMorphTargetDelta> deltas;
-
-			auto importData = skelMesh->GetImportedModel();
-			const auto &lodModel = importData->LODModels[0];//TODO:  lod support.
-
-			FString modelData;
-
-			//UE_LOG(JsonLog, Log, TEXT("Dumping model: %s"), *modelData);
-
-			for(int meshVertIdx = 0; meshVertIdx < lodModel.MeshToImportVertexMap.Num(); meshVertIdx++){
-				auto origVertIdx = lodModel.MeshToImportVertexMap[meshVertIdx];
-
-				auto& dstDelta = deltas.AddDefaulted_GetRef();
-				dstDelta.SourceIdx = meshVertIdx;//Aaand nope. That was some stupid error. Mesh morph references the NEW verts, and not the original one...
-				auto unityDeltaPos = getIdxVector3(blendFrame.deltaVerts, origVertIdx);
-				auto unityDeltaNorm = getIdxVector3(blendFrame.deltaNormals, origVertIdx);
-
-				dstDelta.PositionDelta = unityPosToUe(unityDeltaPos);
-				dstDelta.TangentZDelta = unityVecToUe(unityDeltaNorm);
-			}
-			//lodModel.MeshToImportVertexMap
-			//UE_LOG(JsonLog, Log, TEXT("Printing original vertices. Total number: %d"), lodModel.RawPointIndices.Nu
-
-			morphTarget->PopulateDeltas(deltas, 0, lodModel.Sections);
-
-			morphTarget->MarkPackageDirty();
-
-			auto registrationResult = skelMesh->RegisterMorphTarget(morphTarget);
-			needMorphInvalidate = needMorphInvalidate | registrationResult;
-			UE_LOG(JsonLog, Log, TEXT("Registration result: %d. Target %s (%d), frame %d"),
-				(int)registrationResult, *curBlendShape.name, blendShapeIndex, blendFrameIndex);
+		for(int blendFrameIndex = 0; blendFrameIndex < jsonMesh.blendShapes[blendShapeIndex].frames.Num(); blendFrameIndex++)
+			frames.Add(FrameRef{blendShapeIndex, blendFrameIndex});
+	}
+
+	auto importData = skelMesh->GetImportedModel();
+	const auto &lodModel = importData->LODModels[0];//TODO:  lod support.
+
+	//Frames are independent, only object creation and registration below has to happen on the game thread
+	TArray<TArray<FMorphTargetDelta>> frameDeltas;
+	frameDeltas.SetNum(frames.Num());
+	ParallelFor(frames.Num(), [&](int32 index){
+		const auto &frame = frames[index];
+		const auto &blendFrame = jsonMesh.blendShapes[frame.blendShapeIndex].frames[frame.frameIndex];
+		extractMorphDeltas(blendFrame, lodModel.MeshToImportVertexMap, frameDeltas[index]);
+	});
+
+	int32 numDeltas = 0;
+	for(int32 index = 0; index < frames.Num(); index++){
+		const auto &frame = frames[index];
+		const auto &curBlendShape = jsonMesh.blendShapes[frame.blendShapeIndex];
+		auto &deltas = frameDeltas[index];
+		if (!deltas.Num()){
+			UE_LOG(JsonLog, Log, TEXT("Blend shape %s (%d) frame %d does not move any vertices, skipping"),
+				*curBlendShape.name, frame.blendShapeIndex, frame.frameIndex);
+			continue;
 		}
-	}
+		const int32 numFrameDeltas = deltas.Num();
+		numDeltas += numFrameDeltas;
+
+		auto morphName = FString::Printf(TEXT("%s_%s_s%d_f%d"), 
+			*jsonMesh.name, *curBlendShape.name, frame.blendShapeIndex, frame.frameIndex);
+		auto morphTarget = NewObject<UMorphTarget>(skelMesh->GetOuter(), *morphName);
+		FAssetRegistryModule::AssetCreated(morphTarget);
+		morphTargets.Add(morphTarget);
+
+		//Deltas are already thresholded, normals are compared so normal-only deltas are kept
+		morphTarget->PopulateDeltas(deltas, 0, lodModel.Sections, true);
+		deltas.Empty();
+
+		morphTarget->MarkPackageDirty();
+
+		//Render data is rebuilt once for all targets below
+		auto registrationResult = skelMesh->RegisterMorphTarget(morphTarget, false);
+		needMorphInvalidate = needMorphInvalidate | registrationResult;
+		UE_LOG(JsonLog, Log, TEXT("Registration result: %d. Target %s (%d), frame %d, %d deltas"),
+			(int)registrationResult, *curBlendShape.name, frame.blendShapeIndex, frame.frameIndex, numFrameDeltas);
+	}
+	profileScope.addElements(numDeltas);
+	UE_LOG(JsonLog, Log, TEXT("Mesh %s: %d blend shape frames, %d morph deltas out of %d"),
+		*jsonMesh.name, frames.Num(), numDeltas, frames.Num() * lodModel.MeshToImportVertexMap.Num());
 
 	if (needMorphInvalidate){
 		skelMesh->InitMorphTargetsAndRebuildRenderData();
@@ -0,0 +1,172 @@
+#include "JsonImportPrivatePCH.h"
+#include "SkeletalMeshInfluence.h"
+
+float getTotalWeight(const SkeletalMeshInfluenceArray &arr){
+	float result = 0.0f;
+	for(const auto &cur: arr){
+		result += cur.weight;
+	}
+	return result;
+}
+
+int getTotalIntWeight(const SkeletalMeshInfluenceArray &arr){
+	int result = 0;
+	for(const auto &cur: arr){
+		result += cur.intWeight;
+	}
+	return result;
+}
+
+void normalizeInfluences(SkeletalMeshInfluenceArray &influences){
+	if (influences.Num() == 0)
+		return;
+
+	for(auto &infl: influences){
+		infl.weight = FMath::Clamp(infl.weight, 0.0f, 1.0f);
+		infl.recomputeInt();
+	}
+
+	float totalFloat = getTotalWeight(influences);
+	if ((totalFloat > 1.0f) && (totalFloat != 0.0f)){
+		float scale = 1.0f/totalFloat;
+		for(auto &infl: influences){
+			infl.weight *= scale;
+			infl.recomputeInt();
+		}
+	}
+
+	int totalInt = getTotalIntWeight(influences);
+	check((totalInt >= 0) && (totalInt <= 255));//This shouldn't fire at this point, but you never know.
+
+	auto extra = 255 - totalInt;
+	if (extra > 0){
+		auto& largest = influences[0];
+		largest.intWeight += extra;
+		largest.recomputeFloat();
+	}
+
+	for(auto &infl: influences){
+		infl.recomputeFloat();
+	}
+}
+
+void SkeletalMeshInfluenceSlots::init(int32 numVerts_, int32 numSlots_){
+	numVerts = FMath::Max(numVerts_, 0);
+	numSlots = FMath::Max(numSlots_, 0);
+	boneIndices.SetNumZeroed(numVerts * numSlots);
+	weights.SetNumZeroed(numVerts * numSlots);
+	intWeights.SetNumZeroed(numVerts * numSlots);
+}
+
+void SkeletalMeshInfluenceSlots::normalize(int32 maxInfluences, int32 first, int32 last){
+	first = FMath::Max(first, 0);
+	last = FMath::Min(last, numVerts);
+	if ((first >= last) || (numSlots <= 0))
+		return;
+	const int32 count = last - first;
+	const int32 keep = FMath::Clamp(maxInfluences, 1, numSlots);
+	//Offset by first, so the loops below index [0, count)
+	auto slotWeights = [&](int32 slot){
+		return weights.GetData() + slot * numVerts + first;
+	};
+	auto slotBones = [&](int32 slot){
+		return boneIndices.GetData() + slot * numVerts + first;
+	};
+	auto slotInts = [&](int32 slot){
+		return intWeights.GetData() + slot * numVerts + first;
+	};
+
+	//NaN ends up as zero too
+	for(int32 slot = 0; slot < numSlots; slot++){
+		float *w = slotWeights(slot);
+		for(int32 i = 0; i < count; i++)
+			w[i] = (w[i] > 0.0f) ? FMath::Min(w[i], 1.0f): 0.0f;
+	}
+
+	//Weight of a repeated bone goes to its first slot
+	for(int32 slotA = 0; slotA < numSlots; slotA++){
+		float *wa = slotWeights(slotA);
+		const int32 *ba = slotBones(slotA);
+		for(int32 slotB = slotA + 1; slotB < numSlots; slotB++){
+			float *wb = slotWeights(slotB);
+			const int32 *bb = slotBones(slotB);
+			for(int32 i = 0; i < count; i++){
+				const float b = wb[i];
+				const int32 sameMask = -(int32)(ba[i] == bb[i]);
+				const float moved = b * (float)(sameMask & 1);
+				wa[i] += moved;
+				wb[i] = b - moved;
+			}
+		}
+	}
+
+	//Odd-even transposition sort, strongest first. Stable, one compare-exchange of two slots at a time.
+	for(int32 pass = 0; pass < numSlots; pass++){
+		for(int32 slot = pass & 1; (slot + 1) < numSlots; slot += 2){
+			float *wa = slotWeights(slot), *wb = slotWeights(slot + 1);
+			int32 *ba = slotBones(slot), *bb = slotBones(slot + 1);
+			for(int32 i = 0; i < count; i++){
+				const float a = wa[i], b = wb[i];
+				const int32 boneA = ba[i], boneB = bb[i];
+				const int32 swapMask = -(int32)(b > a);
+				const int32 boneDiff = (boneA ^ boneB) & swapMask;
+				wa[i] = FMath::Max(a, b);
+				wb[i] = FMath::Min(a, b);
+				ba[i] = boneA ^ boneDiff;
+				bb[i] = boneB ^ boneDiff;
+			}
+		}
+	}
+
+	TArray<float> scales, running;
+	TArray<int32> prevRounded;
+	scales.SetNumZeroed(count);
+	running.SetNumZeroed(count);
+	prevRounded.SetNumZeroed(count);
+	float *scaleData = scales.GetData();
+	float *runningData = running.GetData();
+	int32 *prevData = prevRounded.GetData();
+
+	for(int32 slot = 0; slot < keep; slot++){
+		const float *w = slotWeights(slot);
+		for(int32 i = 0; i < count; i++)
+			scaleData[i] += w[i];
+	}
+	for(int32 i = 0; i < count; i++){
+		const int32 positiveMask = -(int32)(scaleData[i] > 0.0f);
+		scaleData[i] = (float)(positiveMask & 1) / FMath::Max(scaleData[i], 1e-30f);
+	}
+
+	for(int32 slot = 0; slot < keep; slot++){
+		const float *w = slotWeights(slot);
+		uint8 *dst = slotInts(slot);
+		for(int32 i = 0; i < count; i++){
+			runningData[i] += w[i] * scaleData[i];
+			const int32 rounded = FMath::Min((int32)(runningData[i] * 255.0f + 0.5f), 255);
+			dst[i] = (uint8)(rounded - prevData[i]);
+			prevData[i] = rounded;
+		}
+	}
+	//Float error can leave the running total a unit short, the strongest influence takes it like in normalizeInfluences
+	{
+		uint8 *dst = slotInts(0);
+		for(int32 i = 0; i < count; i++){
+			const int32 positiveMask = -(int32)(scaleData[i] > 0.0f);
+			dst[i] = (uint8)(dst[i] + ((255 - prevData[i]) & positiveMask));
+		}
+	}
+
+	for(int32 slot = 0; slot < numSlots; slot++){
+		float *w = slotWeights(slot);
+		uint8 *ints = slotInts(slot);
+		if (slot >= keep){
+			for(int32 i = 0; i < count; i++){
+				w[i] = 0.0f;
+				ints[i] = 0;
+			}
+			continue;
+		}
+		for(int32 i = 0; i < count; i++)
+			w[i] = (float)ints[i] / 255.0f;
+	}
+}
@@ -2,21 +2,73 @@
 #include "MeshBuilder.h"
 #include "UnrealUtilities.h"
 #include "MeshBuilderUtils.h"
+#include "ImportProfiler.h"
 
 #include "Editor/UnrealEd/Private/GeomFitUtils.h"
 #include "Classes/PhysicsEngine/BodySetup.h"
+#include "StaticMeshResources.h"
+#include "Async/ParallelFor.h"
+#include "Interfaces/ITargetPlatform.h"
+#include "Interfaces/ITargetPlatformManagerModule.h"
 
-void MeshBuilder::setupStaticMesh(UStaticMesh *mesh, const JsonMesh &jsonMesh, std::function<void(TArray<FStaticMaterial> &meshMaterial)> materialSetup){
+void MeshBuilder::fillStaticRawMesh(FRawMesh &newRawMesh, const JsonMesh &jsonMesh, const MeshBuilderUtils::ConvertedVertexStreams &streams, int32 lod){
+	using namespace UnrealUtilities;
+	using namespace MeshBuilderUtils;
+
+	IMPORT_PROFILE_SCOPE_ASSET("MeshBuilder::fillStaticRawMesh", jsonMesh.name);
+
+	newRawMesh.VertexPositions = streams.positions;
+	UE_LOG(JsonLog, Log, TEXT("Num verts: %d"), newRawMesh.VertexPositions.Num());
+
+	UE_LOG(JsonLog, Log, TEXT("Sub meshes: %d"), jsonMesh.subMeshes.Num());
+	if (jsonMesh.subMeshes.Num() == 0){
+		UE_LOG(JsonLog, Warning, TEXT("No Submeshes found!"));
+	}
+
+	IntArray wedgeVerts;
+	buildWedgeVertices(jsonMesh, lod, wedgeVerts, newRawMesh.FaceMaterialIndices);
+	newRawMesh.FaceSmoothingMasks.SetNumZeroed(newRawMesh.FaceMaterialIndices.Num());
+	newRawMesh.WedgeIndices.Reset(wedgeVerts.Num());
+	newRawMesh.WedgeIndices.Append(wedgeVerts);
+
+	gatherWedges(newRawMesh.WedgeTangentZ, streams.normals, wedgeVerts);
+	gatherWedges(newRawMesh.WedgeTangentX, streams.tangentsX, wedgeVerts);
+	gatherWedges(newRawMesh.WedgeTangentY, streams.tangentsY, wedgeVerts);
+	gatherWedges(newRawMesh.WedgeColors, streams.colors, wedgeVerts);
+	for(int32 i = 0; i < MAX_MESH_TEXTURE_COORDS; i++){
+		if (i < maxVertexUvs)
+			gatherWedges(newRawMesh.WedgeTexCoords[i], streams.uvs[i], wedgeVerts);
+		else
+			newRawMesh.WedgeTexCoords[i].Reset();
+	}
+
+	UE_LOG(JsonLog, Log, TEXT("New wedge indices %d"), newRawMesh.WedgeIndices.Num());
+	UE_LOG(JsonLog, Log, TEXT("Face mat indices: %d"), newRawMesh.FaceMaterialIndices.Num());
+}
+
+PendingStaticMeshBuild::PendingStaticMeshBuild(UStaticMesh *mesh_, const JsonMesh &jsonMesh)
+:mesh(mesh_), id(jsonMesh.id), name(jsonMesh.name), convexCollider(jsonMesh.convexCollider), triangleCollider(jsonMesh.triangleCollider),
+simpleCollision(jsonMesh.simpleCollision), convexHulls(jsonMesh.convexHulls){
+}
+
+void MeshBuilder::setupStaticMesh(UStaticMesh *mesh, const JsonMesh &jsonMesh, std::function<void(TArray<FStaticMaterial> &meshMaterial)> materialSetup,
+		TArray<PendingStaticMeshBuild> *deferredBuilds){
 	using namespace UnrealUtilities;
 	using namespace MeshBuilderUtils;
 
 	check(mesh);
+	ImportProfileScope profileScope(TEXT("MeshBuilder::setupStaticMesh"), jsonMesh.name);
+	profileScope.addElements(jsonMesh.verts.Num() / 3);
 	UE_LOG(JsonLog, Log, TEXT("Static mesh num lods: %d"), mesh->SourceModels.Num());
 
-	if (mesh->SourceModels.Num() < 1){
-		UE_LOG(JsonLog, Warning, TEXT("Adding static mesh lod!"));
+	const int32 numLods = 1 + jsonMesh.lods.Num();
+	while(mesh->SourceModels.Num() < numLods){
 		new(mesh->SourceModels) FStaticMeshSourceModel();//???
 	}
+	if (mesh->SourceModels.Num() > numLods){
+		UE_LOG(JsonLog, Log, TEXT("Removing %d stale static mesh lods"), mesh->SourceModels.Num() - numLods);
+		mesh->SourceModels.SetNum(numLods);
+	}
 	 
 	int32 lod = 0;
 
@@ -26,136 +78,25 @@ void MeshBuilder::setupStaticMesh(UStaticMesh *mesh, const JsonMesh &jsonMesh, s
 	srcModel.StaticMeshOwner = mesh;
 #endif
 
-	mesh->LightingGuid = FGuid::NewGuid();
-	mesh->LightMapResolution = 64;
+	//Resolution comes from surface area when lightmaps are set up at import time (see JsonImporter::prepareMeshGeometry)
+	mesh->LightMapResolution = (jsonMesh.lightmapResolution > 0) ? jsonMesh.lightmapResolution: 64;
 	mesh->LightMapCoordinateIndex = 1;
 
+	if (jsonMesh.uv0.Num() == 0){
+		UE_LOG(JsonLog, Warning, TEXT("No default uvs found on mesh %s(%d). Placeholder coordinates will be used."), *jsonMesh.name, jsonMesh.id.id);
+	}
+	//Converted once and shared by all lods
+	ConvertedVertexStreams vertexStreams;
+	convertVertexStreams(jsonMesh, vertexStreams, true);
+	UE_LOG(JsonLog, Log, TEXT("has normals: %d; hasColors: %d; hasTangents: %d"), 
+		(int)vertexStreams.hasNormals(), (int)vertexStreams.hasColors(), (int)vertexStreams.hasTangents());
+
 	FRawMesh newRawMesh;
 	srcModel.RawMeshBulkData->LoadRawMesh(newRawMesh);
-	newRawMesh.VertexPositions.SetNum(0);
+	fillStaticRawMesh(newRawMesh, jsonMesh, vertexStreams, lod);
 
-	UE_LOG(JsonLog, Log, TEXT("Num normal floats: %d"), jsonMesh.verts.Num());
 	bool hasNormals = jsonMesh.normals.Num() != 0;
-	UE_LOG(JsonLog, Log, TEXT("has normals: %d"), (int)hasNormals);
-	bool hasColors = jsonMesh.colors.Num() > 0;
 	bool hasTangents = jsonMesh.tangents.Num() != 0;
-	UE_LOG(JsonLog, Log, TEXT("hasColors: %d; hasTangents: %d"), (int)hasColors, (int)hasNormals);
-
-	{//why?
-		UE_LOG(JsonLog, Log, TEXT("Generating mesh"));
-		UE_LOG(JsonLog, Log, TEXT("Num vert floats: %d"), jsonMesh.verts.Num());//vertFloats.Num());
-		for(int i = 0; (i + 2) < jsonMesh.verts.Num(); i += 3){
-			FVector unityPos(jsonMesh.verts[i], jsonMesh.verts[i+1], jsonMesh.verts[i+2]);
-			newRawMesh.VertexPositions.Add(unityPosToUe(unityPos));
-		}
-		UE_LOG(JsonLog, Log, TEXT("Num verts: %d"), newRawMesh.VertexPositions.Num());
-
-		//const auto &normalFloats = jsonMesh.normals;
-
-		const int32 maxUvs = 8;
-		const TArray<float>* uvFloats[maxUvs] = {
-			&jsonMesh.uv0, &jsonMesh.uv1, &jsonMesh.uv2, &jsonMesh.uv3, 
-			&jsonMesh.uv4, &jsonMesh.uv5, &jsonMesh.uv6, &jsonMesh.uv7
-		};
-
-		bool hasUvs[maxUvs];
-		for(int32 i = 0; i < maxUvs; i++){
-			hasUvs[i] = uvFloats[i]->Num() != 0;
-			UE_LOG(JsonLog, Log, TEXT("Uv floats[%d]: %d, hasUvs: %d"), i, uvFloats[i]->Num(), (int)hasUvs[i]);
-		}
-
-		if (!hasUvs[0]){
-			UE_LOG(JsonLog, Warning, TEXT("No default uvs found on mesh %s(%d). Placeholder coordinates will be used."), *jsonMesh.name, jsonMesh.id.id);
-		}
-
-		//submesh generation
-		newRawMesh.WedgeIndices.SetNum(0);
-
-		for(int i = 0; i < MAX_MESH_TEXTURE_COORDS; i++)
-			newRawMesh.WedgeTexCoords[i].SetNum(0);
-
-		newRawMesh.WedgeColors.SetNum(0);
-		newRawMesh.WedgeTangentX.SetNum(0);
-		newRawMesh.WedgeTangentY.SetNum(0);
-		newRawMesh.WedgeTangentZ.SetNum(0);
-
-		UE_LOG(JsonLog, Log, TEXT("Sub meshes: %d"), jsonMesh.subMeshes.Num());
-		if (jsonMesh.subMeshes.Num() > 0){
-			UE_LOG(JsonLog, Log, TEXT("Processing submeshes"));
-			int32 nextMatIndex = 0;
-
-			for(int subMeshIndex = 0; subMeshIndex < jsonMesh.subMeshes.Num(); subMeshIndex++){
-				const auto& curSubMesh = jsonMesh.subMeshes[subMeshIndex];
-
-				const auto& trigs = curSubMesh.triangles;
-				UE_LOG(JsonLog, Log, TEXT("Num triangle verts %d"), trigs.Num());
-
-				auto processTriangleIndex = [&](int32 trigVertIdx){
-					auto origIndex = trigs[trigVertIdx];
-					newRawMesh.WedgeIndices.Add(origIndex);
-
-					processTangent(origIndex, jsonMesh.normals, jsonMesh.tangents, hasNormals, hasTangents, 
-						[&](const auto& norm){
-							newRawMesh.WedgeTangentZ.Add(norm);
-						},
-						[&](const auto &tanU, const auto &tanV){
-							newRawMesh.WedgeTangentX.Add(tanU);
-							newRawMesh.WedgeTangentY.Add(tanV);
-						}
-					);
-
-					for(int32 uvIndex = 0; uvIndex < maxUvs; uvIndex++){
-						if (!hasUvs[uvIndex]){
-							if (uvIndex != 0)
-								continue;
-							auto tmpPos = getIdxVector3(jsonMesh.verts, origIndex);
-							FVector2D tmpUv(tmpPos.X, tmpPos.Y);
-							newRawMesh.WedgeTexCoords[uvIndex].Add(tmpUv);
-							continue;
-						}
-
-						auto tmpUv = getIdxVector2(*uvFloats[uvIndex], origIndex);
-						tmpUv.Y = 1.0f - tmpUv.Y;
-						newRawMesh.WedgeTexCoords[uvIndex].Add(tmpUv);
-					}
-
-					if (hasColors){
-						FColor col32(
-							jsonMesh.colors[origIndex * 4], 
-							jsonMesh.colors[origIndex * 4 + 1], 
-							jsonMesh.colors[origIndex * 4 + 2], 
-							jsonMesh.colors[origIndex * 4 + 3]
-						);
-
-						//srgb conversion, though?
-						newRawMesh.WedgeColors.Add(
-							col32
-						);
-					}
-
-					if ((trigVertIdx % 3) == 0){
-						newRawMesh.FaceMaterialIndices.Add(subMeshIndex);
-						newRawMesh.FaceSmoothingMasks.Add(0);
-					}
-				};
-
-				for(int32 trigVertIndex = 0; (trigVertIndex + 2) < trigs.Num(); trigVertIndex += 3){
-					processTriangleIndex(trigVertIndex);
-					processTriangleIndex(trigVertIndex + 2);
-					processTriangleIndex(trigVertIndex + 1);
-				}
-
-				UE_LOG(JsonLog, Log, TEXT("New wedge indices %d"), newRawMesh.WedgeIndices.Num());
-				UE_LOG(JsonLog, Log, TEXT("Face mat indices: %d"), newRawMesh.FaceMaterialIndices.Num());
-				for(int32 i = 0; i < MAX_MESH_TEXTURE_COORDS; i++){
-					UE_LOG(JsonLog, Log, TEXT("Uv[%d] size: %d"), i, newRawMesh.WedgeTexCoords[i].Num());
-				}
-			}
-		}
-		else{
-			UE_LOG(JsonLog, Warning, TEXT("No Submeshes found!"));
-		}
-	}
 
 	bool valid = newRawMesh.IsValid();
 	bool fixable = newRawMesh.IsValidOrFixable();
@@ -176,56 +117,227 @@ void MeshBuilder::setupStaticMesh(UStaticMesh *mesh, const JsonMesh &jsonMesh, s
 	srcModel.BuildSettings.bRecomputeNormals = false;//!hasNormals; //Why??
 	srcModel.BuildSettings.bRecomputeTangents = !(hasTangents && hasNormals);//true;
 
-	TArray<FText> buildErrors;
-	mesh->Build(false, &buildErrors);
+	const bool hasLightmapUvs = jsonMesh.uv1.Num() != 0;
+	if (!hasLightmapUvs){
+		UE_LOG(JsonLog, Warning, TEXT("No lightmap uvs found on mesh %s(%d). They will be generated by the engine."), *jsonMesh.name, jsonMesh.id.id);
+		srcModel.BuildSettings.bGenerateLightmapUVs = true;
+		srcModel.BuildSettings.SrcLightmapIndex = 0;
+		srcModel.BuildSettings.DstLightmapIndex = 1;
+	}
+	else if (jsonMesh.lightmapResolution > 0){
+		//uv1 was packed for this resolution at import time, regenerating it would only slow the build down
+		srcModel.BuildSettings.bGenerateLightmapUVs = false;
+	}
+	if (jsonMesh.lightmapResolution > 0)
+		srcModel.BuildSettings.MinLightmapResolution = jsonMesh.lightmapResolution;
+
+	for(int32 lodIndex = 1; lodIndex < numLods; lodIndex++){
+		auto &lodModel = mesh->SourceModels[lodIndex];
+#if (ENGINE_MAJOR_VERSION >= 4) && (ENGINE_MINOR_VERSION >= 22)
+		lodModel.StaticMeshOwner = mesh;
+#endif
+		FRawMesh lodRawMesh;
+		fillStaticRawMesh(lodRawMesh, jsonMesh, vertexStreams, lodIndex);
+		lodModel.RawMeshBulkData->SaveRawMesh(lodRawMesh);
+		lodModel.BuildSettings = srcModel.BuildSettings;
+		lodModel.ScreenSize.Default = jsonMesh.lods[lodIndex - 1].screenSize;
+	}
+	assignContentGuids(mesh);
+
+	//Generated lods come with their own screen sizes
+	mesh->bAutoComputeLODScreenSize = (numLods < 2);
+	if (numLods > 1)
+		srcModel.ScreenSize.Default = 1.0f;
+
+#if (ENGINE_MAJOR_VERSION >= 4) && (ENGINE_MINOR_VERSION >= 22)
+	srcModel.StaticMeshOwner = mesh;
+#endif
+
+	PendingStaticMeshBuild pendingBuild(mesh, jsonMesh);
+	if (deferredBuilds){
+		deferredBuilds->Add(pendingBuild);
+		return;
+	}
+	buildStaticMeshes({pendingBuild});
+}
+
+void MeshBuilder::buildStaticMeshes(const TArray<PendingStaticMeshBuild> &builds){
+	if (builds.Num() == 0)
+		return;
+	ImportProfileScope profileScope(TEXT("MeshBuilder::buildStaticMeshes"));
+	profileScope.addElements(builds.Num());
+
+	if (builds.Num() == 1){
+		const auto &build = builds[0];
+		TArray<FText> buildErrors;
+		{
+			IMPORT_PROFILE_SCOPE_ASSET("UStaticMesh::Build", build.name);
+			build.mesh->Build(false, &buildErrors);
+		}
+		setupStaticMeshCollision(build, buildErrors);
+		return;
+	}
+
+	UE_LOG(JsonLog, Log, TEXT("Building %d static meshes"), builds.Num());
+#if (ENGINE_MAJOR_VERSION >= 4) && (ENGINE_MINOR_VERSION >= 25)
+	{
+		IMPORT_PROFILE_SCOPE("UStaticMesh::BatchBuild");
+		TArray<UStaticMesh*> meshes;
+		for(const auto &build: builds)
+			meshes.Add(build.mesh);
+		UStaticMesh::BatchBuild(meshes, true);
+	}
+	for(const auto &build: builds){
+		TArray<FText> buildErrors;
+		if (!build.mesh->RenderData.IsValid() || (build.mesh->RenderData->LODResources.Num() == 0))
+			buildErrors.Add(FText::FromString(TEXT("No render data was built")));
+		setupStaticMeshCollision(build, buildErrors);
+	}
+#else
+	/*
+	No batch build on this engine version. Render data is computed on worker threads into throwaway objects,
+	which stores it in the derived data cache, then meshes are built one by one on the game thread and pick up the cached data.
+	*/
+	{
+		IMPORT_PROFILE_SCOPE("cacheStaticMeshDerivedData");
+		/*
+		Cache loads mesh processing modules and mesh descriptions on demand, neither of which may happen on worker threads.
+		Both are done here, on the game thread, so the tasks below only read them.
+		*/
+		const TCHAR* buildModules[] = {TEXT("MeshUtilities"), TEXT("MeshReductionInterface"), TEXT("MeshBuilder")};
+		for(auto moduleName: buildModules){
+			if (!FModuleManager::Get().LoadModule(moduleName))
+				UE_LOG(JsonLog, Warning, TEXT("Could not load module %s before building static meshes"), moduleName);
+		}
+#if (ENGINE_MAJOR_VERSION >= 4) && (ENGINE_MINOR_VERSION >= 22)
+		for(const auto &build: builds){
+			for(int32 lod = 0; lod < build.mesh->SourceModels.Num(); lod++)
+				build.mesh->GetMeshDescription(lod);
+		}
+#endif
+		const auto &lodSettings = GetTargetPlatformManagerRef().GetRunningTargetPlatform()->GetStaticMeshLODSettings();
+		ParallelFor(builds.Num(), [&](int32 index){
+			IMPORT_PROFILE_SCOPE_ASSET("FStaticMeshRenderData::Cache", builds[index].name);
+			FStaticMeshRenderData renderData;
+			renderData.Cache(builds[index].mesh, lodSettings);
+		});
+	}
+	for(const auto &build: builds){
+		TArray<FText> buildErrors;
+		{
+			IMPORT_PROFILE_SCOPE_ASSET("UStaticMesh::Build", build.name);
+			build.mesh->Build(true, &buildErrors);
+		}
+		setupStaticMeshCollision(build, buildErrors);
+	}
+#endif
+}
+
+void MeshBuilder::setupStaticMeshCollision(const PendingStaticMeshBuild &build, const TArray<FText> &buildErrors){
+	auto *mesh = build.mesh;
 	if (buildErrors.Num() > 0){
 		FString errMsg;
-		for (FText& err : buildErrors){
+		for (const FText& err : buildErrors){
 			errMsg += FString::Printf(TEXT("MeshBuildError: %s"), *(err.ToString()));
-			//UE_LOG(JsonLog, Error, TEXT("MeshBuildError: %s"), *(err.ToString()));
 		}
-		UE_LOG(JsonLog, Warning, TEXT("Build errors while loading mesh %d(\"%s\"):\n%s"), (int)jsonMesh.id, *jsonMesh.name, *errMsg);
+		UE_LOG(JsonLog, Warning, TEXT("Build errors while loading mesh %d(\"%s\"):\n%s"), (int)build.id, *build.name, *errMsg);
+		return;
 	}
-	else{
-		TArray<FVector> verts(KDopDir18, 18);
-		GenerateKDopAsSimpleCollision(mesh, verts);
 
-		UBodySetup* bodySetup = mesh->BodySetup;
-		if (!bodySetup || (bodySetup && (bodySetup->AggGeom.GetElementCount() == 0))){
-			UE_LOG(JsonLog, Warning, TEXT("Could not generate convex collision for mesh %d(\"%s\"):\nRebuilding as a box."), (int)jsonMesh.id, *jsonMesh.name);
+	auto simpleCollision = build.simpleCollision;
+	if ((simpleCollision == MeshSimpleCollision::ConvexHulls) && !addConvexHulls(mesh, build.convexHulls)){
+		UE_LOG(JsonLog, Warning, TEXT("No convex hulls were generated for mesh %d(\"%s\"), using 18-DOP"), (int)build.id, *build.name);
+		simpleCollision = MeshSimpleCollision::KDop18;
+	}
+
+	switch(simpleCollision){
+		case MeshSimpleCollision::KDop18:{
+			TArray<FVector> verts(KDopDir18, 18);
+			IMPORT_PROFILE_SCOPE_ASSET("GenerateKDopAsSimpleCollision", build.name);
+			GenerateKDopAsSimpleCollision(mesh, verts);
+			break;
+		}
+		case MeshSimpleCollision::Box:
 			GenerateBoxAsSimpleCollision(mesh);
+			break;
+		case MeshSimpleCollision::Sphere:
+			GenerateSphereAsSimpleCollision(mesh);
+			break;
+		case MeshSimpleCollision::None:
+		case MeshSimpleCollision::Complex:
+		{
+			mesh->CreateBodySetup();
+			if (mesh->BodySetup)
+				mesh->BodySetup->RemoveSimpleCollision();
+			break;
 		}
+		default:
+			break;
+	}
+
+	UBodySetup* bodySetup = mesh->BodySetup;
+	const bool needsSimpleShapes = (simpleCollision != MeshSimpleCollision::None) && (simpleCollision != MeshSimpleCollision::Complex);
+	if (needsSimpleShapes && (!bodySetup || (bodySetup && (bodySetup->AggGeom.GetElementCount() == 0)))){
+		UE_LOG(JsonLog, Warning, TEXT("Could not generate convex collision for mesh %d(\"%s\"):\nRebuilding as a box."), (int)build.id, *build.name);
+		GenerateBoxAsSimpleCollision(mesh);
+	}
 
-		if (bodySetup){
-			/*
-			This is used by imported mesh colliders. 
-			Unity engine allows toggling of collision mesh being/not being convex on the fly, and does not 
-			generate simple collision by default.
+	if (bodySetup){
+		/*
+		This is used by imported mesh colliders. 
+		Unity engine allows toggling of collision mesh being/not being convex on the fly, and does not 
+		generate simple collision by default.
 
-			SO if either "convex" or "triangle" flags are set, the importer will adjust collision strategy to mimic unity's.
+		SO if either "convex" or "triangle" flags are set, the importer will adjust collision strategy to mimic unity's.
 
-			Convex will use KDop approach and make the mesh use "simple as complex", while triangular will use 
-			triangular geometry AND mark mesh as "use complex as simple".
+		Convex will use KDop approach (convex hulls with a collision policy) and make the mesh use "simple as complex", while triangular will use 
+		triangular geometry AND mark mesh as "use complex as simple".
 
-			If neither is set, it will use default strategy.
+		If neither is set, it will use default strategy.
 
-			...
+		...
 
-			I wish there was a separation between mesh and collider, though.
-			*/
-			if (jsonMesh.convexCollider){
-				bodySetup->CollisionTraceFlag = CTF_UseSimpleAsComplex;
-			}
-			else if (jsonMesh.triangleCollider){
-				bodySetup->CollisionTraceFlag = CTF_UseComplexAsSimple;
-			}
+		I wish there was a separation between mesh and collider, though.
+		*/
+		if (build.convexCollider){
+			bodySetup->CollisionTraceFlag = CTF_UseSimpleAsComplex;
+		}
+		else if (build.triangleCollider || (simpleCollision == MeshSimpleCollision::Complex)){
+			bodySetup->CollisionTraceFlag = CTF_UseComplexAsSimple;
 		}
-		if (!bodySetup && (jsonMesh.convexCollider || jsonMesh.triangleCollider)){
-			UE_LOG(JsonLog, Warning, TEXT("Could not setup collision flags for mesh %d(\"%s\") - body setup not generated"), (int)jsonMesh.id, *jsonMesh.name);
+		else if (simpleCollision == MeshSimpleCollision::None){
+			//No simple shapes and no complex geometry, so nothing is cooked for this mesh
+			bodySetup->CollisionTraceFlag = CTF_UseSimpleAsComplex;
 		}
 	}
+	if (!bodySetup && (build.convexCollider || build.triangleCollider)){
+		UE_LOG(JsonLog, Warning, TEXT("Could not setup collision flags for mesh %d(\"%s\") - body setup not generated"), (int)build.id, *build.name);
+	}
+}
 
-#if (ENGINE_MAJOR_VERSION >= 4) && (ENGINE_MINOR_VERSION >= 22)
-	srcModel.StaticMeshOwner = mesh;
-#endif
+bool MeshBuilder::addConvexHulls(UStaticMesh *mesh, const TArray<FloatArray> &hulls){
+	using namespace UnrealUtilities;
+	check(mesh);
+	mesh->CreateBodySetup();
+	auto *bodySetup = mesh->BodySetup;
+	if (!bodySetup)
+		return false;
+
+	bodySetup->RemoveSimpleCollision();
+	for(const auto &hull: hulls){
+		if (hull.Num() < 12)//degenerate, less than 4 points
+			continue;
+		FKConvexElem convexElem;
+		for(int32 i = 0; (i + 2) < hull.Num(); i += 3)
+			convexElem.VertexData.Add(unityPosToUe(FVector(hull[i], hull[i + 1], hull[i + 2])));
+		convexElem.UpdateElemBox();
+		bodySetup->AggGeom.ConvexElems.Add(convexElem);
+	}
+	if (bodySetup->AggGeom.ConvexElems.Num() == 0)
+		return false;
+
+	bodySetup->InvalidatePhysicsData();
+	bodySetup->CreatePhysicsMeshes();
+	mesh->bCustomizedCollision = true;
+	return true;
 }
@@ -1,11 +1,67 @@
 #pragma once
 #include "JsonTypes.h"
-#include <functional>
+#include "Templates/Function.h"
+
+class JsonMesh;
 
 namespace MeshBuilderUtils{
-	void processTangent(int originalIndex, const FloatArray &normFloats, const FloatArray &tangentFloats, bool hasNormals, bool hasTangents,
-		std::function<void(const FVector&)> normCallback, //Receives normal
-		std::function<void(const FVector&, const FVector&)> tanCallback //Receives U and V tangents. U, V. In this order.
-	);
-}
+	const int32 maxVertexUvs = 8;
+
+	/*
+	Vertex streams of a json mesh converted to unreal coordinate conventions, one element per vertex.
+	Streams missing in the source mesh are left empty.
+	*/
+	class ConvertedVertexStreams{
+	public:
+		int32 numVerts = 0;
+		TArray<FVector> positions;
+		TArray<FVector> normals;
+		//Tangents are present only when normals are present.
+		TArray<FVector> tangentsX;
+		TArray<FVector> tangentsY;
+		TArray<FColor> colors;
+		TArray<FVector2D> uvs[maxVertexUvs];
+
+		bool hasNormals() const{
+			return normals.Num() != 0;
+		}
+		bool hasTangents() const{
+			return tangentsX.Num() != 0;
+		}
+		bool hasColors() const{
+			return colors.Num() != 0;
+		}
+	};
 
+	/*
+	Converts every vertex stream of the mesh in one pass.
+	When placeholderUv0 is set and the mesh has no uv0, unity x/y positions are used as uv0.
+	Large meshes are converted on multiple threads.
+	*/
+	void convertVertexStreams(const JsonMesh &jsonMesh, ConvertedVertexStreams &outStreams, bool placeholderUv0);
+
+	/*
+	Builds per-wedge vertex indices for all submeshes of the given lod, with winding flipped for unreal,
+	and material index of every face.
+	*/
+	void buildWedgeVertices(const JsonMesh &jsonMesh, int32 lod, IntArray &outWedgeVerts, IntArray &outFaceMaterials);
+
+	//Calls body(first, last) over consecutive chunks of [0, num). Chunks run in parallel when there's more than one.
+	void parallelRange(int32 num, TFunctionRef<void(int32 first, int32 last)> body);
+
+	//dst[i] = src[wedgeVerts[i]]. dst is left empty when src is.
+	template<typename T> void gatherWedges(TArray<T> &dst, const TArray<T> &src, const IntArray &wedgeVerts){
+		if (!src.Num()){
+			dst.Reset();
+			return;
+		}
+		dst.SetNumUninitialized(wedgeVerts.Num());
+		const T* srcData = src.GetData();
+		const int32* idxData = wedgeVerts.GetData();
+		T* dstData = dst.GetData();
+		parallelRange(wedgeVerts.Num(), [&](int32 first, int32 last){
+			for(int32 i = first; i < last; i++)
+				dstData[i] = srcData[idxData[i]];
+		});
+	}
+}
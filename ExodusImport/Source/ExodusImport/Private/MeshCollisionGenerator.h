@@ -0,0 +1,38 @@
+#pragma once
+#include "CoreMinimal.h"
+
+/*
+Simple collision shapes computed straight from mesh geometry.
+Positions are xyz triplets, results are in the same space as the input.
+*/
+class MeshCollisionGenerator{
+public:
+	//xyz triplets
+	using PointArray = TArray<float>;
+	using HullArray = TArray<PointArray>;
+
+	/*
+	Approximate convex decomposition. Triangles are split into at most maxHulls spatially coherent clusters
+	by recursive median bisection along the longest axis. The cluster with the largest concavity (deepest vertex 
+	below its hull) is split first, and splitting stops once no cluster is deeper than maxConcavity times 
+	the mesh bounds diagonal. Clusters with less than minHullTriangles triangles are not split.
+
+	Every hull is returned as the corners of the cluster's 26-DOP (slabs along axes, edge and corner diagonals),
+	so it contains all cluster vertices and stays well under physics engine point limits.
+	outTriangleHulls, when given, receives the index of the hull built from every triangle.
+	*/
+	static void decomposeConvex(const TArray<float> &positions, const TArray<int32> &indices,
+		int32 maxHulls, int32 minHullTriangles, float maxConcavity, HullArray &outHulls, TArray<int32> *outTriangleHulls = nullptr);
+
+	/*
+	Enclosed volume relative to the volume of the bounds, 1 for boxes. Flat meshes use
+	their area relative to the largest bounds face instead. Expects closed, consistently wound meshes.
+	*/
+	static float getBoundsFillRatio(const TArray<float> &positions, const TArray<int32> &indices);
+
+	/*
+	Spread of vertex distances from the bounds center, relative to the largest distance.
+	Close to zero for sphere-like meshes.
+	*/
+	static float getRadiusDeviation(const TArray<float> &positions);
+};
@@ -0,0 +1,77 @@
+#pragma once
+#include "CoreMinimal.h"
+
+/*
+Index and vertex order optimizations for GPU rendering.
+
+Intended order is: weld identical vertices, optimize each index range for the post-transform cache, 
+optionally sort cache-friendly triangle clusters to reduce overdraw, then reorder vertices for fetch locality.
+*/
+class MeshRenderOptimizer{
+public:
+	/*
+	One per-vertex attribute stream, stride is in bytes.
+	*/
+	struct VertexStream{
+		const uint8 *data = nullptr;
+		int32 stride = 0;
+	};
+
+	/*
+	Maps vertices with bitwise identical data in all streams to one vertex. Unique vertices keep their relative order.
+	Returns number of unique vertices.
+	*/
+	static int32 buildWeldRemap(int32 numVerts, const TArray<VertexStream> &streams, TArray<int32> &outRemap);
+	/*
+	Maps vertices to the order of first use by indices, unused vertices go last. Returns number of vertices.
+	*/
+	static int32 buildFetchRemap(const TArray<int32> &indices, int32 numVerts, TArray<int32> &outRemap);
+
+	static void remapIndices(TArray<int32> &indices, const TArray<int32> &remap);
+	/*
+	Vertices mapped to the same new index must hold identical data, the last one is kept.
+	*/
+	template<typename T> static void remapVertexStream(TArray<T> &stream, int32 numVerts, const TArray<int32> &remap, int32 newNumVerts){
+		if ((numVerts <= 0) || (stream.Num() == 0))
+			return;
+		const int32 elementsPerVertex = stream.Num() / numVerts;
+		TArray<T> result;
+		result.SetNumUninitialized(newNumVerts * elementsPerVertex);
+		for(int32 v = 0; v < numVerts; v++){
+			const int32 dst = remap[v] * elementsPerVertex;
+			const int32 src = v * elementsPerVertex;
+			for(int32 i = 0; i < elementsPerVertex; i++)
+				result[dst + i] = stream[src + i];
+		}
+		stream = MoveTemp(result);
+	}
+	/*
+	Vertex i of the result is vertex newToOld[i] of the source. Unlike remapVertexStream, can duplicate vertices.
+	*/
+	template<typename T> static void gatherVertexStream(TArray<T> &stream, int32 numVerts, const TArray<int32> &newToOld){
+		if ((numVerts <= 0) || (stream.Num() == 0))
+			return;
+		const int32 elementsPerVertex = stream.Num() / numVerts;
+		TArray<T> result;
+		result.SetNumUninitialized(newToOld.Num() * elementsPerVertex);
+		for(int32 v = 0; v < newToOld.Num(); v++){
+			const int32 dst = v * elementsPerVertex;
+			const int32 src = newToOld[v] * elementsPerVertex;
+			for(int32 i = 0; i < elementsPerVertex; i++)
+				result[dst + i] = stream[src + i];
+		}
+		stream = MoveTemp(result);
+	}
+
+	/*
+	Reorders triangles for post-transform vertex cache (Tipsify, Sander et al. 2007).
+	*/
+	static void optimizeVertexCache(TArray<int32> &indices, int32 numVerts, int32 cacheSize = 16);
+	/*
+	Splits cache-optimized triangle order into clusters at points where the cache is flushed anyway, and sorts 
+	clusters so the ones facing away from mesh center are drawn first. positions are xyz triplets.
+	*/
+	static void optimizeOverdraw(TArray<int32> &indices, const TArray<float> &positions, int32 cacheSize = 16);
+	//Average number of vertex shader invocations per triangle with a FIFO cache.
+	static float computeACMR(const TArray<int32> &indices, int32 numVerts, int32 cacheSize = 16);
+};
@@ -0,0 +1,27 @@
+#pragma once
+#include "CoreMinimal.h"
+
+/*
+Quadric error simplification of indexed triangle meshes.
+
+Vertices are collapsed onto their neighbours instead of being moved, so simplified triangles reference the original 
+vertex buffer and every vertex attribute stays valid. Vertices on open borders, on attribute seams 
+(several vertices sharing a position) and on boundaries between index ranges (submeshes) are never collapsed.
+*/
+class MeshSimplifier{
+public:
+	using IndexRange = TArray<int32>;
+	using IndexRangeArray = TArray<IndexRange>;
+
+	/*
+	positions are xyz triplets. All index ranges are simplified together till the total number of triangles 
+	reaches targetTriangles or no more collapses are possible, and written to outRanges in the same order.
+
+	When vertexGroups (one entry per vertex) is given, vertices are only collapsed onto vertices of the same group. 
+	Skinned meshes pass the dominant bone of every vertex, so simplified triangles keep the skinning of the area they replace.
+
+	Returns area-weighted quadric error of the worst collapse, for diagnostics.
+	*/
+	static float simplify(const TArray<float> &positions, const IndexRangeArray &ranges, int32 targetTriangles, IndexRangeArray &outRanges, 
+		const TArray<int32> *vertexGroups = nullptr);
+};
@@ -13,6 +13,7 @@ class USkeletalMesh;
 class UMaterial;
 class UMaterialInterface;
 class JsonImporter;
+class IMeshUtilities;
 
 struct SkeletalMeshBuildData{
 	bool hasColors = false;
@@ -31,9 +32,11 @@ struct SkeletalMeshBuildData{
 
 	void startWithMesh(const JsonMesh &jsonMesh);
 	void processPositionsAndWeights(const JsonMesh &jsonMesh, const TMap<int, int> &meshToSkeletonBoneMap, StringArray &remapErrors);
-	void processWedgeData(const JsonMesh &jsonMesh);
+	void processWedgeData(const JsonMesh &jsonMesh, int32 lod = 0);
 
-	void buildSkeletalMesh(FSkeletalMeshLODModel &lodModel, const FReferenceSkeleton &refSkeleton, const JsonMesh &jsonMesh);
+	//Lods are built in parallel, each with its own build data. meshUtils must be loaded on the game thread beforehand.
+	void buildSkeletalMesh(FSkeletalMeshLODModel &lodModel, const FReferenceSkeleton &refSkeleton, const JsonMesh &jsonMesh, 
+		IMeshUtilities &meshUtils);
 	void computeBoundingBox(USkeletalMesh *skelMesh, const JsonMesh &jsonMesh);
 
 	void processBlendShapes(USkeletalMesh *skelMesh, const JsonMesh &jsonMesh);
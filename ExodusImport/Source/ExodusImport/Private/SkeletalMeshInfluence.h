@@ -0,0 +1,65 @@
+#pragma once
+#include "CoreMinimal.h"
+
+/*
+Bone influence of a single skeletal mesh vertex.
+
+Unreal stores weights as uint8, so integer weight is tracked along with the float one,
+and normalization makes integer weights of a vertex sum to exactly 255.
+*/
+struct SkeletalMeshInfluence{
+	int boneIndex = 0;
+	float weight = 0.0f;
+	int intWeight = 0;
+	void recomputeInt(){
+		intWeight = (int)(255.0f * weight);
+	}
+	void recomputeFloat(){
+		weight = ((float)intWeight)/255.0f;
+	}
+	SkeletalMeshInfluence() = default;
+	SkeletalMeshInfluence(int boneIndex_, float weight_)
+	:boneIndex(boneIndex_), weight(weight_){
+		intWeight = (int)(weight * 255.0f);//truncate
+	}
+};
+
+using SkeletalMeshInfluenceArray = TArray<SkeletalMeshInfluence>;
+
+float getTotalWeight(const SkeletalMeshInfluenceArray &arr);
+int getTotalIntWeight(const SkeletalMeshInfluenceArray &arr);
+
+/*
+Influences must be sorted from strongest to weakest, rounding error is added to the first one.
+*/
+void normalizeInfluences(SkeletalMeshInfluenceArray &influences);
+
+/*
+Bone influences of many vertices in fixed-width slots, structure of arrays: slot s of vertex v is at index s * numVerts + v.
+Batch operations are branch-free loops over contiguous per-slot arrays, GCC -O3 vectorizes every one of them 
+across vertices in the standalone build (checked with -fopt-info-vec).
+Unused slots have zero weight.
+*/
+class SkeletalMeshInfluenceSlots{
+public:
+	int32 numVerts = 0;
+	int32 numSlots = 0;
+	TArray<int32> boneIndices;
+	TArray<float> weights;
+	//Filled by normalize
+	TArray<uint8> intWeights;
+
+	//All slots are cleared
+	void init(int32 numVerts_, int32 numSlots_);
+	/*
+	Processes vertices [first, last): merges slots that refer to the same bone (as happens once bones are remapped to their parents), 
+	sorts slots from strongest to weakest, keeps maxInfluences strongest ones and scales them to sum to 1.
+	Integer weights of a vertex are differences of rounded running totals, so they sum to exactly 255 and none is off by more than one.
+	Float weights are set to intWeight/255. Negative weights count as zero, vertices without positive weights get no influences.
+	Disjoint ranges can be processed on different threads.
+	*/
+	void normalize(int32 maxInfluences, int32 first, int32 last);
+	void normalize(int32 maxInfluences){
+		normalize(maxInfluences, 0, numVerts);
+	}
+};
@@ -4,11 +4,14 @@
 #include "LandscapeInfo.h"
 #include "LandscapeLayerInfoObject.h"
 #include "JsonImporter.h"
+#include "ImportProfiler.h"
 
 #include "UnrealUtilities.h"
 #include "MeshBuilder.h"
 #include "Materials/Material.h"
 #include "JsonObjects/JsonBinaryTerrain.h"
+#include "Misc/SecureHash.h"
+#include "EngineUtils.h"
 
 #include "Runtime/Foliage/Public/InstancedFoliageActor.h"
 #include "Runtime/Landscape/Classes/LandscapeGrassType.h"
@@ -282,6 +285,34 @@ void TerrainBuilder::processFoliageTreeActors(ALandscape *landscape){
 	}
 }
 
+FString TerrainBuilder::computeLandscapeHash(const DataPlane2D<uint16> &heightMap, const TArray<FLandscapeImportLayerInfo> &layers){
+	FSHA1 sha;
+	const int32 size[] = {heightMap.getWidth(), heightMap.getHeight()};
+	sha.Update((const uint8*)size, sizeof(size));
+	sha.Update((const uint8*)heightMap.getData(), sizeof(uint16) * heightMap.getWidth() * heightMap.getHeight());
+	for(const auto &curLayer: layers){
+		auto layerName = curLayer.LayerName.ToString();
+		sha.UpdateWithString(*layerName, layerName.Len());
+		sha.Update(curLayer.LayerData.GetData(), curLayer.LayerData.Num());
+	}
+	sha.Final();
+	uint8 digest[FSHA1::DigestSize];
+	sha.GetHash(digest);
+	return BytesToHex(digest, sizeof(digest));
+}
+
+FGuid TerrainBuilder::getUnusedLandscapeGuid(UWorld *world, const FGuid &contentGuid, const ALandscapeProxy *ignoredProxy){
+	check(world);
+	for(TActorIterator<ALandscapeProxy> it(world); it; ++it){
+		if ((*it != ignoredProxy) && (it->GetLandscapeGuid() == contentGuid)){
+			UE_LOG(JsonLogTerrain, Log, TEXT("Landscape guid %s is already used by %s, generating new one"), 
+				*contentGuid.ToString(), *it->GetName());
+			return FGuid::NewGuid();
+		}
+	}
+	return contentGuid;
+}
+
 ALandscape* TerrainBuilder::buildTerrain(){
 	FString terrPath, terrFileName, terrExt;
 	FPaths::Split(terrainData.exportPath, terrPath, terrFileName, terrExt);
@@ -408,16 +439,27 @@ ALandscape* TerrainBuilder::buildTerrain(){
 	result = workData.world->SpawnActor<ALandscape>(ALandscape::StaticClass());
 	result->StaticLightingLOD = FMath::DivideAndRoundUp(FMath::CeilLogTwo((xSize * ySize) / (2048 * 2048) + 1), (uint32)2);//?
 
-	auto guid = FGuid::NewGuid();
+	/*
+	Content-derived, so unchanged terrains keep their landscape derived data across re-imports.
+	Landscapes are looked up by guid, so the same terrain imported twice into one world gets a random one.
+	*/
+	const auto landscapeHash = computeLandscapeHash(heightMapData, importLayers);
+	const auto landscapePath = FString::Printf(TEXT("%s:%s:%s"), *workData.world->GetPathName(), *jsonGameObj.scenePath, *terrainData.path);
 	auto *landProxy = Cast<ALandscapeProxy>(result);
+	auto guid = getUnusedLandscapeGuid(workData.world, makeContentGuid(landscapeHash, landscapePath), landProxy);
 	landProxy->SetLandscapeGuid(guid);
 
 	landProxy->LandscapeMaterial = terrainMaterial;
 	landProxy->LandscapeHoleMaterial = terrainMaterial;
 
-	landProxy->Import(FGuid::NewGuid(),
-		0, 0, xSize - 1, ySize - 1, sectionsPerComp, quadsPerSection, heightMapData.getData(), 
-		TEXT(""), importLayers, ELandscapeImportAlphamapType::Additive);
+	{
+		ImportProfileScope profileScope(TEXT("ALandscapeProxy::Import"), terrainData.name);
+		profileScope.addElements((int64)xSize * ySize);
+		auto importGuid = getUnusedLandscapeGuid(workData.world, makeContentGuid(landscapeHash, landscapePath + TEXT(":import")), landProxy);
+		landProxy->Import(importGuid,
+			0, 0, xSize - 1, ySize - 1, sectionsPerComp, quadsPerSection, heightMapData.getData(), 
+			TEXT(""), importLayers, ELandscapeImportAlphamapType::Additive);
+	}
 
 	for(int i = 0; i < importLayers.Num(); i++){
 		auto &curLayer = importLayers[i];
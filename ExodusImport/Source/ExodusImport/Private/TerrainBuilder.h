@@ -4,6 +4,7 @@
 #include "JsonObjects/JsonGameObject.h"
 #include "JsonObjects/JsonTerrain.h"
 #include "JsonObjects/JsonTerrainData.h"
+#include "JsonObjects/DataPlane2D.h"
 #include "ImportWorkData.h"
 
 class JsonImporter;
@@ -12,6 +13,7 @@ class ULandscapeGrassType;
 class ULandscapeLayerInfoObject;
 class UStaticMesh;
 class UMaterialInstanceConstant;
+struct FLandscapeImportLayerInfo;
 
 class TerrainBuilder{
 protected:
@@ -49,6 +51,10 @@ protected:
 	ULandscapeLayerInfoObject* createTerrainLayerInfo(int layerIndex, bool grassLayer, 
 		const FString &terrainDataPath);
 	void processFoliageTreeActors(ALandscape *landscape);
+	//Hash of heightmap and layer weights passed to landscape import.
+	static FString computeLandscapeHash(const DataPlane2D<uint16> &heightMap, const TArray<FLandscapeImportLayerInfo> &layers);
+	//Returns contentGuid unless a landscape in the world already uses it, NewGuid otherwise.
+	static FGuid getUnusedLandscapeGuid(UWorld *world, const FGuid &contentGuid, const ALandscapeProxy *ignoredProxy);
 
 	UStaticMesh* createBillboardMesh(const FString &baseName, const JsonTerrainDetailPrototype &detPrototype, int layerIndex, const FString &terrainDataPath);
 	UStaticMesh* createGrassMesh(const FString &baseName, const JsonTerrainDetailPrototype &detPrototype, int layerIndex, const FString &terrainDataPath);
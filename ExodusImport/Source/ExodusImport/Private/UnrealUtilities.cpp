@@ -1,5 +1,6 @@
 #include "JsonImportPrivatePCH.h"
 #include "UnrealUtilities.h"
+#include "Misc/SecureHash.h"
 #include "JsonImporter.h"
 #include "UnrealEd/Public/ObjectTools.h"
 #include "UnrealEd/Public/PackageTools.h"
@@ -147,6 +148,34 @@ UPackage* UnrealUtilities::createPackage(const FString &basePackageName,
 	return package;
 }
 
+FGuid UnrealUtilities::makeContentGuid(const FString &contentHash, const FString &assetPath){
+	FMD5 md5;
+	FTCHARToUTF8 hashUtf8(*contentHash);
+	FTCHARToUTF8 pathUtf8(*assetPath);
+	md5.Update((const uint8*)hashUtf8.Get(), hashUtf8.Length());
+	//separator, so that different splits of the same string give different guids
+	const uint8 separator = 0;
+	md5.Update(&separator, sizeof(separator));
+	md5.Update((const uint8*)pathUtf8.Get(), pathUtf8.Length());
+
+	uint32 digest[4];
+	md5.Final((uint8*)digest);
+	return FGuid(digest[0], digest[1], digest[2], digest[3]);
+}
+
+void UnrealUtilities::assignContentGuids(UStaticMesh *mesh){
+	check(mesh);
+	FString contentHash;
+	for(auto &srcModel: mesh->SourceModels){
+		if (srcModel.RawMeshBulkData->IsEmpty())
+			continue;
+		//Raw mesh id is part of the static mesh derived data key
+		srcModel.RawMeshBulkData->UseHashAsGuid(mesh);
+		contentHash += srcModel.RawMeshBulkData->GetIdString();
+	}
+	mesh->LightingGuid = makeContentGuid(contentHash, mesh->GetPathName());
+}
+
 void UnrealUtilities::generateStaticMesh(UStaticMesh *mesh, RawMeshFillCallback fillCallback, 
 		StaticMeshBuildCallback preConfig, StaticMeshBuildCallback postConfig){
 	int32 lod = 0;
@@ -160,7 +189,6 @@ void UnrealUtilities::generateStaticMesh(UStaticMesh *mesh, RawMeshFillCallback
 	srcModel.StaticMeshOwner = mesh;
 #endif
 
-	mesh->LightingGuid = FGuid::NewGuid();
 	mesh->LightMapResolution = 64;///config?`
 	mesh->LightMapCoordinateIndex = 1;
 	if (preConfig)
@@ -185,6 +213,7 @@ void UnrealUtilities::generateStaticMesh(UStaticMesh *mesh, RawMeshFillCallback
 	}
 
 	srcModel.RawMeshBulkData->SaveRawMesh(newRawMesh);
+	assignContentGuids(mesh);
 
 	srcModel.BuildSettings.bRecomputeNormals = false;//!hasNormals;//hasNormals
 	srcModel.BuildSettings.bRecomputeTangents = true;
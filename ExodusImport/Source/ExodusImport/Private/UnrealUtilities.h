@@ -108,6 +108,17 @@ namespace UnrealUtilities{
 	using StaticMeshBuildCallback = std::function<void(UStaticMesh* mesh, FStaticMeshSourceModel& model)>;
 	using RawMeshFillCallback = std::function<void(FRawMesh& rawMesh, int lod)>;
 
+	/*
+	Guid derived from a content hash and the path of the asset it belongs to. Re-importing unchanged content
+	produces the same guid, so derived data keyed by it stays valid.
+	*/
+	FGuid makeContentGuid(const FString &contentHash, const FString &assetPath);
+	/*
+	Replaces random raw mesh ids and lighting guid of the mesh with ones derived from its source geometry.
+	Must be called after raw meshes of all source models were saved.
+	*/
+	void assignContentGuids(UStaticMesh *mesh);
+
 	//Mesh generation routine. There's only one lod for now.
 	void generateStaticMesh(UStaticMesh *mesh, RawMeshFillCallback fillCallback, 
 		StaticMeshBuildCallback preConfig = nullptr, StaticMeshBuildCallback postConfig = nullptr);
@@ -0,0 +1,152 @@
+#include "JsonImportPrivatePCH.h"
+#include "InstancedMeshBuilder.h"
+#include "JsonImporter.h"
+#include "UnrealUtilities.h"
+#include "ImportProfiler.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Classes/Engine/CollisionProfile.h"
+
+bool InstancedMeshBuilder::canBeInstanced(const JsonGameObject &gameObj, const IdSet &parentIds){
+	if (!gameObj.hasMesh() || !gameObj.isStatic || !gameObj.activeInHierarchy)
+		return false;
+	if (parentIds.Contains(gameObj.id))
+		return false;
+	if (gameObj.hasColliders() || gameObj.hasRigidbody() || gameObj.hasJoints())
+		return false;
+	if (gameObj.hasLights() || gameObj.hasProbes() || gameObj.hasTerrain() || gameObj.hasSkinMeshes() || gameObj.hasAnimators())
+		return false;
+	if (gameObj.renderers.Num() != 1)
+		return false;
+	//Shadow-only renderers are hidden per component
+	return !gameObj.renderers[0].castsShadowsOnly();
+}
+
+FString InstancedMeshBuilder::makeGroupKey(const FString &meshPath, const IntArray &materials, const JsonRenderer &renderer){
+	FString result = meshPath;
+	for(auto matId: materials)
+		result += FString::Printf(TEXT("|%d"), matId);
+	result += TEXT("|");
+	result += renderer.shadowCastingMode;
+	return result;
+}
+
+ImportedObject InstancedMeshBuilder::spawnInstanceGroup(ImportWorkData &workData, const InstanceGroup &group, const FString &folderPath, JsonImporter *importer){
+	using namespace UnrealUtilities;
+	check(importer);
+	check(group.renderer);
+
+	auto *meshObject = LoadObject<UStaticMesh>(nullptr, *group.meshPath);
+	if (!meshObject){
+		UE_LOG(JsonLog, Warning, TEXT("Could not load mesh %s for instancing"), *group.meshPath);
+		return ImportedObject();
+	}
+
+	auto actor = workData.world->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity);
+	if (!actor){
+		UE_LOG(JsonLog, Warning, TEXT("Could not spawn instanced mesh actor for %s"), *group.meshPath);
+		return ImportedObject();
+	}
+
+	auto meshComp = NewObject<UHierarchicalInstancedStaticMeshComponent>(actor);
+	meshComp->SetMobility(EComponentMobility::Static);
+	actor->SetRootComponent(meshComp);
+
+	meshComp->SetStaticMesh(meshObject);
+	meshComp->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+	meshComp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	bool emissiveMesh = false;
+	for(int i = 0; i < group.materials.Num(); i++){
+		auto matId = group.materials[i];
+		auto *jsonMat = importer->getJsonMaterial(matId);
+		if (jsonMat && jsonMat->isEmissive())
+			emissiveMesh = true;
+		meshComp->SetMaterial(i, importer->loadMaterialInterface(matId));
+	}
+	if (emissiveMesh)
+		meshComp->LightmassSettings.bUseEmissiveForStaticLighting = true;
+
+	meshComp->SetCastShadow(group.renderer->castsShadows());
+	meshComp->bCastShadowAsTwoSided = group.renderer->castsTwoSidedShadows();
+
+	//Cluster tree is built once after all instances are in
+	meshComp->bAutoRebuildTreeOnInstanceChanges = false;
+	for(auto gameObj: group.objects){
+		FTransform transform;
+		transform.SetFromMatrix(gameObj->ueWorldMatrix);
+		meshComp->AddInstance(transform);
+	}
+	meshComp->bAutoRebuildTreeOnInstanceChanges = true;
+	meshComp->BuildTreeIfOutdated(false, true);
+
+	makeComponentVisibleInEditor(meshComp);
+	convertToInstanceComponent(meshComp);
+
+	auto label = FString::Printf(TEXT("%s_instances"), *meshObject->GetName());
+	actor->SetActorLabel(label, true);
+	actor->SetFolderPath(*folderPath);
+	actor->MarkComponentsRenderStateDirty();
+
+	UE_LOG(JsonLog, Log, TEXT("Created %d instances of %s"), group.objects.Num(), *group.meshPath);
+	return ImportedObject(actor);
+}
+
+void InstancedMeshBuilder::processInstancedMeshes(ImportWorkData &workData, const TArray<JsonGameObject> &objects, 
+		IdSet &outInstancedIds, JsonImporter *importer){
+	IMPORT_PROFILE_SCOPE("processInstancedMeshes");
+	check(importer);
+	if (!workData.world)
+		return;
+
+	IdSet parentIds;
+	for(const auto &curObj: objects){
+		if (curObj.hasParent())
+			parentIds.Add(curObj.parentId);
+	}
+
+	//Array keeps spawn order stable between runs
+	TArray<InstanceGroup> groups;
+	TMap<FString, int32> groupIndexes;
+	for(const auto &curObj: objects){
+		if (!canBeInstanced(curObj, parentIds))
+			continue;
+
+		//Meshes deduplicated during import share the asset path, so they land in the same group
+		auto meshPath = importer->findMeshPath(curObj.meshId);
+		if (!meshPath)
+			continue;
+
+		const auto &renderer = curObj.renderers[0];
+		auto materials = curObj.getFirstMaterials();
+		auto key = makeGroupKey(*meshPath, materials, renderer);
+
+		auto foundIndex = groupIndexes.Find(key);
+		if (!foundIndex){
+			auto newIndex = groups.AddDefaulted();
+			auto &newGroup = groups[newIndex];
+			newGroup.meshPath = *meshPath;
+			newGroup.materials = materials;
+			newGroup.renderer = &renderer;
+			foundIndex = &groupIndexes.Add(key, newIndex);
+		}
+		groups[*foundIndex].objects.Add(&curObj);
+	}
+
+	const int32 minInstances = FMath::Max(importer->getOptions().minInstanceCount, 2);
+	const FString folderPath = TEXT("InstancedMeshes");
+	int32 numActors = 0;
+	for(const auto &group: groups){
+		if (group.objects.Num() < minInstances)
+			continue;
+
+		auto spawned = spawnInstanceGroup(workData, group, folderPath, importer);
+		if (!spawned.isValid())
+			continue;
+
+		numActors++;
+		for(auto gameObj: group.objects)
+			outInstancedIds.Add(gameObj->id);
+	}
+
+	UE_LOG(JsonLog, Log, TEXT("Instanced %d objects into %d actors"), outInstancedIds.Num(), numActors);
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "JsonTypes.h"
+#include "ImportedObject.h"
+#include "ImportWorkData.h"
+
+class JsonImporter;
+class JsonRenderer;
+
+/*
+Replaces repeated static mesh objects with hierarchical instanced static mesh components.
+
+Objects qualify when they are static, active, have a single renderer, no colliders, rigidbodies, joints, 
+other components or children. Qualifying objects that share mesh asset, materials and shadow settings 
+form a group; each group large enough becomes one actor with a UHierarchicalInstancedStaticMeshComponent.
+*/
+class InstancedMeshBuilder{
+protected:
+	class InstanceGroup{
+	public:
+		FString meshPath;
+		IntArray materials;
+		const JsonRenderer *renderer = nullptr;
+		TArray<const JsonGameObject*> objects;
+	};
+
+	static bool canBeInstanced(const JsonGameObject &gameObj, const IdSet &parentIds);
+	static FString makeGroupKey(const FString &meshPath, const IntArray &materials, const JsonRenderer &renderer);
+	static ImportedObject spawnInstanceGroup(ImportWorkData &workData, const InstanceGroup &group, const FString &folderPath, JsonImporter *importer);
+public:
+	/*
+	Spawns instanced actors for the scene. Ids of objects turned into instances are added to outInstancedIds,
+	those objects must not be imported individually.
+	*/
+	static void processInstancedMeshes(ImportWorkData &workData, const TArray<JsonGameObject> &objects, 
+		IdSet &outInstancedIds, JsonImporter *importer);
+};
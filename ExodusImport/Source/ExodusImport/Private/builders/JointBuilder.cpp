@@ -412,10 +412,11 @@ void JointBuilder::processPhysicsJoint(const JsonGameObject &obj, const Instance
 	}
 }
 
-void JointBuilder::processPhysicsJoints(const TArray<JsonGameObject>& objects, ImportWorkData &workData) const{
+void JointBuilder::processPhysicsJoints(const TArray<JsonGameObject>& objects, ImportWorkData &workData, bool interactive) const{
 	InstanceIdMap instanceMap;
 	FScopedSlowTask progress(objects.Num(), LOCTEXT("Processing joints", "Processing joints"));
-	progress.MakeDialog();
+	if (interactive)
+		progress.MakeDialog();
 	UE_LOG(JsonLog, Log, TEXT("Processing joints"));
 	for (int i = 0; i < objects.Num(); i++){
 		auto srcObj = objects[i];
@@ -62,5 +62,6 @@ protected:
 
 
 public:
-	void processPhysicsJoints(const JsonGameObjectArray& objects, ImportWorkData &workData) const;
+	//Progress dialog is only shown for interactive imports (see ImportOptions::interactive)
+	void processPhysicsJoints(const JsonGameObjectArray& objects, ImportWorkData &workData, bool interactive) const;
 };
@@ -0,0 +1,269 @@
+#include "JsonImportPrivatePCH.h"
+#include "MergedMeshBuilder.h"
+#include "JsonImporter.h"
+#include "UnrealUtilities.h"
+#include "MeshBuilder.h"
+#include "ImportProfiler.h"
+#include "LightmapUvGenerator.h"
+#include "RawMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Classes/Engine/CollisionProfile.h"
+
+bool MergedMeshBuilder::canBeMerged(const JsonGameObject &gameObj, const IdSet &parentIds){
+	if (!gameObj.hasMesh() || !gameObj.isStatic || !gameObj.activeInHierarchy)
+		return false;
+	if (parentIds.Contains(gameObj.id))
+		return false;
+	//Merged meshes carry no collision
+	if (gameObj.hasColliders() || gameObj.hasRigidbody() || gameObj.hasJoints())
+		return false;
+	if (gameObj.hasLights() || gameObj.hasProbes() || gameObj.hasTerrain() || gameObj.hasSkinMeshes() || gameObj.hasAnimators())
+		return false;
+	if (gameObj.renderers.Num() != 1)
+		return false;
+	return !gameObj.renderers[0].castsShadowsOnly();
+}
+
+const MergedMeshBuilder::SourceMesh* MergedMeshBuilder::findSourceMesh(TMap<FString, SourceMesh> &cache, const FString &meshPath){
+	auto found = cache.Find(meshPath);
+	if (found)
+		return found->mesh ? found: nullptr;
+
+	//Failed loads are cached too, so they're reported once
+	auto &entry = cache.Add(meshPath);
+	auto *mesh = LoadObject<UStaticMesh>(nullptr, *meshPath);
+	if (!mesh || (mesh->SourceModels.Num() < 1)){
+		UE_LOG(JsonLog, Warning, TEXT("Could not load source geometry of mesh %s for merging"), *meshPath);
+		return nullptr;
+	}
+
+	auto rawMesh = MakeShared<FRawMesh>();
+	mesh->SourceModels[0].RawMeshBulkData->LoadRawMesh(*rawMesh);
+	if (!rawMesh->IsValid()){
+		UE_LOG(JsonLog, Warning, TEXT("Mesh %s has no valid source geometry, it will not be merged"), *meshPath);
+		return nullptr;
+	}
+
+	entry.mesh = mesh;
+	entry.rawMesh = rawMesh;
+	return &entry;
+}
+
+ImportedObject MergedMeshBuilder::spawnMergedCell(ImportWorkData &workData, const MergeCell &cell, float cellSize, 
+		TMap<FString, SourceMesh> &meshCache, IdSet &processedIds, JsonImporter *importer){
+	using namespace UnrealUtilities;
+	check(importer);
+
+	const FVector cellOrigin = (FVector(cell.coord) + FVector(0.5f)) * cellSize;
+	const auto cellMatrix = FTranslationMatrix(-cellOrigin);
+
+	FRawMesh mergedMesh;
+	TArray<UMaterialInterface*> mergedMaterials;
+	TMap<UMaterialInterface*, int32> mergedMaterialIndexes;
+	const JsonRenderer *renderer = nullptr;
+	bool emissiveMesh = false;
+	IdSet mergedIds;
+	MeshBuilder meshBuilder;
+
+	for(auto gameObj: cell.objects){
+		auto meshPath = importer->findMeshPath(gameObj->meshId);
+		if (!meshPath)
+			continue;
+		auto sourceMesh = findSourceMesh(meshCache, *meshPath);
+		if (!sourceMesh)
+			continue;
+
+		auto materialIds = gameObj->getFirstMaterials();
+		const auto &staticMaterials = sourceMesh->mesh->StaticMaterials;
+		const int32 numMaterials = FMath::Max(materialIds.Num(), staticMaterials.Num());
+
+		IntArray materialRemap;
+		for(int32 i = 0; i < numMaterials; i++){
+			UMaterialInterface *material = nullptr;
+			if (i < materialIds.Num()){
+				material = importer->loadMaterialInterface(materialIds[i]);
+				auto *jsonMat = importer->getJsonMaterial(materialIds[i]);
+				if (jsonMat && jsonMat->isEmissive())
+					emissiveMesh = true;
+			}
+			if (!material && (i < staticMaterials.Num()))
+				material = staticMaterials[i].MaterialInterface;
+
+			auto foundIndex = mergedMaterialIndexes.Find(material);
+			if (!foundIndex){
+				foundIndex = &mergedMaterialIndexes.Add(material, mergedMaterials.Num());
+				mergedMaterials.Add(material);
+			}
+			materialRemap.Add(*foundIndex);
+		}
+
+		meshBuilder.appendRawMesh(mergedMesh, *sourceMesh->rawMesh, gameObj->ueWorldMatrix * cellMatrix, materialRemap);
+		mergedIds.Add(gameObj->id);
+		if (!renderer)
+			renderer = &gameObj->renderers[0];
+	}
+
+	//Not worth a separate asset, objects will be imported individually
+	if (mergedIds.Num() < 2)
+		return ImportedObject();
+
+	auto worldName = workData.world->GetName();
+	auto meshName = FString::Printf(TEXT("%s_cell_%d_%d_%d"), *worldName, cell.coord.X, cell.coord.Y, cell.coord.Z);
+	if (renderer->shadowCastingMode != TEXT("On"))
+		meshName += FString::Printf(TEXT("_%s"), *renderer->shadowCastingMode);
+	auto desiredDir = FPaths::Combine(TEXT("MergedMeshes"), *worldName);
+
+	int32 numUsedUvs = 0;
+	for(int32 i = 0; i < MAX_MESH_TEXTURE_COORDS; i++){
+		if (mergedMesh.WedgeTexCoords[i].Num() > 0)
+			numUsedUvs = i + 1;
+	}
+
+	auto numVerts = mergedMesh.VertexPositions.Num();
+	//Same density as individual meshes (see JsonImporter::prepareMeshGeometry), computed from the merged surface
+	int32 lightmapResolution = 256;
+	const auto &importOptions = importer->getOptions();
+	if (importOptions.autoLightmaps){
+		TArray<float> positions;
+		TArray<int32> indices;
+		positions.Reserve(numVerts * 3);
+		for(const auto &pos: mergedMesh.VertexPositions){
+			//Raw mesh is in unreal units, lightmap density is per meter
+			positions.Add(pos.X * 0.01f);
+			positions.Add(pos.Y * 0.01f);
+			positions.Add(pos.Z * 0.01f);
+		}
+		indices.Reserve(mergedMesh.WedgeIndices.Num());
+		for(auto index: mergedMesh.WedgeIndices)
+			indices.Add((int32)index);
+		lightmapResolution = LightmapUvGenerator::computeResolution(LightmapUvGenerator::computeSurfaceArea(positions, indices), 
+			importOptions.lightmapTexelsPerMeter, importOptions.minLightmapResolution, importOptions.maxLightmapResolution);
+	}
+	auto mesh = createAssetObject<UStaticMesh>(meshName, &desiredDir, importer, 
+		[&](UStaticMesh *mesh){
+			IMPORT_PROFILE_SCOPE_ASSET("buildMergedCellMesh", meshName);
+			generateStaticMesh(mesh, 
+				[&](FRawMesh &rawMesh, int lod){
+					rawMesh = MoveTemp(mergedMesh);
+				}, 
+				nullptr,
+				[&](UStaticMesh *mesh, FStaticMeshSourceModel &model){
+					mesh->StaticMaterials.Empty();
+					for(auto material: mergedMaterials)
+						mesh->StaticMaterials.Add(material);
+
+					//Lightmap uvs of source meshes overlap once merged
+					if (numUsedUvs < MAX_MESH_TEXTURE_COORDS){
+						model.BuildSettings.bGenerateLightmapUVs = true;
+						model.BuildSettings.SrcLightmapIndex = 0;
+						model.BuildSettings.DstLightmapIndex = numUsedUvs;
+						mesh->LightMapCoordinateIndex = numUsedUvs;
+					}
+					mesh->LightMapResolution = lightmapResolution;
+					if (importOptions.autoLightmaps)
+						model.BuildSettings.MinLightmapResolution = lightmapResolution;
+				}
+			);
+		},
+		[&](auto pkg, auto objName){
+			return NewObject<UStaticMesh>(pkg, FName(*objName), RF_Standalone|RF_Public);
+		}, RF_Standalone|RF_Public
+	);
+	if (!mesh){
+		UE_LOG(JsonLog, Warning, TEXT("Could not create merged mesh %s"), *meshName);
+		return ImportedObject();
+	}
+
+	FActorSpawnParameters spawnParams;
+	auto meshActor = workData.world->SpawnActor<AStaticMeshActor>(AStaticMeshActor::StaticClass(), FTransform(cellOrigin), spawnParams);
+	if (!meshActor){
+		UE_LOG(JsonLog, Warning, TEXT("Could not spawn merged mesh actor for %s"), *meshName);
+		return ImportedObject();
+	}
+
+	auto meshComp = meshActor->GetStaticMeshComponent();
+	meshComp->SetMobility(EComponentMobility::Static);
+	meshComp->SetStaticMesh(mesh);
+	meshComp->SetCollisionProfileName(UCollisionProfile::NoCollision_ProfileName);
+	meshComp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	if (emissiveMesh)
+		meshComp->LightmassSettings.bUseEmissiveForStaticLighting = true;
+	meshComp->SetCastShadow(renderer->castsShadows());
+	meshComp->bCastShadowAsTwoSided = renderer->castsTwoSidedShadows();
+
+	meshActor->SetActorLabel(meshName, true);
+	meshActor->SetFolderPath(TEXT("MergedMeshes"));
+	meshActor->MarkComponentsRenderStateDirty();
+
+	processedIds.Append(mergedIds);
+	UE_LOG(JsonLog, Log, TEXT("Merged %d objects into %s: %d verts, %d materials"), 
+		mergedIds.Num(), *meshName, numVerts, mergedMaterials.Num());
+	return ImportedObject(meshActor);
+}
+
+void MergedMeshBuilder::processMergedMeshes(ImportWorkData &workData, const TArray<JsonGameObject> &objects, 
+		IdSet &processedIds, JsonImporter *importer){
+	IMPORT_PROFILE_SCOPE("processMergedMeshes");
+	check(importer);
+	if (!workData.world)
+		return;
+
+	const auto &options = importer->getOptions();
+	const float cellSize = FMath::Max(options.mergeCellSize, 1.0f);
+
+	IdSet parentIds;
+	for(const auto &curObj: objects){
+		if (curObj.hasParent())
+			parentIds.Add(curObj.parentId);
+	}
+
+	TMap<FString, SourceMesh> meshCache;
+	TArray<MergeCell> cells;
+	TMap<FString, int32> cellIndexes;
+	for(const auto &curObj: objects){
+		if (processedIds.Contains(curObj.id) || !canBeMerged(curObj, parentIds))
+			continue;
+
+		auto meshPath = importer->findMeshPath(curObj.meshId);
+		if (!meshPath)
+			continue;
+		auto sourceMesh = findSourceMesh(meshCache, *meshPath);
+		if (!sourceMesh)
+			continue;
+
+		//Objects are binned by bounds center, so large objects may stick out of their cell
+		auto center = curObj.ueWorldMatrix.TransformPosition(sourceMesh->mesh->GetBounds().Origin);
+		FIntVector coord(
+			FMath::FloorToInt(center.X / cellSize), 
+			FMath::FloorToInt(center.Y / cellSize), 
+			FMath::FloorToInt(center.Z / cellSize)
+		);
+		const auto &shadowMode = curObj.renderers[0].shadowCastingMode;
+		auto key = FString::Printf(TEXT("%d_%d_%d_%s"), coord.X, coord.Y, coord.Z, *shadowMode);
+
+		auto foundIndex = cellIndexes.Find(key);
+		if (!foundIndex){
+			auto newIndex = cells.AddDefaulted();
+			cells[newIndex].coord = coord;
+			cells[newIndex].shadowCastingMode = shadowMode;
+			foundIndex = &cellIndexes.Add(key, newIndex);
+		}
+		cells[*foundIndex].objects.Add(&curObj);
+	}
+
+	const int32 minObjects = FMath::Max(options.minMergeCount, 2);
+	int32 numActors = 0;
+	int32 numMerged = 0;
+	for(const auto &cell: cells){
+		if (cell.objects.Num() < minObjects)
+			continue;
+		auto numProcessed = processedIds.Num();
+		auto spawned = spawnMergedCell(workData, cell, cellSize, meshCache, processedIds, importer);
+		if (!spawned.isValid())
+			continue;
+		numActors++;
+		numMerged += processedIds.Num() - numProcessed;
+	}
+
+	UE_LOG(JsonLog, Log, TEXT("Merged %d objects into %d cell actors"), numMerged, numActors);
+}
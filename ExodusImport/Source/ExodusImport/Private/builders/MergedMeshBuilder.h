@@ -0,0 +1,44 @@
+#pragma once
+#include "JsonTypes.h"
+#include "ImportedObject.h"
+#include "ImportWorkData.h"
+
+class JsonImporter;
+class UStaticMesh;
+class UMaterialInterface;
+struct FRawMesh;
+
+/*
+Merges static scenery into one mesh per world-space grid cell.
+
+Objects qualify when they are static, active, have a single renderer, no colliders, rigidbodies, joints, 
+other components or children. Geometry of qualifying objects within a cell is transformed into cell space and 
+combined per material into a new UStaticMesh, which is placed by a single actor.
+*/
+class MergedMeshBuilder{
+protected:
+	class MergeCell{
+	public:
+		FIntVector coord = FIntVector::ZeroValue;
+		FString shadowCastingMode;
+		TArray<const JsonGameObject*> objects;
+	};
+
+	class SourceMesh{
+	public:
+		UStaticMesh *mesh = nullptr;
+		TSharedPtr<FRawMesh> rawMesh;
+	};
+
+	static bool canBeMerged(const JsonGameObject &gameObj, const IdSet &parentIds);
+	static const SourceMesh* findSourceMesh(TMap<FString, SourceMesh> &cache, const FString &meshPath);
+	static ImportedObject spawnMergedCell(ImportWorkData &workData, const MergeCell &cell, float cellSize, 
+		TMap<FString, SourceMesh> &meshCache, IdSet &processedIds, JsonImporter *importer);
+public:
+	/*
+	Spawns merged cell actors for the scene. Objects already in processedIds are ignored, ids of objects merged
+	into cells are added to it. Those objects must not be imported individually.
+	*/
+	static void processMergedMeshes(ImportWorkData &workData, const TArray<JsonGameObject> &objects, 
+		IdSet &processedIds, JsonImporter *importer);
+};
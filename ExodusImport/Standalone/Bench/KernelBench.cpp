@@ -0,0 +1,584 @@
+#include "StandaloneShim.h"
+#include "DataPlane2D.h"
+#include "DataPlane3D.h"
+#include "terrainTools.h"
+#include "JsonBinaryTerrain.h"
+#include "SkeletalMeshInfluence.h"
+#include "MeshSimplifier.h"
+#include "MeshRenderOptimizer.h"
+#include "MeshCollisionGenerator.h"
+#include "LightmapUvGenerator.h"
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <random>
+
+/*
+Microbenchmarks for the engine-independent import kernels.
+
+Every benchmark reports best and mean wall time over the iterations and a checksum of its output,
+checksums are deterministic for a given --size and can be compared between runs to catch regressions.
+Output of the last iteration is checked against the kernel's invariants, any broken one fails the run.
+*/
+
+struct BenchSettings{
+	int32 size = 1025;
+	int32 iterations = 5;
+	std::string filter;
+	int32 numFailed = 0;
+};
+
+//Returns description of the broken invariant, nullptr when the output is valid
+using BenchCheck = std::function<const char*()>;
+
+template<typename T> static double checksum(const DataPlane2D<T> &plane){
+	double result = 0.0;
+	for(int32 i = 0; i < plane.getNumElements(); i++)
+		result += plane.getData()[i] * (double)((i % 7) + 1);
+	return result;
+}
+
+static void fillPlane(FloatPlane2D &plane, int32 width, int32 height, uint32 seed){
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> noise(0.0f, 0.05f);
+	plane.resize(width, height);
+	for(int32 y = 0; y < height; y++){
+		auto row = plane.getRow(y);
+		for(int32 x = 0; x < width; x++)
+			row[x] = 0.5f + 0.4f * std::sin(x * 0.05f) * std::cos(y * 0.03f) + noise(rng);
+	}
+}
+
+static bool runBenchmark(BenchSettings &settings, const char *name, std::function<double()> body, BenchCheck validate = nullptr){
+	if (!settings.filter.empty() && (strstr(name, settings.filter.c_str()) == nullptr))
+		return true;
+
+	double best = 0.0, total = 0.0, result = 0.0;
+	for(int32 i = 0; i < settings.iterations; i++){
+		auto start = std::chrono::steady_clock::now();
+		result = body();
+		auto end = std::chrono::steady_clock::now();
+		double ms = std::chrono::duration<double, std::milli>(end - start).count();
+		best = (i == 0) ? ms: std::min(best, ms);
+		total += ms;
+	}
+	const char *error = validate ? validate(): nullptr;
+	if (error){
+		printf("%-36s FAILED: %s\n", name, error);
+		settings.numFailed++;
+		return false;
+	}
+	printf("%-36s best: %10.3f ms  mean: %10.3f ms  checksum: %.6f\n",
+		name, best, total / std::max(settings.iterations, 1), result);
+	return true;
+}
+
+static bool verifyTranspose(int32 width, int32 height){
+	FloatPlane2D src;
+	fillPlane(src, width, height, 7);
+	auto dst = src.getTransposed();
+	if ((dst.getWidth() != height) || (dst.getHeight() != width))
+		return false;
+	for(int32 y = 0; y < height; y++){
+		for(int32 x = 0; x < width; x++){
+			if (dst.getValue(y, x) != src.getValue(x, y))
+				return false;
+		}
+	}
+	return true;
+}
+
+static bool writeBinaryTerrain(const char *filename, int32 hSize, int32 alphaSize, int32 numLayers){
+	FloatPlane2D heights;
+	fillPlane(heights, hSize, hSize, 11);
+
+	TArray<uint8> data;
+	const int64 numFloats = (int64)hSize * hSize + (int64)alphaSize * alphaSize * numLayers;
+	data.SetNumZeroed((int32)(sizeof(int32) * 8 + numFloats * sizeof(float)));
+	int32 header[8] = {hSize, hSize, alphaSize, alphaSize, numLayers, 0, 0, 0};
+	memcpy(data.GetData(), header, sizeof(header));
+	float *floats = (float*)(data.GetData() + sizeof(header));
+	memcpy(floats, heights.getData(), heights.getByteSize());
+	float *alphas = floats + heights.getNumElements();
+	for(int64 i = 0; i < (int64)alphaSize * alphaSize * numLayers; i++)
+		alphas[i] = 1.0f / numLayers;
+
+	return FFileHelper::SaveArrayToFile(TArrayView<const uint8>(data.GetData(), data.Num()), filename);
+}
+
+//Heightfield grid split into two index ranges, the way submeshes share a vertex buffer
+static void makeGridMesh(int32 gridSize, TArray<float> &outPositions, MeshSimplifier::IndexRangeArray &outRanges){
+	FloatPlane2D heights;
+	fillPlane(heights, gridSize, gridSize, 5);
+	outPositions.Empty(gridSize * gridSize * 3);
+	for(int32 y = 0; y < gridSize; y++){
+		for(int32 x = 0; x < gridSize; x++){
+			outPositions.Add((float)x);
+			outPositions.Add(heights.getValue(x, y) * 8.0f);
+			outPositions.Add((float)y);
+		}
+	}
+	outRanges.Empty();
+	outRanges.AddDefaulted(2);
+	for(int32 y = 0; (y + 1) < gridSize; y++){
+		auto &range = outRanges[(y < gridSize / 2) ? 0: 1];
+		for(int32 x = 0; (x + 1) < gridSize; x++){
+			const int32 i00 = y * gridSize + x, i10 = i00 + 1, i01 = i00 + gridSize, i11 = i01 + 1;
+			range.Add(i00); range.Add(i01); range.Add(i10);
+			range.Add(i10); range.Add(i01); range.Add(i11);
+		}
+	}
+}
+
+static int32 countTriangles(const MeshSimplifier::IndexRangeArray &ranges){
+	int32 result = 0;
+	for(const auto &cur: ranges)
+		result += cur.Num() / 3;
+	return result;
+}
+
+static const char *checkTriangleList(const TArray<int32> &indices, int32 numVerts){
+	if ((indices.Num() % 3) != 0)
+		return "index count is not a multiple of 3";
+	for(auto index: indices){
+		if ((index < 0) || (index >= numVerts))
+			return "vertex index out of range";
+	}
+	return nullptr;
+}
+
+static const char *checkSimplified(const MeshSimplifier::IndexRangeArray &lod, const MeshSimplifier::IndexRangeArray &src, 
+		int32 numVerts, int32 targetTriangles){
+	if (lod.Num() != src.Num())
+		return "index range count changed";
+	for(const auto &range: lod){
+		if (const char *error = checkTriangleList(range, numVerts))
+			return error;
+	}
+	if (countTriangles(lod) > countTriangles(src))
+		return "triangle count went up";
+	if (countTriangles(lod) > targetTriangles)
+		return "triangle count above target";
+	return nullptr;
+}
+
+//Corner positions of every triangle, rotated to start at the smallest corner (keeps winding) and sorted
+static std::vector<std::array<float, 9>> getSortedTriangles(const TArray<float> &positions, const TArray<int32> &indices){
+	std::vector<std::array<float, 9>> result(indices.Num() / 3);
+	for(int32 tri = 0; tri < (int32)result.size(); tri++){
+		std::array<float, 3> corners[3];
+		for(int32 corner = 0; corner < 3; corner++){
+			const float *p = positions.GetData() + indices[tri * 3 + corner] * 3;
+			corners[corner] = {p[0], p[1], p[2]};
+		}
+		const int32 first = (int32)(std::min_element(corners, corners + 3) - corners);
+		for(int32 corner = 0; corner < 3; corner++){
+			for(int32 axis = 0; axis < 3; axis++)
+				result[tri][corner * 3 + axis] = corners[(first + corner) % 3][axis];
+		}
+	}
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+//Separating axis test on u, v triangles, shared edges and corners do not count as overlap
+static bool uvTrianglesOverlap(const float *a, const float *b){
+	const float *tris[2] = {a, b};
+	for(int32 t = 0; t < 2; t++){
+		for(int32 edge = 0; edge < 3; edge++){
+			const float *p0 = tris[t] + edge * 2, *p1 = tris[t] + ((edge + 1) % 3) * 2;
+			const float nu = p0[1] - p1[1], nv = p1[0] - p0[0];
+			float minDots[2] = {1e30f, 1e30f}, maxDots[2] = {-1e30f, -1e30f};
+			for(int32 i = 0; i < 2; i++){
+				for(int32 corner = 0; corner < 3; corner++){
+					const float dot = tris[i][corner * 2] * nu + tris[i][corner * 2 + 1] * nv;
+					minDots[i] = FMath::Min(minDots[i], dot);
+					maxDots[i] = FMath::Max(maxDots[i], dot);
+				}
+			}
+			const float epsilon = 1e-6f * FMath::Sqrt(nu * nu + nv * nv);
+			if ((maxDots[0] <= minDots[1] + epsilon) || (maxDots[1] <= minDots[0] + epsilon))
+				return false;
+		}
+	}
+	return true;
+}
+
+static const char *checkLightmapUvs(const TArray<float> &cornerUvs){
+	for(auto value: cornerUvs){
+		if ((value < 0.0f) || (value > 1.0f))
+			return "uv outside of the unit square";
+	}
+
+	//Every chart is packed into the same unit square, so no two triangles may overlap at all
+	const int32 gridSize = 256;
+	std::vector<std::vector<int32>> cells(gridSize * gridSize);
+	const int32 numTris = cornerUvs.Num() / 6;
+	for(int32 tri = 0; tri < numTris; tri++){
+		const float *uv = cornerUvs.GetData() + tri * 6;
+		auto toCell = [&](float value){
+			return FMath::Clamp((int32)(value * gridSize), 0, gridSize - 1);
+		};
+		const int32 minX = toCell(FMath::Min3(uv[0], uv[2], uv[4])), maxX = toCell(FMath::Max3(uv[0], uv[2], uv[4]));
+		const int32 minY = toCell(FMath::Min3(uv[1], uv[3], uv[5])), maxY = toCell(FMath::Max3(uv[1], uv[3], uv[5]));
+		for(int32 y = minY; y <= maxY; y++){
+			for(int32 x = minX; x <= maxX; x++)
+				cells[y * gridSize + x].push_back(tri);
+		}
+	}
+	for(const auto &cell: cells){
+		for(size_t i = 0; i < cell.size(); i++){
+			for(size_t j = i + 1; j < cell.size(); j++){
+				if (uvTrianglesOverlap(cornerUvs.GetData() + cell[i] * 6, cornerUvs.GetData() + cell[j] * 6))
+					return "lightmap triangles overlap";
+			}
+		}
+	}
+	return nullptr;
+}
+
+static const char *checkConvexHulls(const MeshCollisionGenerator::HullArray &hulls, const TArray<int32> &triangleHulls,
+		const TArray<float> &positions, const TArray<int32> &indices){
+	//Hulls are 26-DOPs, a point is inside when it is within the hull extents along all 13 slab directions
+	const float directions[13][3] = {
+		{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f},
+		{1.0f, 1.0f, 0.0f}, {1.0f, -1.0f, 0.0f}, {1.0f, 0.0f, 1.0f},
+		{1.0f, 0.0f, -1.0f}, {0.0f, 1.0f, 1.0f}, {0.0f, 1.0f, -1.0f},
+		{1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, -1.0f}, {1.0f, -1.0f, 1.0f}, {-1.0f, 1.0f, 1.0f}
+	};
+	auto dot = [&](const float *p, int32 dir){
+		return p[0] * directions[dir][0] + p[1] * directions[dir][1] + p[2] * directions[dir][2];
+	};
+
+	if (triangleHulls.Num() != indices.Num() / 3)
+		return "triangle hull count does not match triangle count";
+	std::vector<std::array<float, 26>> extents(hulls.Num());
+	for(int32 hull = 0; hull < hulls.Num(); hull++){
+		//PhysX convex hull vertex limit
+		if ((hulls[hull].Num() < 3 * 4) || (hulls[hull].Num() > 255 * 3))
+			return "hull vertex count out of range";
+		for(int32 dir = 0; dir < 13; dir++){
+			extents[hull][dir * 2] = 1e30f;
+			extents[hull][dir * 2 + 1] = -1e30f;
+			for(int32 i = 0; i < hulls[hull].Num(); i += 3){
+				extents[hull][dir * 2] = FMath::Min(extents[hull][dir * 2], dot(hulls[hull].GetData() + i, dir));
+				extents[hull][dir * 2 + 1] = FMath::Max(extents[hull][dir * 2 + 1], dot(hulls[hull].GetData() + i, dir));
+			}
+		}
+	}
+	for(int32 tri = 0; tri < triangleHulls.Num(); tri++){
+		const int32 hull = triangleHulls[tri];
+		if ((hull < 0) || (hull >= hulls.Num()))
+			return "triangle hull index out of range";
+		for(int32 corner = 0; corner < 3; corner++){
+			const float *p = positions.GetData() + indices[tri * 3 + corner] * 3;
+			for(int32 dir = 0; dir < 13; dir++){
+				const float value = dot(p, dir);
+				const float epsilon = 1e-4f * (FMath::Abs(value) + 1.0f);
+				if ((value < extents[hull][dir * 2] - epsilon) || (value > extents[hull][dir * 2 + 1] + epsilon))
+					return "cluster vertex outside of its hull";
+			}
+		}
+	}
+	return nullptr;
+}
+
+int main(int argc, char **argv){
+	BenchSettings settings;
+	for(int i = 1; i < argc; i++){
+		const char *arg = argv[i];
+		if (strncmp(arg, "--size=", 7) == 0)
+			settings.size = std::max(atoi(arg + 7), 3);
+		else if (strncmp(arg, "--iterations=", 13) == 0)
+			settings.iterations = std::max(atoi(arg + 13), 1);
+		else if (strncmp(arg, "--filter=", 9) == 0)
+			settings.filter = arg + 9;
+		else{
+			fprintf(stderr, "Usage: %s [--size=N] [--iterations=N] [--filter=name]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (!verifyTranspose(37, 19) || !verifyTranspose(19, 37) || !verifyTranspose(16, 16)){
+		fprintf(stderr, "DataPlane2D::getTransposed produced wrong result\n");
+		return 2;
+	}
+
+	const int32 size = settings.size;
+	printf("Kernel benchmarks, size %d, %d iterations\n", size, settings.iterations);
+
+	FloatPlane2D square, wide;
+	fillPlane(square, size, size, 1);
+	fillPlane(wide, size * 2, size / 2 + 1, 2);
+
+	runBenchmark(settings, "transpose2d/square", [&](){
+		auto result = square.getTransposed();
+		return checksum(result);
+	});
+	runBenchmark(settings, "transpose2d/wide", [&](){
+		auto result = wide.getTransposed();
+		return checksum(result);
+	});
+	runBenchmark(settings, "transpose3d/4layers", [&](){
+		FloatPlane3D layers(size, size / 2 + 1, 4);
+		auto result = layers.getTransposed();
+		return (double)result.getNumLayerElements();
+	});
+
+	//Upscale to the next valid landscape size, as JsonConvertedTerrain does
+	const int32 landscapeSize = ((size - 1) / 63 + 1) * 63 + 1;
+	runBenchmark(settings, "rescaleHeightMap", [&](){
+		FloatPlane2D dst(landscapeSize, landscapeSize);
+		JsonTerrainTools::rescaleHeightMap(dst, square);
+		return checksum(dst);
+	});
+	runBenchmark(settings, "rescaleSplatMap", [&](){
+		FloatPlane2D dst(size * 2, size * 2);
+		JsonTerrainTools::rescaleSplatMap(dst, square);
+		return checksum(dst);
+	});
+	runBenchmark(settings, "scaleSplatMapToHeightMap", [&](){
+		FloatPlane2D dst(landscapeSize, landscapeSize);
+		JsonTerrainTools::scaleSplatMapToHeightMap(dst, square);
+		return checksum(dst);
+	});
+
+	const int32 numVerts = size * 64;
+	std::vector<SkeletalMeshInfluenceArray> srcInfluences(numVerts);
+	{
+		std::mt19937 rng(3);
+		std::uniform_real_distribution<float> weightDist(0.0f, 1.0f);
+		for(auto &cur: srcInfluences){
+			float weights[4];
+			for(auto &w: weights)
+				w = weightDist(rng);
+			std::sort(weights, weights + 4, [](float a, float b){return a > b;});
+			for(int32 i = 0; i < 4; i++)
+				cur.Add(SkeletalMeshInfluence(i, weights[i] * 0.5f));
+		}
+	}
+	std::vector<SkeletalMeshInfluenceArray> influences;
+	runBenchmark(settings, "normalizeInfluences", [&](){
+		influences = srcInfluences;
+		double result = 0.0;
+		for(auto &cur: influences){
+			normalizeInfluences(cur);
+			result += cur[0].weight;
+		}
+		return result;
+	}, [&]() -> const char*{
+		for(const auto &cur: influences){
+			if (getTotalIntWeight(cur) != 255)
+				return "quantized weights do not sum to 255";
+		}
+		return nullptr;
+	});
+
+	//8 unsorted influences per vertex, some of them negative
+	SkeletalMeshInfluenceSlots srcSlots;
+	{
+		const int32 numSlots = 8;
+		srcSlots.init(numVerts, numSlots);
+		std::mt19937 rng(5);
+		std::uniform_real_distribution<float> weightDist(-0.1f, 1.0f);
+		for(int32 i = 0; i < numVerts * numSlots; i++){
+			srcSlots.weights[i] = weightDist(rng);
+			srcSlots.boneIndices[i] = i % 61;
+		}
+	}
+	SkeletalMeshInfluenceSlots slots;
+	runBenchmark(settings, "SkeletalMeshInfluenceSlots::normalize/8to4", [&](){
+		slots = srcSlots;
+		slots.normalize(4);
+		double result = 0.0;
+		for(int32 vert = 0; vert < slots.numVerts; vert++)
+			result += slots.weights[vert];
+		return result;
+	}, [&]() -> const char*{
+		for(int32 vert = 0; vert < slots.numVerts; vert++){
+			int32 total = 0;
+			for(int32 slot = 0; slot < slots.numSlots; slot++){
+				const int32 index = slot * slots.numVerts + vert;
+				//Sorted strongest first, rounding may make a weaker influence one unit larger
+				if ((slot > 0) && (slots.intWeights[index] > slots.intWeights[index - slots.numVerts] + 1))
+					return "influences are not sorted by weight";
+				total += slots.intWeights[index];
+			}
+			if (total != 255)
+				return "quantized weights do not sum to 255";
+		}
+		return nullptr;
+	});
+
+	TArray<float> gridPositions;
+	MeshSimplifier::IndexRangeArray gridRanges;
+	makeGridMesh(FMath::Max(size / 4, 8), gridPositions, gridRanges);
+	const int32 gridTriangles = countTriangles(gridRanges);
+	MeshSimplifier::IndexRangeArray lod;
+	runBenchmark(settings, "MeshSimplifier::simplify/25%", [&](){
+		MeshSimplifier::simplify(gridPositions, gridRanges, gridTriangles / 4, lod);
+		return (double)countTriangles(lod) / gridTriangles;
+	}, [&](){
+		return checkSimplified(lod, gridRanges, gridPositions.Num() / 3, gridTriangles / 4);
+	});
+
+	//Vertical stripes stand in for the dominant bones of a skinned mesh
+	TArray<int32> gridGroups;
+	gridGroups.SetNumUninitialized(gridPositions.Num() / 3);
+	for(int32 i = 0; i < gridGroups.Num(); i++)
+		gridGroups[i] = (int32)gridPositions[i * 3] / 16;
+	runBenchmark(settings, "MeshSimplifier::simplify/25%grouped", [&](){
+		MeshSimplifier::simplify(gridPositions, gridRanges, gridTriangles / 4, lod, &gridGroups);
+		return (double)countTriangles(lod) / gridTriangles;
+	}, [&]() -> const char*{
+		if (const char *error = checkSimplified(lod, gridRanges, gridPositions.Num() / 3, gridTriangles / 4))
+			return error;
+		for(const auto &range: lod){
+			for(int32 i = 0; i < range.Num(); i += 3){
+				//Every triangle keeps vertices of at most two neighbouring stripes
+				const int32 a = gridGroups[range[i]], b = gridGroups[range[i + 1]], c = gridGroups[range[i + 2]];
+				if ((FMath::Max3(a, b, c) - FMath::Min3(a, b, c)) > 1)
+					return "triangle spans more than two vertex groups";
+			}
+		}
+		return nullptr;
+	});
+
+	//Unwelded corners in shuffled triangle order, like a mesh with arbitrary exported index order
+	TArray<float> soupPositions;
+	TArray<int32> soupIndices;
+	{
+		TArray<int32> allIndices;
+		for(const auto &range: gridRanges){
+			for(auto index: range)
+				allIndices.Add(index);
+		}
+		std::vector<int32> tris(allIndices.Num() / 3);
+		for(int32 i = 0; i < (int32)tris.size(); i++)
+			tris[i] = i;
+		std::shuffle(tris.begin(), tris.end(), std::mt19937(9));
+		for(auto tri: tris){
+			for(int32 corner = 0; corner < 3; corner++){
+				const auto src = allIndices[tri * 3 + corner];
+				soupIndices.Add(soupPositions.Num() / 3);
+				soupPositions.Add(gridPositions[src * 3]);
+				soupPositions.Add(gridPositions[src * 3 + 1]);
+				soupPositions.Add(gridPositions[src * 3 + 2]);
+			}
+		}
+	}
+	const auto soupTriangles = getSortedTriangles(soupPositions, soupIndices);
+	TArray<float> optimizedPositions;
+	TArray<int32> optimizedIndices;
+	runBenchmark(settings, "MeshRenderOptimizer/full", [&](){
+		auto &positions = optimizedPositions;
+		auto &indices = optimizedIndices;
+		positions = soupPositions;
+		indices = soupIndices;
+		int32 numVerts = positions.Num() / 3;
+
+		TArray<MeshRenderOptimizer::VertexStream> streams;
+		streams.AddDefaulted();
+		streams[0].data = (const uint8*)positions.GetData();
+		streams[0].stride = sizeof(float) * 3;
+		TArray<int32> remap;
+		auto numUnique = MeshRenderOptimizer::buildWeldRemap(numVerts, streams, remap);
+		MeshRenderOptimizer::remapIndices(indices, remap);
+		MeshRenderOptimizer::remapVertexStream(positions, numVerts, remap, numUnique);
+		numVerts = numUnique;
+
+		const float before = MeshRenderOptimizer::computeACMR(indices, numVerts);
+		MeshRenderOptimizer::optimizeVertexCache(indices, numVerts);
+		const float afterCache = MeshRenderOptimizer::computeACMR(indices, numVerts);
+		MeshRenderOptimizer::optimizeOverdraw(indices, positions);
+		const float afterOverdraw = MeshRenderOptimizer::computeACMR(indices, numVerts);
+
+		numUnique = MeshRenderOptimizer::buildFetchRemap(indices, numVerts, remap);
+		MeshRenderOptimizer::remapIndices(indices, remap);
+		MeshRenderOptimizer::remapVertexStream(positions, numVerts, remap, numUnique);
+		static bool reported = false;
+		if (!reported){
+			printf("  welded %d -> %d verts, ACMR %.3f -> %.3f (cache) -> %.3f (overdraw)\n", 
+				soupPositions.Num() / 3, numVerts, before, afterCache, afterOverdraw);
+			reported = true;
+		}
+		return (double)afterOverdraw;
+	}, [&]() -> const char*{
+		if (optimizedPositions.Num() != gridPositions.Num())
+			return "welded vertex count does not match the source grid";
+		if (const char *error = checkTriangleList(optimizedIndices, optimizedPositions.Num() / 3))
+			return error;
+		if (getSortedTriangles(optimizedPositions, optimizedIndices) != soupTriangles)
+			return "reordered triangles differ from the source";
+		return nullptr;
+	});
+
+	TArray<int32> gridIndices;
+	for(const auto &range: gridRanges){
+		for(auto index: range)
+			gridIndices.Add(index);
+	}
+	MeshCollisionGenerator::HullArray hulls;
+	TArray<int32> triangleHulls;
+	runBenchmark(settings, "MeshCollisionGenerator::decomposeConvex/8", [&](){
+		MeshCollisionGenerator::decomposeConvex(gridPositions, gridIndices, 8, 4, 0.02f, hulls, &triangleHulls);
+		double result = 0.0;
+		for(const auto &hull: hulls){
+			for(auto value: hull)
+				result += value;
+		}
+		return result;
+	}, [&](){
+		return checkConvexHulls(hulls, triangleHulls, gridPositions, gridIndices);
+	});
+
+	TArray<float> uvs;
+	int32 numCharts = 0;
+	runBenchmark(settings, "LightmapUvGenerator::generate/256", [&](){
+		numCharts = LightmapUvGenerator::generate(soupPositions, soupIndices, 256, uvs);
+		double result = 0.0;
+		for(auto value: uvs)
+			result += value;
+		static bool reported = false;
+		if (!reported){
+			printf("  %d triangles, %d charts\n", soupIndices.Num() / 3, numCharts);
+			reported = true;
+		}
+		return result;
+	}, [&]() -> const char*{
+		if ((numCharts <= 0) || (uvs.Num() != soupIndices.Num() * 2))
+			return "no uv for every index";
+		return checkLightmapUvs(uvs);
+	});
+
+	const std::string terrainFile = "exodus_kernel_bench_terrain.bin";
+	const int32 alphaSize = size - 1;
+	if (!writeBinaryTerrain(terrainFile.c_str(), size, alphaSize, 4)){
+		fprintf(stderr, "Could not write %s\n", terrainFile.c_str());
+		return 3;
+	}
+	JsonBinaryTerrain binTerrain;
+	bool terrainLoaded = false;
+	runBenchmark(settings, "JsonBinaryTerrain::load", [&](){
+		terrainLoaded = binTerrain.load(terrainFile.c_str());
+		return checksum(binTerrain.heightMap);
+	}, [&](){
+		return terrainLoaded ? nullptr: "could not load the terrain file";
+	});
+	runBenchmark(settings, "JsonConvertedTerrain::assignFrom", [&](){
+		JsonConvertedTerrain converted;
+		converted.assignFrom(binTerrain);
+		double result = checksum(converted.heightMap);
+		for(const auto &cur: converted.alphaMaps)
+			result += checksum(cur);
+		return result;
+	});
+	remove(terrainFile.c_str());
+
+	if (settings.numFailed > 0){
+		fprintf(stderr, "%d benchmark(s) produced invalid output\n", settings.numFailed);
+		return 4;
+	}
+	return 0;
+}
@@ -0,0 +1,6 @@
+#pragma once
+#include "StandaloneShim.h"
+
+//Kernels are timed by the benchmark itself.
+#define IMPORT_PROFILE_SCOPE(stage)
+#define IMPORT_PROFILE_SCOPE_ASSET(stage, asset)
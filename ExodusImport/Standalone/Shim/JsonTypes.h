@@ -0,0 +1,7 @@
+#pragma once
+#include "StandaloneShim.h"
+
+using IntArray = TArray<int32>;
+using FloatArray = TArray<float>;
+using ByteArray = TArray<uint8>;
+using StringArray = TArray<FString>;
@@ -0,0 +1,11 @@
+#pragma once
+#include "StandaloneShim.h"
+
+//Progress reporting is editor UI only.
+class FScopedSlowTask{
+public:
+	void EnterProgressFrame(float = 1.0f){
+	}
+	FScopedSlowTask(float){
+	}
+};
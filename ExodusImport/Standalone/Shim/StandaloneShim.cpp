@@ -0,0 +1,48 @@
+#include "StandaloneShim.h"
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+
+void StandaloneShim::log(const char *verbosity, const char *format, ...){
+	//Log level messages are progress reports, only show them when asked to.
+	static const bool verbose = getenv("EXODUS_KERNELS_VERBOSE") != nullptr;
+	if (!verbose && ((strcmp(verbosity, "Log") == 0) || (strcmp(verbosity, "Verbose") == 0) || (strcmp(verbosity, "VeryVerbose") == 0)))
+		return;
+
+	fprintf(stderr, "%s: ", verbosity);
+	va_list args;
+	va_start(args, format);
+	vfprintf(stderr, format, args);
+	va_end(args);
+	fprintf(stderr, "\n");
+}
+
+bool FFileHelper::LoadFileToArray(TArray<uint8> &result, const TCHAR *filename){
+	result.Empty();
+	FILE *file = fopen(filename, "rb");
+	if (!file)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	if (size < 0){
+		fclose(file);
+		return false;
+	}
+
+	result.SetNumUninitialized((int32)size);
+	bool ok = (size == 0) || (fread(result.GetData(), 1, (size_t)size, file) == (size_t)size);
+	fclose(file);
+	return ok;
+}
+
+bool FFileHelper::SaveArrayToFile(TArrayView<const uint8> data, const TCHAR *filename){
+	FILE *file = fopen(filename, "wb");
+	if (!file)
+		return false;
+
+	bool ok = (data.Num() == 0) || (fwrite(data.GetData(), 1, (size_t)data.Num(), file) == (size_t)data.Num());
+	ok = (fclose(file) == 0) && ok;
+	return ok;
+}
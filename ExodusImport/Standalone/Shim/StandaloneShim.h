@@ -0,0 +1,211 @@
+#pragma once
+
+/*
+Minimal replacement for the parts of Core used by engine-independent kernels
+(DataPlane2D/3D, JsonTerrainTools, JsonBinaryTerrain, SkeletalMeshInfluence, MeshSimplifier, MeshRenderOptimizer,
+MeshCollisionGenerator, LightmapUvGenerator).
+
+Headers in this directory shadow engine and plugin headers of the same name, so the kernels
+compile unchanged outside of Unreal. Only what the kernels actually use is provided.
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define EXODUS_STANDALONE_KERNELS 1
+
+using int8 = int8_t;
+using uint8 = uint8_t;
+using int16 = int16_t;
+using uint16 = uint16_t;
+using int32 = int32_t;
+using uint32 = uint32_t;
+using int64 = int64_t;
+using uint64 = uint64_t;
+using TCHAR = char;
+
+#define TEXT(x) x
+#define check(expr) assert(expr)
+
+namespace StandaloneShim{
+	void log(const char *verbosity, const char *format, ...);
+}
+
+#define UE_LOG(category, verbosity, format, ...) StandaloneShim::log(#verbosity, format, ##__VA_ARGS__)
+
+template<typename T> typename std::remove_reference<T>::type&& MoveTemp(T &&obj){
+	return std::move(obj);
+}
+
+struct FMemory{
+	static int32 Memcmp(const void *a, const void *b, size_t size){
+		return memcmp(a, b, size);
+	}
+};
+
+template<typename T> using TUniquePtr = std::unique_ptr<T>;
+template<typename T, typename... Args> TUniquePtr<T> MakeUnique(Args&&... args){
+	return TUniquePtr<T>(new T(std::forward<Args>(args)...));
+}
+
+template<typename T> class TArray{
+protected:
+	std::vector<T> data;
+public:
+	using ElementType = T;
+
+	int32 Num() const{return (int32)data.size();}
+	T* GetData(){return data.data();}
+	const T* GetData() const{return data.data();}
+
+	T& operator[](int32 index){return data[index];}
+	const T& operator[](int32 index) const{return data[index];}
+	T& Last(){return data.back();}
+	const T& Last() const{return data.back();}
+
+	void SetNum(int32 num){data.resize(num);}
+	void SetNumUninitialized(int32 num){data.resize(num);}
+	void SetNumZeroed(int32 num){data.assign(num, T());}
+	void Init(const T &value, int32 num){data.assign(num, value);}
+	void Reserve(int32 num){data.reserve(num);}
+	void Empty(int32 slack = 0){
+		data.clear();
+		if (slack > 0)
+			data.reserve(slack);
+	}
+
+	int32 Add(const T &value){
+		data.push_back(value);
+		return Num() - 1;
+	}
+	int32 AddDefaulted(int32 count = 1){
+		auto result = Num();
+		data.resize(data.size() + count);
+		return result;
+	}
+	T& AddDefaulted_GetRef(){
+		data.emplace_back();
+		return data.back();
+	}
+
+	template<typename Predicate> void Sort(Predicate pred){
+		std::sort(data.begin(), data.end(), pred);
+	}
+
+	T* begin(){return data.data();}
+	T* end(){return data.data() + data.size();}
+	const T* begin() const{return data.data();}
+	const T* end() const{return data.data() + data.size();}
+
+	TArray() = default;
+	TArray(std::initializer_list<T> init)
+	:data(init){
+	}
+};
+
+template<typename T> class TArrayView{
+protected:
+	T *data = nullptr;
+	int64 num = 0;
+public:
+	T* GetData() const{return data;}
+	int64 Num() const{return num;}
+
+	TArrayView() = default;
+	TArrayView(T *data_, int64 num_)
+	:data(data_), num(num_){
+	}
+};
+
+class FString: public std::string{
+public:
+	const TCHAR* operator*() const{
+		return c_str();
+	}
+	FString() = default;
+	FString(const TCHAR *str)
+	:std::string(str){
+	}
+	FString(const std::string &str)
+	:std::string(str){
+	}
+};
+
+struct FVector2D{
+	float X = 0.0f;
+	float Y = 0.0f;
+
+	FVector2D operator/(const FVector2D &other) const{
+		return FVector2D(X / other.X, Y / other.Y);
+	}
+
+	FVector2D() = default;
+	FVector2D(float x, float y)
+	:X(x), Y(y){
+	}
+};
+
+struct FIntPoint{
+	int32 X = 0;
+	int32 Y = 0;
+
+	FIntPoint() = default;
+	FIntPoint(int32 x, int32 y)
+	:X(x), Y(y){
+	}
+};
+
+struct FMath{
+	template<typename T> static T Clamp(const T x, const T minVal, const T maxVal){
+		return (x < minVal) ? minVal: ((x < maxVal) ? x: maxVal);
+	}
+	template<typename T> static T Min(const T a, const T b){
+		return (a <= b) ? a: b;
+	}
+	template<typename T> static T Max(const T a, const T b){
+		return (a >= b) ? a: b;
+	}
+	template<typename T> static T Min3(const T a, const T b, const T c){
+		return Min(Min(a, b), c);
+	}
+	template<typename T> static T Max3(const T a, const T b, const T c){
+		return Max(Max(a, b), c);
+	}
+	template<typename T, typename U> static T Lerp(const T &a, const T &b, const U &alpha){
+		return (T)(a + alpha * (b - a));
+	}
+	static int32 FloorToInt(float f){
+		return (int32)std::floor(f);
+	}
+	static int32 RoundToInt(float f){
+		return FloorToInt(f + 0.5f);
+	}
+	template<typename T> static T Abs(const T a){
+		return (a >= (T)0) ? a: -a;
+	}
+	static float Sqrt(float f){
+		return std::sqrt(f);
+	}
+	static float Cos(float f){
+		return std::cos(f);
+	}
+	template<typename T> static T DegreesToRadians(const T deg){
+		return deg * (T)(3.14159265358979323846 / 180.0);
+	}
+	static float Frac(float f){
+		return f - std::floor(f);
+	}
+};
+
+struct FFileHelper{
+	static bool LoadFileToArray(TArray<uint8> &result, const TCHAR *filename);
+	static bool SaveArrayToFile(TArrayView<const uint8> data, const TCHAR *filename);
+};